@@ -2,4 +2,17 @@ function(prebuild_check TARGET)
     message("-- Running check.py on: ${CMAKE_CURRENT_SOURCE_DIR} with ${Python3_EXECUTABLE}")
     execute_process(COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/check.py ${CMAKE_CURRENT_SOURCE_DIR} WORKING_DIRECTORY ${CMAKE_SOURCE_DIR})
     add_custom_command(TARGET ${TARGET} COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/check.py ${CMAKE_CURRENT_SOURCE_DIR} WORKING_DIRECTORY ${CMAKE_SOURCE_DIR} DEPENDS ${TARGET})
-endfunction()
\ No newline at end of file
+endfunction()
+
+# Adds the ${TARGET}-pack target that packs the resources/ directory of the target into resources.pack,
+# which the app mounts if it's listed in the "resources.packs" of its config.json, see engine/resources/VirtualFileSystem.hpp.
+function(add_resource_pack TARGET)
+    if (NOT TARGET rg-pack)
+        return()
+    endif ()
+    add_custom_target(${TARGET}-pack
+            COMMAND rg-pack resources.pack resources
+            WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+            DEPENDS rg-pack
+            COMMENT "Packing ${CMAKE_CURRENT_SOURCE_DIR}/resources")
+endfunction()
@@ -0,0 +1,105 @@
+/**
+ * @file BenchApp.hpp
+ * @brief Defines the BenchApp that runs the engine microbenchmarks on a headless engine instance.
+*/
+
+#ifndef BENCH_BENCH_APP_HPP
+#define BENCH_BENCH_APP_HPP
+
+#include <bench/Benchmark.hpp>
+#include <engine/core/Engine.hpp>
+#include <engine/graphics/GraphicsController.hpp>
+#include <filesystem>
+#include <vector>
+
+namespace engine::bench {
+/**
+* @class BenchApp
+* @brief Initializes the engine with the `config.json` from the bench directory (headless by default), runs the
+* benchmarks, and exits.
+*
+* Command line arguments:
+* - `--filter name` runs only the benchmarks whose name contains `name`.
+* - `--samples n` sets the number of samples per benchmark.
+* - `--json path` writes the results to the `path`.
+*/
+class BenchApp final : public core::App {
+    void app_setup() override;
+};
+
+/**
+* @class BenchController
+* @brief Runs the registered benchmarks once the engine is initialized, then measures the main loop
+* phases over @ref BenchController::FRAME_SAMPLES frames, and reports the results on terminate.
+*/
+class BenchController final : public core::Controller {
+public:
+    std::string_view name() const override {
+        return "bench::BenchController";
+    }
+
+    /**
+    * @brief Records the duration of the @ref platform::PlatformController::poll_events in the current frame.
+    */
+    void add_poll_events_sample(double sample_ns);
+
+private:
+    /**
+    * @brief Number of frames for which the main loop phases are measured.
+    */
+    static constexpr uint32_t FRAME_SAMPLES = 500;
+
+    void initialize() override;
+
+    bool loop() override;
+
+    void terminate() override;
+
+    BenchmarkOptions m_options;
+    std::filesystem::path m_json_output;
+    std::vector<BenchmarkResult> m_results;
+    uint32_t m_frame{0};
+    std::vector<double> m_poll_events_samples;
+};
+
+/**
+* @class PollEventsProbeBegin
+* @brief Runs right before the @ref platform::PlatformController and marks the start of its @ref core::Controller::poll_events.
+*/
+class PollEventsProbeBegin final : public core::Controller {
+public:
+    std::string_view name() const override {
+        return "bench::PollEventsProbeBegin";
+    }
+
+    int64_t begin_ns() const {
+        return m_begin_ns;
+    }
+
+private:
+    void poll_events() override;
+
+    int64_t m_begin_ns{0};
+};
+
+/**
+* @class PollEventsProbeEnd
+* @brief Runs right after the @ref platform::PlatformController and records the duration of its @ref core::Controller::poll_events.
+*/
+class PollEventsProbeEnd final : public core::Controller {
+public:
+    std::string_view name() const override {
+        return "bench::PollEventsProbeEnd";
+    }
+
+private:
+    void poll_events() override;
+};
+
+/**
+* @brief Registers the benchmarks of the engine hot paths. Defined in the EngineBenchmarks.cpp.
+*/
+void register_engine_benchmarks();
+} // namespace engine::bench
+
+#endif //BENCH_BENCH_APP_HPP
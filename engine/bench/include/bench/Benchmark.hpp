@@ -0,0 +1,119 @@
+/**
+ * @file Benchmark.hpp
+ * @brief Defines the microbenchmark registry, runner, and statistics.
+*/
+
+#ifndef BENCH_BENCHMARK_HPP
+#define BENCH_BENCHMARK_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace engine::bench {
+/**
+* @brief Prevents the compiler from optimizing away the computation of the `value`.
+*/
+template<typename T>
+inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/**
+* @brief A single timed iteration of a benchmark.
+*/
+using BenchmarkBody = std::function<void()>;
+
+/**
+* @struct Benchmark
+* @brief A named benchmark. The `setup` runs once, outside the measurement, and returns the body to time.
+* State shared between the setup and the body is captured by the body, and released when the benchmark finishes.
+*/
+struct Benchmark {
+    std::string name;
+    std::function<BenchmarkBody()> setup;
+};
+
+/**
+* @struct BenchmarkResult
+* @brief Statistics of the time of a single iteration, in nanoseconds.
+*/
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations;
+    uint32_t samples;
+    double median_ns;
+    double p95_ns;
+    double mean_ns;
+    double stddev_ns;
+    double min_ns;
+};
+
+/**
+* @struct BenchmarkOptions
+* @brief Controls how long each benchmark runs. Set from the command line, see @ref BenchApp.
+*/
+struct BenchmarkOptions {
+    /**
+    * @brief Only the benchmarks whose name contains the filter run.
+    */
+    std::string filter;
+    /**
+    * @brief Number of timed samples per benchmark. Each sample runs the body in a batch of iterations.
+    */
+    uint32_t samples{50};
+    /**
+    * @brief Minimal duration of a single sample. Short bodies are batched until a sample takes this long,
+    * so that the clock resolution doesn't distort the result.
+    */
+    double min_sample_ns{200'000.0};
+};
+
+/**
+* @brief Returns the global list of benchmarks. Register benchmarks with @ref register_benchmark.
+*/
+std::vector<Benchmark> &benchmarks();
+
+/**
+* @brief Registers a benchmark. Call it from the @ref BenchController::initialize, after the engine is initialized.
+*/
+void register_benchmark(std::string name, std::function<BenchmarkBody()> setup);
+
+/**
+* @brief Returns true if the benchmark with the `name` should run with the `options`.
+*/
+bool is_selected(std::string_view name, const BenchmarkOptions &options);
+
+/**
+* @brief Runs the benchmark: calibrates the batch size, warms up, and collects the samples.
+*/
+BenchmarkResult run_benchmark(const Benchmark &benchmark, const BenchmarkOptions &options);
+
+/**
+* @brief Computes the statistics of the per-iteration times of the samples.
+* @param name Name of the benchmark.
+* @param sample_ns Per-iteration time of each sample. Reordered by the function.
+* @param iterations Total number of timed iterations.
+*/
+BenchmarkResult compute_statistics(std::string name, std::span<double> sample_ns, uint64_t iterations);
+
+/**
+* @brief Writes the results as JSON, so that the runs of different engine versions can be diffed.
+*/
+void write_json(const std::filesystem::path &path, std::span<const BenchmarkResult> results);
+
+/**
+* @brief Logs the results as a table.
+*/
+void print_results(std::span<const BenchmarkResult> results);
+} // namespace engine::bench
+
+#endif //BENCH_BENCHMARK_HPP
@@ -0,0 +1,76 @@
+#include <bench/BenchApp.hpp>
+#include <engine/util/Profiler.hpp>
+#include <spdlog/spdlog.h>
+
+namespace engine::bench {
+
+void BenchApp::app_setup() {
+    auto platform = core::Controller::get<platform::PlatformController>();
+    auto probe_begin = register_controller<PollEventsProbeBegin>();
+    auto probe_end = register_controller<PollEventsProbeEnd>();
+    probe_begin->after(core::Controller::get<core::EngineControllersBegin>());
+    probe_begin->before(platform);
+    probe_end->after(platform);
+    probe_end->before(core::Controller::get<graphics::GraphicsController>());
+
+    auto bench = register_controller<BenchController>();
+    bench->after(core::Controller::get<core::EngineControllersEnd>());
+}
+
+void BenchController::initialize() {
+    auto args = util::ArgParser::instance();
+    m_options.filter = args->arg<std::string>("--filter").value();
+    m_options.samples = static_cast<uint32_t>(args->arg<int>("--samples", static_cast<int>(m_options.samples)).value());
+    RG_GUARANTEE(m_options.samples > 0, "--samples must be positive.");
+    m_json_output = args->arg<std::string>("--json").value();
+
+    register_engine_benchmarks();
+    for (const auto &benchmark: benchmarks()) {
+        if (!is_selected(benchmark.name, m_options)) {
+            continue;
+        }
+        spdlog::info("Running {}", benchmark.name);
+        m_results.push_back(run_benchmark(benchmark, m_options));
+    }
+    if (!is_selected("PlatformController::poll_events", m_options)) {
+        m_frame = FRAME_SAMPLES;
+    }
+}
+
+bool BenchController::loop() {
+    return m_frame++ < FRAME_SAMPLES;
+}
+
+void BenchController::add_poll_events_sample(double sample_ns) {
+    // The first frames run while the lazily initialized parts of the engine warm up.
+    if (m_frame > FRAME_SAMPLES / 10) {
+        m_poll_events_samples.push_back(sample_ns);
+    }
+}
+
+void BenchController::terminate() {
+    if (!m_poll_events_samples.empty()) {
+        m_results.push_back(compute_statistics("PlatformController::poll_events", m_poll_events_samples,
+                                               m_poll_events_samples.size()));
+    }
+    print_results(m_results);
+    if (!m_json_output.empty()) {
+        write_json(m_json_output, m_results);
+    }
+}
+
+void PollEventsProbeBegin::poll_events() {
+    m_begin_ns = util::Profiler::now_ns();
+}
+
+void PollEventsProbeEnd::poll_events() {
+    int64_t end_ns = util::Profiler::now_ns();
+    int64_t begin_ns = core::Controller::get<PollEventsProbeBegin>()->begin_ns();
+    core::Controller::get<BenchController>()->add_poll_events_sample(static_cast<double>(end_ns - begin_ns));
+}
+
+} // namespace engine::bench
+
+int main(int argc, char **argv) {
+    return std::make_unique<engine::bench::BenchApp>()->run(argc, argv);
+}
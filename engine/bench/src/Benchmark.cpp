@@ -0,0 +1,141 @@
+#include <bench/Benchmark.hpp>
+#include <engine/util/Errors.hpp>
+#include <json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+namespace engine::bench {
+
+/**
+* @brief Samples run before the measurement to warm up the caches, the branch predictors, and the driver.
+*/
+static constexpr uint32_t WARMUP_SAMPLES = 3;
+
+/**
+* @brief Upper bound for the batch size, so that extremely cheap bodies don't run for too long.
+*/
+static constexpr uint64_t MAX_BATCH = 1'000'000;
+
+static double elapsed_ns(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+}
+
+std::vector<Benchmark> &benchmarks() {
+    static std::vector<Benchmark> registered;
+    return registered;
+}
+
+void register_benchmark(std::string name, std::function<BenchmarkBody()> setup) {
+    benchmarks().push_back(Benchmark{std::move(name), std::move(setup)});
+}
+
+bool is_selected(std::string_view name, const BenchmarkOptions &options) {
+    return options.filter.empty() || name.find(options.filter) != std::string_view::npos;
+}
+
+BenchmarkResult run_benchmark(const Benchmark &benchmark, const BenchmarkOptions &options) {
+    BenchmarkBody body = benchmark.setup();
+
+    // Calibrate the batch size, so that a sample takes at least min_sample_ns.
+    uint64_t batch = 1;
+    while (true) {
+        auto begin = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < batch; ++i) {
+            body();
+        }
+        double sample_ns = elapsed_ns(begin);
+        if (sample_ns >= options.min_sample_ns || batch >= MAX_BATCH) {
+            break;
+        }
+        double scale = sample_ns > 0.0 ? options.min_sample_ns / sample_ns : 10.0;
+        batch = std::min<uint64_t>(MAX_BATCH, std::max<uint64_t>(batch * 2, std::ceil(batch * scale)));
+    }
+
+    for (uint32_t sample = 0; sample < WARMUP_SAMPLES; ++sample) {
+        for (uint64_t i = 0; i < batch; ++i) {
+            body();
+        }
+    }
+
+    std::vector<double> sample_ns(options.samples);
+    for (auto &sample: sample_ns) {
+        auto begin = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < batch; ++i) {
+            body();
+        }
+        sample = elapsed_ns(begin) / static_cast<double>(batch);
+    }
+    return compute_statistics(benchmark.name, sample_ns, batch * options.samples);
+}
+
+BenchmarkResult compute_statistics(std::string name, std::span<double> sample_ns, uint64_t iterations) {
+    RG_GUARANTEE(!sample_ns.empty(), "Benchmark {} has no samples.", name);
+    std::ranges::sort(sample_ns);
+    auto percentile = [&](double p) {
+        // Nearest-rank percentile.
+        size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sample_ns.size())));
+        return sample_ns[std::clamp<size_t>(rank, 1, sample_ns.size()) - 1];
+    };
+    double size = static_cast<double>(sample_ns.size());
+    double mean = std::accumulate(sample_ns.begin(), sample_ns.end(), 0.0) / size;
+    double variance = 0.0;
+    for (double sample: sample_ns) {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance /= std::max(1.0, size - 1.0);
+
+    size_t middle = sample_ns.size() / 2;
+    double median = sample_ns.size() % 2 ? sample_ns[middle] : (sample_ns[middle - 1] + sample_ns[middle]) / 2.0;
+    return BenchmarkResult{
+            .name = std::move(name),
+            .iterations = iterations,
+            .samples = static_cast<uint32_t>(sample_ns.size()),
+            .median_ns = median,
+            .p95_ns = percentile(0.95),
+            .mean_ns = mean,
+            .stddev_ns = std::sqrt(variance),
+            .min_ns = sample_ns.front(),
+    };
+}
+
+void write_json(const std::filesystem::path &path, std::span<const BenchmarkResult> results) {
+    nlohmann::json output;
+    output["context"]["date"] = std::format("{:%FT%TZ}", std::chrono::floor<std::chrono::seconds>(
+            std::chrono::system_clock::now()));
+#ifdef NDEBUG
+    output["context"]["build_type"] = "release";
+#else
+    output["context"]["build_type"] = "debug";
+#endif
+    output["benchmarks"] = nlohmann::json::array();
+    for (const auto &result: results) {
+        output["benchmarks"].push_back({
+                {"name", result.name},
+                {"iterations", result.iterations},
+                {"samples", result.samples},
+                {"median_ns", result.median_ns},
+                {"p95_ns", result.p95_ns},
+                {"mean_ns", result.mean_ns},
+                {"stddev_ns", result.stddev_ns},
+                {"min_ns", result.min_ns},
+        });
+    }
+    std::ofstream file(path);
+    RG_GUARANTEE(file.is_open(), "Failed to open the benchmark output file {}.", path.string());
+    file << output.dump(2) << '\n';
+    spdlog::info("Benchmark results written to {}", path.string());
+}
+
+void print_results(std::span<const BenchmarkResult> results) {
+    spdlog::info("{:<56} {:>12} {:>12} {:>12} {:>12}", "benchmark", "median ns", "p95 ns", "stddev ns", "iterations");
+    for (const auto &result: results) {
+        spdlog::info("{:<56} {:>12.1f} {:>12.1f} {:>12.1f} {:>12}", result.name, result.median_ns, result.p95_ns,
+                     result.stddev_ns, result.iterations);
+    }
+}
+
+} // namespace engine::bench
@@ -0,0 +1,532 @@
+#include <assimp/scene.h>
+#include <bench/BenchApp.hpp>
+#include <engine/resources/AssimpSceneProcessor.hpp>
+#include <memory>
+#include <random>
+
+namespace engine::bench {
+
+/**
+* @brief Builds an Assimp scene with a single grid mesh of `(cells + 1)^2` vertices, with normals, texture coordinates,
+* and tangents, and a material without textures. The scene is generated in memory, so the benchmark doesn't read files.
+*/
+static std::unique_ptr<aiScene> make_grid_scene(uint32_t cells) {
+    auto scene = std::make_unique<aiScene>();
+    auto mesh = new aiMesh();
+    uint32_t side = cells + 1;
+    mesh->mNumVertices = side * side;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+    mesh->mTangents = new aiVector3D[mesh->mNumVertices];
+    mesh->mBitangents = new aiVector3D[mesh->mNumVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+    mesh->mNumUVComponents[0] = 2;
+    for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+            uint32_t i = y * side + x;
+            float u = static_cast<float>(x) / cells;
+            float v = static_cast<float>(y) / cells;
+            mesh->mVertices[i] = aiVector3D(u, 0.0f, v);
+            mesh->mNormals[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+            mesh->mTangents[i] = aiVector3D(1.0f, 0.0f, 0.0f);
+            mesh->mBitangents[i] = aiVector3D(0.0f, 0.0f, 1.0f);
+            mesh->mTextureCoords[0][i] = aiVector3D(u, v, 0.0f);
+        }
+    }
+    mesh->mNumFaces = cells * cells * 2;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    uint32_t face = 0;
+    for (uint32_t y = 0; y < cells; ++y) {
+        for (uint32_t x = 0; x < cells; ++x) {
+            uint32_t corner = y * side + x;
+            for (auto triangle: {std::array{corner, corner + side, corner + 1},
+                                 std::array{corner + 1, corner + side, corner + side + 1}}) {
+                mesh->mFaces[face].mNumIndices = 3;
+                mesh->mFaces[face].mIndices = new unsigned int[3]{triangle[0], triangle[1], triangle[2]};
+                ++face;
+            }
+        }
+    }
+
+    scene->mNumMeshes = 1;
+    scene->mMeshes = new aiMesh *[1]{mesh};
+    scene->mNumMaterials = 1;
+    scene->mMaterials = new aiMaterial *[1]{new aiMaterial()};
+    scene->mRootNode = new aiNode();
+    scene->mRootNode->mNumMeshes = 1;
+    scene->mRootNode->mMeshes = new unsigned int[1]{0};
+    return scene;
+}
+
+static constexpr std::string_view BENCH_SHADER_SOURCE = R"(
+//#shader vertex
+#version 330 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+void main() {
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
+
+//#shader fragment
+#version 330 core
+out vec4 FragColor;
+uniform vec3 color;
+uniform float intensity;
+void main() {
+    FragColor = vec4(color * intensity, 1.0);
+}
+)";
+
+/**
+* @brief A node of a random directed acyclic graph for the graph algorithm benchmarks.
+*/
+struct GraphNode {
+    std::vector<GraphNode *> next;
+};
+
+/**
+* @brief Builds a random DAG with `node_count` nodes, where each node has up to `max_edges` edges to the nodes after it.
+* The seed is fixed, so every run benchmarks the same graph.
+*/
+static std::vector<std::unique_ptr<GraphNode> > make_dag(uint32_t node_count, uint32_t max_edges) {
+    std::mt19937 random(42);
+    std::vector<std::unique_ptr<GraphNode> > nodes(node_count);
+    for (auto &node: nodes) {
+        node = std::make_unique<GraphNode>();
+    }
+    for (uint32_t i = 0; i + 1 < node_count; ++i) {
+        std::uniform_int_distribution<uint32_t> target(i + 1, node_count - 1);
+        for (uint32_t edge = 0; edge < max_edges; ++edge) {
+            nodes[i]->next.push_back(nodes[target(random)].get());
+        }
+    }
+    // Shuffle so that the sort has work to do.
+    std::shuffle(nodes.begin(), nodes.end(), random);
+    return nodes;
+}
+
+static void register_scene_benchmarks() {
+    register_benchmark("AssimpSceneProcessor::process_meshes/16k_vertices", [] {
+        auto scene = std::shared_ptr<aiScene>(make_grid_scene(128));
+        auto resources = core::Controller::get<resources::ResourcesController>();
+        return [scene, resources] {
+            resources::AssimpSceneProcessor processor(resources, scene.get(), "bench/grid.obj");
+            auto meshes = processor.process_meshes();
+            for (auto &mesh: meshes) {
+                mesh.destroy();
+            }
+        };
+    });
+
+    register_benchmark("Mesh::draw/2_triangles", [] {
+        auto scene = std::shared_ptr<aiScene>(make_grid_scene(1));
+        resources::AssimpSceneProcessor processor(core::Controller::get<resources::ResourcesController>(),
+                                                  scene.get(), "bench/quad.obj");
+        auto mesh = std::make_shared<resources::Mesh>(std::move(processor.process_meshes()
+                                                                          .front()));
+        auto shader = std::make_shared<resources::Shader>(
+                resources::ShaderCompiler::compile_from_source("bench", std::string(BENCH_SHADER_SOURCE)));
+        shader->use();
+        return [mesh, shader] {
+            mesh->draw(shader.get());
+        };
+    });
+}
+
+static void register_shader_benchmarks() {
+    register_benchmark("ShaderCompiler::parse_source", [] {
+        return [] {
+            resources::ShaderCompiler compiler("bench", std::string(BENCH_SHADER_SOURCE));
+            auto result = compiler.parse_source();
+            do_not_optimize(result);
+        };
+    });
+
+    auto uniform_benchmark = [](std::string name, auto set_uniform) {
+        register_benchmark(std::move(name), [set_uniform] {
+            auto shader = std::make_shared<resources::Shader>(
+                    resources::ShaderCompiler::compile_from_source("bench", std::string(BENCH_SHADER_SOURCE)));
+            shader->use();
+            return [shader, set_uniform] {
+                set_uniform(*shader);
+            };
+        });
+    };
+    uniform_benchmark("Shader::set_mat4", [](const resources::Shader &shader) {
+        shader.set_mat4("model", glm::mat4(1.0f));
+    });
+    uniform_benchmark("Shader::set_vec3", [](const resources::Shader &shader) {
+        shader.set_vec3("color", glm::vec3(1.0f, 0.5f, 0.25f));
+    });
+    uniform_benchmark("Shader::set_float", [](const resources::Shader &shader) {
+        shader.set_float("intensity", 0.5f);
+    });
+}
+
+static constexpr size_t DRAW_COUNT = 4096;
+static constexpr size_t CHUNK_COUNT = 16;
+
+static void register_command_list_benchmarks() {
+    auto make_quad = [] {
+        auto scene = std::shared_ptr<aiScene>(make_grid_scene(1));
+        resources::AssimpSceneProcessor processor(core::Controller::get<resources::ResourcesController>(),
+                                                  scene.get(), "bench/quad.obj");
+        return std::make_shared<resources::Mesh>(std::move(processor.process_meshes()
+                                                                    .front()));
+    };
+    auto make_shader = [] {
+        return std::make_shared<resources::Shader>(
+                resources::ShaderCompiler::compile_from_source("bench", std::string(BENCH_SHADER_SOURCE)));
+    };
+    // Every draw sets its own model matrix, like objects scattered around the scene.
+    auto record_draws = [](graphics::CommandList &list, const resources::Mesh &mesh, const resources::Shader *shader,
+                           size_t first, size_t count) {
+        list.bind_program(shader);
+        for (size_t i = first; i < first + count; ++i) {
+            list.set_uniform("model", glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i), 0.0f, 0.0f)));
+            mesh.record_draw(list);
+        }
+    };
+
+    register_benchmark("CommandList::record/4096_draws", [make_quad, make_shader, record_draws] {
+        auto mesh = make_quad();
+        auto shader = make_shader();
+        auto list = std::make_shared<graphics::CommandList>();
+        return [mesh, shader, list, record_draws] {
+            list->clear();
+            record_draws(*list, *mesh, shader.get(), 0, DRAW_COUNT);
+            do_not_optimize(list->size_bytes());
+        };
+    });
+
+    register_benchmark("CommandList::record_parallel/4096_draws", [make_quad, make_shader, record_draws] {
+        auto mesh = make_quad();
+        auto shader = make_shader();
+        auto lists = std::make_shared<std::vector<graphics::CommandList> >(CHUNK_COUNT);
+        auto jobs = core::Controller::get<core::JobSystem>();
+        return [mesh, shader, lists, jobs, record_draws] {
+            jobs->parallel_for(std::span(*lists), [&](graphics::CommandList &list) {
+                auto chunk = static_cast<size_t>(&list - lists->data());
+                list.clear();
+                record_draws(list, *mesh, shader.get(), chunk * (DRAW_COUNT / CHUNK_COUNT), DRAW_COUNT / CHUNK_COUNT);
+            }, 1);
+            do_not_optimize(lists->back()
+                                  .size_bytes());
+        };
+    });
+
+    register_benchmark("CommandList::replay/4096_draws", [make_quad, make_shader, record_draws] {
+        auto mesh = make_quad();
+        auto shader = make_shader();
+        auto list = std::make_shared<graphics::CommandList>();
+        record_draws(*list, *mesh, shader.get(), 0, DRAW_COUNT);
+        return [mesh, shader, list] {
+            list->replay();
+        };
+    });
+}
+
+static void register_algorithm_benchmarks() {
+    register_benchmark("util::alg::topological_sort/256_nodes", [] {
+        auto graph = std::make_shared<std::vector<std::unique_ptr<GraphNode> > >(make_dag(256, 4));
+        auto order = std::make_shared<std::vector<GraphNode *> >();
+        return [graph, order] {
+            order->clear();
+            for (auto &node: *graph) {
+                order->push_back(node.get());
+            }
+            util::alg::topological_sort(order->begin(), order->end(), [](GraphNode *node) {
+                return node->next;
+            });
+            do_not_optimize(order->front());
+        };
+    });
+
+    register_benchmark("util::alg::has_cycle/256_nodes", [] {
+        auto graph = std::make_shared<std::vector<std::unique_ptr<GraphNode> > >(make_dag(256, 4));
+        auto nodes = std::make_shared<std::vector<GraphNode *> >();
+        for (auto &node: *graph) {
+            nodes->push_back(node.get());
+        }
+        return [graph, nodes] {
+            bool cycle = util::alg::has_cycle(nodes->begin(), nodes->end(), [](GraphNode *node) {
+                return node->next;
+            });
+            do_not_optimize(cycle);
+        };
+    });
+}
+
+static void register_camera_benchmarks() {
+    register_benchmark("Camera::view_matrix", [] {
+        auto camera = std::make_shared<graphics::Camera>(glm::vec3(0.0f, 1.0f, 3.0f));
+        return [camera] {
+            camera->rotate_camera(0.1f, 0.05f);
+            do_not_optimize(camera->view_matrix());
+        };
+    });
+
+    register_benchmark("Camera::view_matrix/unchanged", [] {
+        auto camera = std::make_shared<graphics::Camera>(glm::vec3(0.0f, 1.0f, 3.0f));
+        return [camera] {
+            do_not_optimize(camera->view_matrix());
+        };
+    });
+
+    register_benchmark("GraphicsController::projection_matrix", [] {
+        auto graphics = core::Controller::get<graphics::GraphicsController>();
+        return [graphics] {
+            do_not_optimize(graphics->projection_matrix<graphics::ProjectionType::Perspective>());
+        };
+    });
+
+    register_benchmark("GraphicsController::camera_snapshot/moving", [] {
+        auto graphics = core::Controller::get<graphics::GraphicsController>();
+        return [graphics] {
+            graphics->camera()->rotate_camera(0.1f, 0.05f);
+            do_not_optimize(graphics->camera_snapshot());
+        };
+    });
+
+    register_benchmark("Frustum::intersects_sphere/1024", [] {
+        auto graphics = core::Controller::get<graphics::GraphicsController>();
+        return [graphics] {
+            const graphics::Frustum &frustum = graphics->camera_snapshot().frustum;
+            uint32_t visible = 0;
+            for (int i = 0; i < 1024; ++i) {
+                glm::vec3 center(static_cast<float>(i % 32) - 16.0f, 0.0f, -static_cast<float>(i / 32));
+                visible += frustum.intersects_sphere(center, 0.5f);
+            }
+            do_not_optimize(visible);
+        };
+    });
+}
+
+static constexpr size_t SIMD_OBJECT_COUNT = 100'000;
+
+/**
+* @brief Random transforms of the objects the SIMD benchmarks update, like a scene with many moving objects.
+*/
+struct SimdScene {
+    util::simd::TransformArrays transforms;
+    std::vector<glm::mat4> models;
+    std::vector<glm::mat4> results;
+    std::vector<util::simd::Aabb> boxes;
+    std::vector<util::simd::Aabb> world_boxes;
+    util::simd::PointArrays spheres;
+    util::simd::ClipArrays clip;
+    std::vector<uint8_t> visible;
+    glm::mat4 view_projection;
+
+    explicit SimdScene(size_t count) : models(count), results(count), boxes(count), world_boxes(count),
+                                       visible(count) {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        transforms.resize(count);
+        spheres.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 position(coordinate(random), coordinate(random), coordinate(random));
+            glm::quat rotation = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+            glm::vec3 scale(1.0f + unit(random) * 0.5f);
+            transforms.set(i, position, rotation, scale);
+            models[i] = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) *
+                        glm::scale(glm::mat4(1.0f), scale);
+            boxes[i] = util::simd::Aabb{glm::vec3(-0.5f), glm::vec3(0.5f)};
+            spheres.x[i] = position.x;
+            spheres.y[i] = position.y;
+            spheres.z[i] = position.z;
+            spheres.radius[i] = 0.87f * scale.x;
+        }
+        view_projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+                          glm::lookAt(glm::vec3(0.0f, 0.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+};
+
+/**
+* @brief Every kernel is measured against the per-object glm code it replaces.
+*/
+static void register_simd_benchmarks() {
+    spdlog::info("SIMD kernels use {}.", util::simd::instruction_set());
+    register_benchmark("glm::compose_trs/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            const auto &t = scene->transforms;
+            for (size_t i = 0; i < SIMD_OBJECT_COUNT; ++i) {
+                scene->results[i] = glm::translate(glm::mat4(1.0f), glm::vec3(t.position_x[i], t.position_y[i],
+                                                                              t.position_z[i])) *
+                                    glm::mat4_cast(glm::quat(t.rotation_w[i], t.rotation_x[i], t.rotation_y[i],
+                                                             t.rotation_z[i])) *
+                                    glm::scale(glm::mat4(1.0f), glm::vec3(t.scale_x[i], t.scale_y[i], t.scale_z[i]));
+            }
+            do_not_optimize(scene->results.back());
+        };
+    });
+
+    register_benchmark("simd::compose_trs/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            util::simd::compose_trs(scene->transforms, scene->results);
+            do_not_optimize(scene->results.back());
+        };
+    });
+
+    register_benchmark("glm::multiply/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            for (size_t i = 0; i < SIMD_OBJECT_COUNT; ++i) {
+                scene->results[i] = scene->view_projection * scene->models[i];
+            }
+            do_not_optimize(scene->results.back());
+        };
+    });
+
+    register_benchmark("simd::multiply/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            util::simd::multiply(scene->view_projection, scene->models, scene->results);
+            do_not_optimize(scene->results.back());
+        };
+    });
+
+    register_benchmark("glm::transform_aabbs/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            for (size_t i = 0; i < SIMD_OBJECT_COUNT; ++i) {
+                const glm::mat4 &m = scene->models[i];
+                const auto &box = scene->boxes[i];
+                glm::vec3 center = glm::vec3(m * glm::vec4((box.min + box.max) * 0.5f, 1.0f));
+                glm::vec3 extent = (box.max - box.min) * 0.5f;
+                glm::vec3 world_extent = glm::abs(glm::vec3(m[0])) * extent.x + glm::abs(glm::vec3(m[1])) * extent.y +
+                                         glm::abs(glm::vec3(m[2])) * extent.z;
+                scene->world_boxes[i] = util::simd::Aabb{center - world_extent, center + world_extent};
+            }
+            do_not_optimize(scene->world_boxes.back());
+        };
+    });
+
+    register_benchmark("simd::transform_aabbs/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            util::simd::transform_aabbs(scene->models, scene->boxes, scene->world_boxes);
+            do_not_optimize(scene->world_boxes.back());
+        };
+    });
+
+    register_benchmark("simd::to_clip_space/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        return [scene] {
+            util::simd::to_clip_space(scene->view_projection, scene->spheres, scene->clip);
+            do_not_optimize(scene->clip.w.back());
+        };
+    });
+
+    register_benchmark("glm::cull_spheres/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        auto frustum = graphics::Frustum::from_matrix(scene->view_projection);
+        return [scene, frustum] {
+            const auto &s = scene->spheres;
+            for (size_t i = 0; i < SIMD_OBJECT_COUNT; ++i) {
+                scene->visible[i] = frustum.intersects_sphere(glm::vec3(s.x[i], s.y[i], s.z[i]), s.radius[i]);
+            }
+            do_not_optimize(scene->visible.back());
+        };
+    });
+
+    register_benchmark("simd::cull_spheres/100k", [] {
+        auto scene = std::make_shared<SimdScene>(SIMD_OBJECT_COUNT);
+        auto frustum = graphics::Frustum::from_matrix(scene->view_projection);
+        return [scene, frustum] {
+            do_not_optimize(util::simd::cull_spheres(frustum.planes, scene->spheres, scene->visible));
+        };
+    });
+}
+
+static constexpr size_t LOOKUP_RESOURCE_COUNT = 1024;
+
+/**
+* @brief The per draw call resource lookups: by the name in a string map, like the resources were stored before,
+* by the @ref resources::ResourceId, and by the handle.
+*/
+static void register_resource_lookup_benchmarks() {
+    struct Resource {
+        uint32_t id;
+    };
+    struct Lookups {
+        std::unordered_map<std::string, std::unique_ptr<Resource> > by_name;
+        util::SlotMap<Resource> slots;
+        std::unordered_map<uint64_t, util::Handle<Resource>, resources::ResourceIdHash> by_id;
+        std::vector<std::string> names;
+        std::vector<resources::ResourceId> ids;
+        std::vector<util::Handle<Resource> > handles;
+    };
+    auto make_lookups = [] {
+        auto lookups = std::make_shared<Lookups>();
+        for (uint32_t i = 0; i < LOOKUP_RESOURCE_COUNT; ++i) {
+            std::string name = std::format("resource_{}", i);
+            auto handle = lookups->slots.emplace(Resource{i});
+            lookups->by_name[name] = std::make_unique<Resource>(Resource{i});
+            lookups->by_id[resources::ResourceId(name).hash] = handle;
+            lookups->ids.emplace_back(name);
+            lookups->handles.push_back(handle);
+            lookups->names.push_back(std::move(name));
+        }
+        return lookups;
+    };
+
+    register_benchmark("ResourceLookup::string_map/1024", [make_lookups] {
+        auto lookups = make_lookups();
+        return [lookups] {
+            uint32_t sum = 0;
+            for (const auto &name: lookups->names) {
+                sum += lookups->by_name
+                               .find(name)
+                               ->second
+                               ->id;
+            }
+            do_not_optimize(sum);
+        };
+    });
+
+    register_benchmark("ResourceLookup::resource_id/1024", [make_lookups] {
+        auto lookups = make_lookups();
+        return [lookups] {
+            uint32_t sum = 0;
+            for (auto id: lookups->ids) {
+                sum += lookups->slots
+                               .get(lookups->by_id
+                                           .find(id.hash)
+                                           ->second)
+                               ->id;
+            }
+            do_not_optimize(sum);
+        };
+    });
+
+    register_benchmark("ResourceLookup::handle/1024", [make_lookups] {
+        auto lookups = make_lookups();
+        return [lookups] {
+            uint32_t sum = 0;
+            for (auto handle: lookups->handles) {
+                sum += lookups->slots
+                               .get(handle)
+                               ->id;
+            }
+            do_not_optimize(sum);
+        };
+    });
+}
+
+void register_engine_benchmarks() {
+    register_scene_benchmarks();
+    register_shader_benchmarks();
+    register_command_list_benchmarks();
+    register_algorithm_benchmarks();
+    register_camera_benchmarks();
+    register_simd_benchmarks();
+    register_resource_lookup_benchmarks();
+}
+
+} // namespace engine::bench
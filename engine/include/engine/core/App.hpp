@@ -10,6 +10,9 @@ namespace engine::util {
 class Error;
 }
 
+#include <engine/core/ControllerScheduler.hpp>
+#include <filesystem>
+#include <memory>
 #include <vector>
 
 namespace engine::core {
@@ -31,6 +34,7 @@ class Controller;
 *        initialize();
 *        while (loop()) {
 *            poll_events();
+*            fixed_update();
 *            update();
 *            draw();
 *        }
@@ -55,6 +59,7 @@ public:
     *        initialize();
     *        while (loop()) {
     *            poll_events();
+    *            fixed_update();
     *            update();
     *            draw();
     *        }
@@ -75,6 +80,12 @@ private:
     */
     void engine_setup(int argc, char **argv);
 
+    /**
+    * @brief Mounts the resource packs listed in the config.json into the @ref engine::resources::VirtualFileSystem,
+    * before any of the controllers loads the resources.
+    */
+    void mount_resource_packs();
+
     /**
     * @brief Override to define your custom app setup that gets called after the `engine_setup`.
     */
@@ -106,11 +117,23 @@ private:
     */
     bool loop();
 
+    /**
+    * @brief Advances the simulation in fixed steps. Calls @ref engine::core::Controller::fixed_update for registered controllers
+    * once for every step in @ref platform::FrameTime::fixed_steps.
+    *
+    * The number of steps depends on how much time has passed, not on the frame rate, so the simulation
+    * runs at the same speed regardless of how fast the frames are drawn.
+    */
+    void fixed_update();
+
     /**
     * @brief Updates the app logic state. Calls @ref engine::core::Controller::update for registered controllers.
     *
     * This is where all the App state should be updated including handling events
     * registered in @ref App::poll_events, processing physics, world logic etc.
+    *
+    * If the `engine.parallel_update` is enabled in the config.json, independent controllers update
+    * concurrently on the @ref ControllerScheduler.
     */
     void update();
 
@@ -118,7 +141,8 @@ private:
     * @brief Draws the frame. Calls @ref engine::core::Controller::draw for registered controllers.
     *
     * This is where all the drawing should happen based on the state
-    * that the @ref App::update computed.
+    * that the @ref App::update computed. At the end, the frame is handed to the render thread,
+    * see @ref graphics::GraphicsController::submit_frame.
     */
     void draw();
 
@@ -168,6 +192,12 @@ public:
 
 private:
     std::vector<Controller *> m_controllers;
+    std::unique_ptr<ControllerScheduler> m_scheduler;
+
+    /**
+    * @brief Where the @ref util::Profiler writes the trace on exit. Set with `--profile out.json`, empty if profiling is off.
+    */
+    std::filesystem::path m_profile_output;
 };
 } // namespace engine
 
@@ -40,6 +40,7 @@ namespace engine::core {
 */
 class Controller {
     friend class App;
+    friend class ControllerScheduler;
 
 public:
     /**
@@ -114,6 +115,18 @@ public:
         m_enabled = value;
     }
 
+    /**
+    * @brief Override to return true if the @ref Controller::update of this controller can run on a worker thread,
+    * concurrently with the controllers it doesn't depend on. Used only when the @ref ControllerScheduler is enabled.
+    *
+    * A thread-safe controller must not call OpenGL or GLFW in the @ref Controller::update, and must not touch state
+    * that other controllers access in their update, unless they are ordered with @ref Controller::before or @ref Controller::after.
+    * By default, controllers update on the main thread.
+    */
+    virtual bool is_thread_safe() const {
+        return false;
+    }
+
 private:
     void mark_as_registered() {
         m_registered = true;
@@ -143,6 +156,13 @@ private:
     virtual void poll_events() {
     }
 
+    /**
+    * @brief Advance the simulation by one fixed step of @ref platform::PlatformController::fixed_dt seconds.
+    * Executes in the @ref core::App::fixed_update, zero or more times per frame.
+    */
+    virtual void fixed_update() {
+    }
+
     /**
     * @brief Update the controller state and prepare for drawing. Executes in the @ref core::App::update.
     */
@@ -0,0 +1,81 @@
+/**
+ * @file ControllerScheduler.hpp
+ * @brief Defines the ControllerScheduler class that runs independent controllers' update concurrently.
+*/
+
+#ifndef CONTROLLER_SCHEDULER_HPP
+#define CONTROLLER_SCHEDULER_HPP
+
+#include <engine/core/JobSystem.hpp>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace engine::core {
+class Controller;
+
+/**
+* @class ControllerScheduler
+* @brief Runs the @ref Controller::update of the registered controllers as a task graph built from the
+* @ref Controller::before and @ref Controller::after edges.
+*
+* A controller starts updating as soon as all the controllers ordered before it have finished.
+* Controllers that return true from @ref Controller::is_thread_safe run on the @ref JobSystem worker threads,
+* all the other controllers run as main-thread jobs, so code that touches OpenGL or GLFW stays on the main thread.
+* The main thread also picks up thread-safe controllers while it waits.
+*
+* The scheduler is opt-in. Enable it in the config.json:
+* @code
+* "engine": {
+*   "parallel_update": true
+* }
+* @endcode
+*/
+class ControllerScheduler {
+public:
+    /**
+    * @brief Builds the task graph.
+    * @param controllers Registered controllers in topological order.
+    */
+    void initialize(std::span<Controller *const> controllers);
+
+    /**
+    * @brief Calls @ref Controller::update for all the enabled controllers and waits for them to finish.
+    * If a controller throws, the controllers ordered after it don't update, and the first error is rethrown
+    * on the main thread once the running controllers finish.
+    */
+    void update();
+
+private:
+    struct Task {
+        Controller *controller;
+        std::vector<uint32_t> next;
+        uint32_t predecessor_count{0};
+        std::unique_ptr<std::atomic<uint32_t> > remaining_predecessors;
+        bool main_thread;
+    };
+
+    /**
+    * @brief Updates the controller of the `task` and schedules the tasks that became ready.
+    */
+    void run(uint32_t task);
+
+    void schedule(uint32_t task);
+
+    JobSystem *m_jobs{nullptr};
+    std::vector<Task> m_tasks;
+    JobCounter m_counter;
+
+    /**
+    * @brief Guards the `m_error`.
+    */
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+};
+} // namespace engine::core
+
+#endif //CONTROLLER_SCHEDULER_HPP
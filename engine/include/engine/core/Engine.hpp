@@ -9,25 +9,48 @@
 #include <engine/core/App.hpp>
 
 #include <engine/core/Controller.hpp>
+#include <engine/core/ControllerScheduler.hpp>
+#include <engine/core/JobSystem.hpp>
 
 
 #include <engine/platform/Window.hpp>
 #include <engine/platform/Input.hpp>
+#include <engine/platform/InputRecording.hpp>
+#include <engine/platform/FrameLimiter.hpp>
+#include <engine/platform/FrameStats.hpp>
 #include <engine/platform/PlatformController.hpp>
 
 #include <engine/graphics/OpenGL.hpp>
 #include <engine/graphics/Camera.hpp>
+#include <engine/graphics/Frustum.hpp>
+#include <engine/graphics/CommandList.hpp>
+#include <engine/graphics/FrameQueue.hpp>
+#include <engine/graphics/RenderThread.hpp>
 
 #include <engine/util/Utils.hpp>
 #include <engine/util/Configuration.hpp>
 #include <engine/util/ArgParser.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/util/Log.hpp>
+#include <engine/util/Profiler.hpp>
+#include <engine/util/FrameArena.hpp>
+#include <engine/util/AllocationTracker.hpp>
+#include <engine/util/SimdMath.hpp>
+#include <engine/util/MappedFile.hpp>
+#include <engine/util/SlotMap.hpp>
 
 #include <engine/resources/ShaderCompiler.hpp>
+#include <engine/resources/ShaderPreprocessor.hpp>
 #include <engine/resources/ResourcesController.hpp>
+#include <engine/resources/AssimpSceneProcessor.hpp>
+#include <engine/resources/HotReloadController.hpp>
 #include <engine/resources/Model.hpp>
 #include <engine/resources/Shader.hpp>
 #include <engine/resources/Texture.hpp>
 #include <engine/resources/Skybox.hpp>
+#include <engine/resources/PackArchive.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
+#include <engine/resources/ResourceId.hpp>
+#include <engine/resources/GpuResource.hpp>
 
 #endif//MATF_RG_PROJECT_ENGINE_HPP
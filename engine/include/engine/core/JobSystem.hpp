@@ -0,0 +1,259 @@
+/**
+ * @file JobSystem.hpp
+ * @brief Defines the JobSystem controller that runs jobs on a pool of work-stealing worker threads.
+*/
+
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <engine/core/Controller.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace engine::core {
+/**
+* @brief A unit of work executed by the @ref JobSystem.
+*/
+using Job = std::function<void()>;
+
+/**
+* @class JobCounter
+* @brief Counts the unfinished jobs it was passed to. Use it to wait for a group of jobs with @ref JobSystem::wait,
+* or to start jobs after a group of jobs finishes with @ref JobSystem::run_after.
+*
+* A counter can be reused once it reaches zero. It must outlive all the jobs it counts.
+*/
+class JobCounter {
+    friend class JobSystem;
+
+public:
+    /**
+    * @brief Returns true if all the counted jobs have finished.
+    */
+    bool is_done() const {
+        // Taking the lock makes sure the job that finished last no longer touches the counter,
+        // so the counter can be destroyed once this returns true.
+        std::lock_guard lock(m_mutex);
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    std::atomic<uint32_t> m_pending{0};
+
+    /**
+    * @brief Guards the `m_continuations` and the decrements of the `m_pending`.
+    */
+    mutable std::mutex m_mutex;
+
+    /**
+    * @brief Jobs scheduled when the counter reaches zero.
+    */
+    std::vector<std::pair<Job, JobCounter *> > m_continuations;
+};
+
+/**
+* @class JobSystem
+* @brief Shared scheduler for the CPU work of the engine and the app.
+*
+* Every worker thread owns a deque of jobs. A worker pushes and pops jobs at the back of its own deque,
+* and when the deque is empty it steals jobs from the front of the other workers' deques.
+* Threads that wait with @ref JobSystem::wait execute jobs while waiting, instead of blocking.
+*
+* Jobs must not call OpenGL or GLFW. Such work goes to @ref JobSystem::run_on_main_thread,
+* which executes at the beginning of the next frame, or while the main thread waits for a counter.
+*
+* Jobs must not throw. Use @ref JobSystem::async to get the result or the error of a job through a `std::future`.
+*
+* The number of worker threads is set in the config.json, 0 uses one less than the number of hardware threads:
+* @code
+* "engine": {
+*   "worker_threads": 0
+* }
+* @endcode
+*
+* @code
+* auto jobs = engine::core::Controller::get<engine::core::JobSystem>();
+* jobs->parallel_for(std::span(particles), [](Particle &particle) {
+*     particle.position += particle.velocity * dt;
+* });
+* @endcode
+*/
+class JobSystem final : public Controller {
+public:
+    std::string_view name() const override {
+        return "JobSystem";
+    }
+
+    /**
+    * @brief Schedules the `job` on a worker thread.
+    * @param job The job to run.
+    * @param counter If not null, it's incremented now and decremented when the job finishes.
+    */
+    void run(Job job, JobCounter *counter = nullptr);
+
+    /**
+    * @brief Schedules the `job` once all the jobs counted by the `dependency` finish.
+    * @param dependency The counter to wait for.
+    * @param job The job to run.
+    * @param counter If not null, it's incremented now and decremented when the job finishes.
+    */
+    void run_after(JobCounter &dependency, Job job, JobCounter *counter = nullptr);
+
+    /**
+    * @brief Schedules the `job` on the main thread. Use it for the work that touches OpenGL or GLFW.
+    * @param job The job to run.
+    * @param counter If not null, it's incremented now and decremented when the job finishes.
+    */
+    void run_on_main_thread(Job job, JobCounter *counter = nullptr);
+
+    /**
+    * @brief Waits until all the jobs counted by the `counter` finish. Executes other jobs while waiting.
+    * On the main thread it also executes the main-thread jobs.
+    */
+    void wait(JobCounter &counter);
+
+    /**
+    * @brief Runs the `function` on a worker thread.
+    * @returns The future holding the result or the exception thrown by the `function`.
+    */
+    template<typename Function>
+    auto async(Function function) -> std::future<std::invoke_result_t<Function> > {
+        using Result = std::invoke_result_t<Function>;
+        // std::function requires copyable callables, so the task is shared.
+        auto task = std::make_shared<std::packaged_task<Result()> >(std::move(function));
+        auto result = task->get_future();
+        run([task] {
+            (*task)();
+        });
+        return result;
+    }
+
+    /**
+    * @brief Calls the `function` for every element of the `items` on the worker threads, and waits for all the calls to finish.
+    * @param items The elements to process.
+    * @param function Called with a reference to each of the elements.
+    * @param grain The number of elements processed by a single job. If 0, the elements are split into
+    * a few jobs per worker thread.
+    */
+    template<typename T, typename Function>
+    void parallel_for(std::span<T> items, Function function, size_t grain = 0) {
+        if (items.empty()) {
+            return;
+        }
+        if (grain == 0) {
+            grain = std::max<size_t>(1, items.size() / (JOBS_PER_THREAD * (worker_count() + 1)));
+        }
+        if (grain >= items.size()) {
+            for (auto &item: items) {
+                function(item);
+            }
+            return;
+        }
+        JobCounter counter;
+        for (size_t first = 0; first < items.size(); first += grain) {
+            run([chunk = items.subspan(first, std::min(grain, items.size() - first)), &function] {
+                for (auto &item: chunk) {
+                    function(item);
+                }
+            }, &counter);
+        }
+        wait(counter);
+    }
+
+    /**
+    * @brief Returns the number of worker threads.
+    */
+    uint32_t worker_count() const {
+        return static_cast<uint32_t>(m_workers.size());
+    }
+
+    /**
+    * @brief Returns true if called from the thread that runs the @ref App main loop.
+    */
+    bool is_main_thread() const {
+        return std::this_thread::get_id() == m_main_thread;
+    }
+
+private:
+    /**
+    * @brief The automatic grain in @ref JobSystem::parallel_for creates this many jobs per thread,
+    * so that the threads that finish early can steal the remaining work.
+    */
+    static constexpr size_t JOBS_PER_THREAD = 4;
+
+    struct Task {
+        Job job;
+        JobCounter *counter{nullptr};
+    };
+
+    /**
+    * @brief The job deque of a single worker thread.
+    */
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::jthread thread;
+    };
+
+    /**
+    * @brief Starts the worker threads.
+    */
+    void initialize() override;
+
+    /**
+    * @brief Executes the main-thread jobs scheduled since the last frame.
+    */
+    void poll_events() override;
+
+    /**
+    * @brief Stops the worker threads. Jobs that haven't started are discarded.
+    */
+    void terminate() override;
+
+    void push(Task task);
+
+    void worker_loop(uint32_t index, std::stop_token stop_token);
+
+    /**
+    * @brief Pops a job from the deque of the calling worker, or steals one from the other workers.
+    * @returns true if a job was found.
+    */
+    bool try_pop(Task &task);
+
+    bool try_pop_main_thread(Task &task);
+
+    void execute(Task &task);
+
+    /**
+    * @brief Decrements the `counter` and schedules its continuations when it reaches zero.
+    */
+    void finish(JobCounter *counter);
+
+    std::vector<std::unique_ptr<Worker> > m_workers;
+    std::atomic<uint32_t> m_next_worker{0};
+    std::thread::id m_main_thread;
+
+    /**
+    * @brief Number of jobs in the worker deques. Idle workers sleep while it's zero.
+    */
+    std::atomic<uint32_t> m_queued{0};
+    std::mutex m_sleep_mutex;
+    std::condition_variable_any m_wake;
+
+    std::mutex m_main_thread_mutex;
+    std::deque<Task> m_main_thread_tasks;
+};
+} // namespace engine::core
+
+#endif //JOB_SYSTEM_HPP
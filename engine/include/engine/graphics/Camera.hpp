@@ -8,8 +8,29 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <engine/graphics/Frustum.hpp>
+#include <cstdint>
 
 namespace engine::graphics {
+/**
+* @struct CameraSnapshot
+* @brief The matrices and the frustum of the camera for the current frame.
+*
+* A plain copy, so it can be captured by value into the render thread commands and the worker jobs,
+* which must not call the @ref Camera methods that update its caches. See @ref GraphicsController::camera_snapshot.
+*/
+struct CameraSnapshot {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::mat4 view_projection{1.0f};
+    glm::mat4 inverse_view{1.0f};
+    glm::mat4 inverse_projection{1.0f};
+    glm::mat4 inverse_view_projection{1.0f};
+    glm::vec3 position{};
+    glm::vec3 front{};
+    Frustum frustum{};
+};
+
 /**
  *  @class Camera
  *  @brief Camera processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL.
@@ -89,9 +110,24 @@ public:
                     float yaw = YAW, float pitch = PITCH);
 
     /**
+     * @brief The view matrix is cached, and recomputed only when the @ref Camera::Position or the camera vectors changed
+     * since the last call. The cache makes it unsafe to call from several threads, copy a @ref CameraSnapshot instead.
      * @returns  returns the view matrix calculated using Euler Angles and the LookAt Matrix.
      */
-    glm::mat4 view_matrix() const;
+    const glm::mat4 &view_matrix() const;
+
+    /**
+     * @brief The inverse of the @ref Camera::view_matrix, the camera to world transform. Cached together with the view matrix.
+     */
+    const glm::mat4 &inverse_view_matrix() const;
+
+    /**
+     * @brief Incremented every time the view matrix is recomputed, so that the values derived from it can be cached too.
+     */
+    uint64_t view_version() const {
+        update_view();
+        return m_view_version;
+    }
 
     /**
      * @brief Processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems).
@@ -113,6 +149,26 @@ private:
      * @brief Calculates the front vector from the Camera's (updated) Euler Angles
      */
     void update_camera_vectors();
+
+    /**
+     * @brief Recomputes the view matrix if the inputs of the glm::lookAt changed.
+     */
+    void update_view() const;
+
+    mutable glm::mat4 m_view{1.0f};
+    mutable glm::mat4 m_inverse_view{1.0f};
+
+    /**
+    * @brief The @ref Camera::Position, @ref Camera::Front, and @ref Camera::Up the cached view matrix was computed from.
+    */
+    mutable glm::vec3 m_view_position{};
+    mutable glm::vec3 m_view_front{};
+    mutable glm::vec3 m_view_up{};
+
+    /**
+    * @brief 0 until the view matrix is computed for the first time.
+    */
+    mutable uint64_t m_view_version{0};
 };
 }
 #endif
@@ -0,0 +1,242 @@
+/**
+ * @file CommandList.hpp
+ * @brief Defines the CommandList class that records draw commands on any thread and replays them on the OpenGL thread.
+*/
+
+#ifndef COMMAND_LIST_HPP
+#define COMMAND_LIST_HPP
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace engine::resources {
+class Shader;
+}
+
+namespace engine::graphics {
+/**
+* @brief The commands a @ref CommandList records.
+*/
+enum class CommandType : uint8_t {
+    BindProgram,
+    BindMesh,
+    BindTexture,
+    SetUniform,
+    BindUniformBufferRange,
+    Draw,
+    DrawInstanced
+};
+
+/**
+* @brief The value types of the @ref CommandType::SetUniform.
+*/
+enum class UniformType : uint8_t {
+    Int,
+    Float,
+    Vec2,
+    Vec3,
+    Vec4,
+    Mat3,
+    Mat4
+};
+
+/**
+* @class CommandList
+* @brief A compact binary list of draw commands. Recording doesn't touch OpenGL, so it can run on the worker threads;
+* @ref CommandList::replay issues the commands through the @ref OpenGL wrapper on the thread that owns the context.
+*
+* Each command is a small header followed by its parameters, packed into one growing byte buffer,
+* so recording a command is a few stores and replaying the list walks memory linearly.
+* The list records the OpenGL ids of the meshes and the textures, and the pointers to the shaders, so that the replay
+* finishes a pending shader compilation, see @ref resources::Shader::use. The resources have to outlive the replay.
+*
+* Record one list per job and replay the lists in a fixed order, so that the frame is the same regardless
+* of which worker recorded which list:
+* @code
+* std::vector<CommandList> lists(chunks.size());
+* jobs->parallel_for(std::span(chunks), [&](Chunk &chunk) {
+*     CommandList &list = lists[chunk.index];
+*     list.bind_program(shader);
+*     for (const Object &object: chunk.objects) {
+*         list.set_uniform("model", object.transform);
+*         object.model->record_draw(list, shader);
+*     }
+* });
+* graphics->submit([lists = std::move(lists)] {
+*     CommandList::replay(lists);
+* });
+* @endcode
+*
+* A list created in the @ref util::FrameArena records into the arena, so recording a frame doesn't allocate from the
+* heap, and the list stays valid until the render thread has drawn the frame:
+* @code
+* auto *list = util::FrameArena::instance()->create<CommandList>();
+* model->record_draw(*list, shader);
+* graphics->submit(std::span<const CommandList>(list, 1));
+* @endcode
+*/
+class CommandList {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    CommandList() = default;
+
+    /**
+    * @brief Creates a list that allocates its commands with the `allocator`.
+    */
+    explicit CommandList(const allocator_type &allocator) : m_data(allocator) {
+    }
+
+    /**
+    * @brief Uses the shader program for the following commands. Records nothing if the shader is already bound.
+    * The replay binds it with @ref resources::Shader::use, which checks the compilation of a batch-compiled shader.
+    */
+    void bind_program(const resources::Shader *shader);
+
+    /**
+    * @brief Binds the vertex array of a mesh for the following draws.
+    * @param index_count Number of indices drawn by @ref CommandList::draw without arguments.
+    */
+    void bind_mesh(uint32_t vertex_array, uint32_t index_count);
+
+    /**
+    * @brief Binds the texture to the texture unit.
+    * @param target The OpenGL texture target, for example GL_TEXTURE_2D.
+    */
+    void bind_texture(uint32_t unit, uint32_t target, uint32_t texture);
+
+    /**
+    * @brief Sets the uniform of the program bound earlier in the list. The value is copied into the list.
+    * @param name At most 255 characters.
+    */
+    void set_uniform(std::string_view name, int value);
+
+    void set_uniform(std::string_view name, float value);
+
+    void set_uniform(std::string_view name, const glm::vec2 &value);
+
+    void set_uniform(std::string_view name, const glm::vec3 &value);
+
+    void set_uniform(std::string_view name, const glm::vec4 &value);
+
+    void set_uniform(std::string_view name, const glm::mat3 &value);
+
+    void set_uniform(std::string_view name, const glm::mat4 &value);
+
+    /**
+    * @brief Binds the range of a uniform buffer to the uniform block binding point.
+    */
+    void bind_uniform_buffer_range(uint32_t binding, uint32_t buffer, int64_t offset, int64_t size);
+
+    /**
+    * @brief Draws the indexed triangles of the bound mesh.
+    * @param index_count Number of indices to draw, 0 draws all the indices of the bound mesh.
+    * @param first_index The first index to draw.
+    */
+    void draw(uint32_t index_count = 0, uint32_t first_index = 0);
+
+    /**
+    * @brief Draws the indexed triangles of the bound mesh `instance_count` times.
+    */
+    void draw_instanced(uint32_t instance_count, uint32_t index_count = 0, uint32_t first_index = 0);
+
+    /**
+    * @brief Appends the commands of the other list.
+    */
+    void append(const CommandList &other);
+
+    /**
+    * @brief Removes the commands and keeps the memory, so that recording the next frame doesn't allocate.
+    */
+    void clear() {
+        m_data.clear();
+        m_command_count = 0;
+        m_shader = nullptr;
+    }
+
+    bool empty() const {
+        return m_data.empty();
+    }
+
+    uint32_t command_count() const {
+        return m_command_count;
+    }
+
+    size_t size_bytes() const {
+        return m_data.size();
+    }
+
+    /**
+    * @brief Issues the commands. Must be called on the thread that owns the OpenGL context.
+    */
+    void replay() const;
+
+    /**
+    * @brief Issues the commands of the lists in order. Must be called on the thread that owns the OpenGL context.
+    * The bound program and mesh carry over from one list to the next.
+    */
+    static void replay(std::span<const CommandList> lists);
+
+private:
+    /**
+    * @brief Precedes the parameters of every command. The `size` includes the header.
+    */
+    struct CommandHeader {
+        CommandType type;
+        uint8_t reserved;
+        uint16_t size;
+    };
+
+    /**
+    * @brief OpenGL state the replay tracks to skip redundant binds.
+    */
+    struct ReplayState {
+        const resources::Shader *shader{nullptr};
+        uint32_t program{0};
+        uint32_t vertex_array{0};
+        uint32_t index_count{0};
+    };
+
+    /**
+    * @brief Appends a command. The parameters are copied, and followed by the `extra` bytes.
+    */
+    template<typename Parameters>
+    void push(CommandType type, const Parameters &parameters, std::span<const char> extra = {}) {
+        static_assert(std::is_trivially_copyable_v<Parameters>);
+        // Commands start at multiples of 4 bytes, so the parameters are always read from aligned offsets.
+        size_t size = (sizeof(CommandHeader) + sizeof(Parameters) + extra.size() + 3) & ~size_t{3};
+        size_t offset = m_data.size();
+        m_data.resize(offset + size);
+        CommandHeader header{type, 0, static_cast<uint16_t>(size)};
+        std::memcpy(m_data.data() + offset, &header, sizeof(header));
+        std::memcpy(m_data.data() + offset + sizeof(header), &parameters, sizeof(Parameters));
+        if (!extra.empty()) {
+            std::memcpy(m_data.data() + offset + sizeof(header) + sizeof(Parameters), extra.data(), extra.size());
+        }
+        ++m_command_count;
+    }
+
+    void push_uniform(std::string_view name, UniformType type, const void *value, size_t value_size);
+
+    static void replay(const CommandList &list, ReplayState &state);
+
+    static void finish_replay(ReplayState &state);
+
+    std::pmr::vector<std::byte> m_data;
+    uint32_t m_command_count{0};
+
+    /**
+    * @brief The shader bound by the last @ref CommandList::bind_program, to skip binding it again.
+    */
+    const resources::Shader *m_shader{nullptr};
+};
+} // namespace engine::graphics
+
+#endif //COMMAND_LIST_HPP
@@ -0,0 +1,124 @@
+/**
+ * @file FrameQueue.hpp
+ * @brief Defines the FrameQueue class that limits the frames in flight on the GPU and measures the input latency.
+*/
+
+#ifndef FRAME_QUEUE_HPP
+#define FRAME_QUEUE_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace engine::graphics {
+/**
+* @struct LatencyStats
+* @brief Time from sampling the input of a frame until the GPU finished drawing the frame, in milliseconds.
+*/
+struct LatencyStats {
+    /**
+    * @brief Latency of the most recent measured frame.
+    */
+    double last_ms;
+
+    /**
+    * @brief Average latency over the last @ref FrameQueue::LATENCY_WINDOW measured frames.
+    */
+    double average_ms;
+
+    /**
+    * @brief The highest latency over the last @ref FrameQueue::LATENCY_WINDOW measured frames.
+    */
+    double max_ms;
+
+    /**
+    * @brief How long the CPU waited for the GPU at the beginning of the last frame.
+    */
+    double wait_ms;
+
+    /**
+    * @brief Number of frames submitted to the GPU that haven't finished yet.
+    */
+    uint32_t frames_in_flight;
+};
+
+/**
+* @class FrameQueue
+* @brief Keeps the CPU at most N frames ahead of the GPU, and measures the input latency with GPU timestamps.
+*
+* Drivers queue several frames when the CPU is faster than the GPU, and each queued frame adds a frame of latency.
+* The FrameQueue puts a fence into the command stream at the beginning of every frame, and before the CPU starts
+* a frame, it waits until the GPU has finished the frame N frames back.
+* A timestamp query next to each fence records when the GPU finished the previous frame,
+* which is compared with the time the frame's input was sampled.
+*/
+class FrameQueue {
+public:
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 8;
+    static constexpr uint32_t LATENCY_WINDOW = 64;
+
+    /**
+    * @brief Creates the timestamp queries.
+    * @param max_frames_in_flight 0 disables the limit, the latency is still measured.
+    */
+    void initialize(uint32_t max_frames_in_flight);
+
+    void terminate();
+
+    /**
+    * @brief Waits until at most `max_frames_in_flight` frames are unfinished, collects the finished frames' latency,
+    * and marks the beginning of a new frame in the command stream.
+    */
+    void begin_frame();
+
+    /**
+    * @brief Sets when the input of the current frame was sampled.
+    * @param input_sample_ns Nanoseconds on the `std::chrono::steady_clock`.
+    */
+    void set_input_time(int64_t input_sample_ns) {
+        m_input_sample_ns = input_sample_ns;
+    }
+
+    const LatencyStats &stats() const {
+        return m_stats;
+    }
+
+private:
+    /**
+    * @brief The ring has room for the frames in flight, and for the frames whose queries haven't been read yet.
+    */
+    static constexpr uint32_t RING_SIZE = 2 * MAX_FRAMES_IN_FLIGHT;
+
+    struct Slot {
+        void *fence{nullptr};
+        uint32_t query{0};
+
+        /**
+        * @brief Input time of the frame that ends where the fence and the query are.
+        */
+        int64_t input_sample_ns{0};
+    };
+
+    /**
+    * @brief Reads the timestamps of the finished frames, oldest first.
+    */
+    void collect_finished(int64_t gpu_to_cpu_ns);
+
+    void add_latency_sample(double latency_ms);
+
+    std::array<Slot, RING_SIZE> m_slots{};
+    uint64_t m_frame{0};
+
+    /**
+    * @brief The oldest frame whose slot still holds a fence.
+    */
+    uint64_t m_oldest_pending{0};
+    uint32_t m_max_frames_in_flight{2};
+    int64_t m_input_sample_ns{0};
+
+    std::array<double, LATENCY_WINDOW> m_latency_samples{};
+    uint32_t m_latency_sample_count{0};
+    LatencyStats m_stats{};
+};
+} // namespace engine::graphics
+
+#endif //FRAME_QUEUE_HPP
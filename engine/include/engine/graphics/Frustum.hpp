@@ -0,0 +1,49 @@
+/**
+ * @file Frustum.hpp
+ * @brief Defines the Frustum struct with the six planes of the volume a camera sees, and the visibility tests against them.
+*/
+
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+#include <glm/glm.hpp>
+#include <array>
+
+namespace engine::graphics {
+/**
+* @struct Frustum
+* @brief The six planes bounding the volume a camera sees, in world space.
+*
+* A plane is stored as `(normal, distance)` with a unit normal pointing into the volume,
+* so `dot(normal, point) + distance` is the signed distance of the point from the plane.
+*/
+struct Frustum {
+    enum Plane {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far
+    };
+
+    std::array<glm::vec4, 6> planes{};
+
+    /**
+    * @brief Extracts the normalized planes from the view-projection matrix, with the OpenGL clip space depth in [-w, w].
+    */
+    static Frustum from_matrix(const glm::mat4 &view_projection);
+
+    bool contains(const glm::vec3 &point) const;
+
+    bool intersects_sphere(const glm::vec3 &center, float radius) const;
+
+    /**
+    * @brief Tests the axis-aligned box against each plane. Conservative: a box outside the frustum near one of its
+    * corners can be reported as intersecting, but a visible box is never rejected.
+    */
+    bool intersects_box(const glm::vec3 &min, const glm::vec3 &max) const;
+};
+} // namespace engine::graphics
+
+#endif //FRUSTUM_HPP
@@ -7,6 +7,10 @@
 #define GRAPHICSCONTROLLER_HPP
 
 #include <engine/graphics/Camera.hpp>
+#include <engine/graphics/CommandList.hpp>
+#include <engine/graphics/FrameQueue.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/graphics/RenderThread.hpp>
 #include <engine/core/Controller.hpp>
 #include <engine/platform/PlatformEventObserver.hpp>
 
@@ -28,6 +32,8 @@ struct PerspectiveMatrixParams {
     float Height;
     float Near;
     float Far;
+
+    bool operator==(const PerspectiveMatrixParams &) const = default;
 };
 
 /**
@@ -40,6 +46,8 @@ struct OrthographicMatrixParams {
     float Top;
     float Near;
     float Far;
+
+    bool operator==(const OrthographicMatrixParams &) const = default;
 };
 
 enum ProjectionType {
@@ -55,6 +63,8 @@ enum ProjectionType {
 * For example @ref GraphicsController::draw_skybox.
 */
 class GraphicsController final : public core::Controller {
+    friend class GraphicsPlatformEventObserver;
+
 public:
     std::string_view name() const override;
 
@@ -78,11 +88,99 @@ public:
 
     /**
     * @brief Calls internal method for the ending of gui drawing. Should be called in pair with @ref GraphicsController::begin_gui.
+    * With the render thread, the draw lists are copied into the frame packet and rendered by the render thread.
     */
     void end_gui();
 
     /**
-    * @brief Draws a @ref resources::Skybox with the @ref resources::Shader.
+    * @brief Submits OpenGL calls for the current frame.
+    *
+    * Without the render thread the command runs immediately. With the render thread it's recorded into the
+    * @ref FramePacket and runs on the render thread after this frame's draw has finished on the main thread,
+    * so the command has to capture everything it reads from the main thread by value:
+    * @code
+    * glm::mat4 view = graphics->camera()->view_matrix();
+    * glm::mat4 projection = graphics->projection_matrix();
+    * graphics->submit([shader, model, view, projection] {
+    *     shader->use();
+    *     shader->set_mat4("view", view);
+    *     shader->set_mat4("projection", projection);
+    *     model->draw(shader);
+    * });
+    * @endcode
+    * The render thread is enabled in the config.json:
+    * @code
+    * "graphics": {
+    *   "render_thread": true
+    * }
+    * @endcode
+    */
+    void submit(std::function<void()> command);
+
+    /**
+    * @brief Submits command lists recorded for the current frame, see @ref CommandList. They are replayed in order.
+    */
+    void submit(std::vector<CommandList> lists);
+
+    /**
+    * @brief Submits command lists recorded for the current frame without copying them. The lists and their commands
+    * have to stay valid until the frame is drawn, for example when they are created in the @ref util::FrameArena.
+    */
+    void submit(std::span<const CommandList> lists);
+
+    /**
+    * @brief Runs OpenGL calls outside the frame, like loading a resource, and waits for them to finish.
+    * With the render thread it first waits for the render thread to draw the submitted frame.
+    * Called on the render thread, it runs the function immediately.
+    */
+    void run_on_render_thread(const std::function<void()> &function);
+
+    /**
+    * @brief Whether the OpenGL calls run on a dedicated render thread, see @ref GraphicsController::submit.
+    */
+    bool is_render_thread_enabled() const {
+        return m_render_thread_enabled;
+    }
+
+    /**
+    * @brief Hands the frame packet to the render thread. Called by the @ref core::App after the end_draw of all controllers.
+    * The render thread is started at the first frame, after all the controllers have loaded their resources.
+    */
+    void submit_frame();
+
+    /**
+    * @brief Shows the last drawn frame in the window again, without drawing it.
+    *
+    * In the render on demand mode, see @ref platform::PlatformController::request_redraw, every drawn frame is copied
+    * before the swap, and the @ref core::App presents the copy when the window lost its contents, for example when it
+    * was uncovered, but nothing requested a new frame. Does nothing before the first frame was drawn.
+    */
+    void present_last_frame();
+
+    /**
+    * @brief Stops the render thread and moves the OpenGL context back to the main thread.
+    * Called by the @ref core::App before the controllers are terminated, so that they can release their OpenGL objects.
+    */
+    void stop_render_thread();
+
+    /**
+    * @brief Get the framebuffer that the frame is drawn into. Bind it instead of `0` after drawing into your own framebuffers.
+    * With the render thread, call it inside a submitted command.
+    * @returns 0 when drawing into the window, the offscreen framebuffer in the headless mode.
+    */
+    uint32_t default_framebuffer() const {
+        return m_offscreen.id;
+    }
+
+    /**
+    * @brief Reads the pixels of the frame drawn so far. Available only in the headless mode, see @ref platform::PlatformController::is_headless.
+    * Waits for the GPU to finish drawing, so call it only when the pixels are needed, for example to save a screenshot in a test run.
+    * @returns RGBA8 pixels of the offscreen framebuffer, bottom row first.
+    */
+    std::vector<uint8_t> read_frame();
+
+    /**
+    * @brief Draws a @ref resources::Skybox with the @ref resources::Shader. Skipped while the skybox is evicted, until it's restored.
     */
     void draw_skybox(const resources::Shader *shader, const resources::Skybox *skybox);
 
@@ -91,18 +189,80 @@ public:
     }
 
     /**
-    * @brief Compute the projection matrix.
+    * @brief Rotates the camera by the mouse movement since the input was polled, see
+    * @ref platform::PlatformController::late_latch_mouse. Called at the beginning of the draw when the late latch is enabled.
+    */
+    void late_latch_camera();
+
+    /**
+    * @brief Enables the late latch: the mouse is sampled again right before drawing, and the camera is rotated
+    * by the movement since the @ref platform::PlatformController::poll_events, so the frame shows the latest mouse position.
+    * Disable it while the mouse isn't controlling the camera. The initial value is set in the config.json, together
+    * with the number of frames the CPU can get ahead of the GPU (0 disables the limit):
+    * @code
+    * "graphics": {
+    *   "late_latch": true,
+    *   "max_frames_in_flight": 2
+    * }
+    * @endcode
+    * The late latch stays disabled with the render thread. There the GPU wait runs on the render thread, so the main thread
+    * would sample the mouse at the beginning of the frame anyway, not after the wait.
+    */
+    void set_late_latch(bool enabled) {
+        m_late_latch = enabled && !m_render_thread_enabled;
+    }
+
+    bool is_late_latch_enabled() const {
+        return m_late_latch;
+    }
+
+    /**
+    * @brief Get the measured time from the input sampling to the GPU finishing the frame.
+    * With the render thread, the input is sampled in the @ref platform::PlatformController::poll_events, and the time
+    * includes the frame waiting for the render thread.
+    */
+    const LatencyStats &latency_stats() const {
+        return m_latency_stats;
+    }
+
+    /**
+    * @brief Get the view and projection matrices, their inverses, and the frustum of the camera with the perspective projection.
+    *
+    * Recomputed only when the camera or the perspective params changed since the last call. Take the snapshot on
+    * the main thread, and copy it into the commands and jobs that need it:
+    * @code
+    * const CameraSnapshot &camera = graphics->camera_snapshot();
+    * jobs->parallel_for(std::span(objects), [camera](Object &object) {
+    *     object.visible = camera.frustum.intersects_sphere(object.center, object.radius);
+    * });
+    * @endcode
+    */
+    const CameraSnapshot &camera_snapshot() const;
+
+    /**
+    * @brief Get the projection matrix. It's cached, and recomputed only when the params changed since the last call.
     * @returns Return perspective projection by default.
     */
     template<ProjectionType type = Perspective>
-    glm::mat4 projection_matrix() const {
+    const glm::mat4 &projection_matrix() const {
         if constexpr (type == Perspective) {
-            return glm::perspective(m_perspective_params.FOV,
-                                    m_perspective_params.Width / m_perspective_params.Height,
-                                    m_perspective_params.Near, m_perspective_params.Far);
+            if (!m_perspective_cached || m_cached_perspective_params != m_perspective_params) {
+                m_perspective_projection = glm::perspective(m_perspective_params.FOV,
+                                                            m_perspective_params.Width / m_perspective_params.Height,
+                                                            m_perspective_params.Near, m_perspective_params.Far);
+                m_cached_perspective_params = m_perspective_params;
+                m_perspective_cached = true;
+                ++m_perspective_version;
+            }
+            return m_perspective_projection;
         } else {
-            return glm::ortho(m_ortho_params.Left, m_ortho_params.Right, m_ortho_params.Bottom, m_ortho_params.Top,
-                              m_ortho_params.Near, m_ortho_params.Far);
+            if (!m_ortho_cached || m_cached_ortho_params != m_ortho_params) {
+                m_ortho_projection = glm::ortho(m_ortho_params.Left, m_ortho_params.Right, m_ortho_params.Bottom,
+                                                m_ortho_params.Top, m_ortho_params.Near, m_ortho_params.Far);
+                m_cached_ortho_params = m_ortho_params;
+                m_ortho_cached = true;
+            }
+            return m_ortho_projection;
         }
     }
 
@@ -120,7 +280,7 @@ public:
 
     /**
     * @brief Use this function to change the perspective projection matrix parameters.
-    * Projection matrix is always computed when the @ref GraphicsController::projection_matrix is called.
+    * Projection matrix is recomputed by the next @ref GraphicsController::projection_matrix call.
     * @returns @ref PerspectiveMatrixParams
     */
     PerspectiveMatrixParams &perspective_params() {
@@ -137,8 +297,7 @@ public:
 
     /**
     * @brief Use this function to change the orthographic projection matrix parameters.
-    * Projection matrix is always computed
-    * when @ref GraphicsController::projection_matrix is called.
+    * Projection matrix is recomputed by the next @ref GraphicsController::projection_matrix call.
     * @returns @ref PerspectiveMatrixParams
     */
     OrthographicMatrixParams &orthographic_params() {
@@ -159,19 +318,74 @@ private:
     */
     void initialize() override;
 
-    void terminate();
+    /**
+    * @brief Waits for the GPU if too many frames are in flight, applies the late latch, and
+    * binds the offscreen framebuffer in the headless mode, so that the frame is drawn into it.
+    */
+    void begin_draw() override;
+
+    /**
+    * @brief Copies the drawn frame for @ref GraphicsController::present_last_frame in the render on demand mode.
+    * Runs before the end_draw of the app controllers, which swap the buffers.
+    */
+    void end_draw() override;
+
+    void terminate() override;
+
+    /**
+    * @brief Recreates the offscreen framebuffer with the new size. Does nothing if the platform isn't headless.
+    */
+    void resize_offscreen(int width, int height);
 
     PerspectiveMatrixParams m_perspective_params{};
     OrthographicMatrixParams m_ortho_params{};
 
-    glm::mat4 m_projection_matrix{};
+    /**
+    * @brief The projection matrices, and the params they were computed from.
+    */
+    mutable glm::mat4 m_perspective_projection{1.0f};
+    mutable PerspectiveMatrixParams m_cached_perspective_params{};
+    mutable bool m_perspective_cached{false};
+    mutable uint64_t m_perspective_version{0};
+    mutable glm::mat4 m_ortho_projection{1.0f};
+    mutable OrthographicMatrixParams m_cached_ortho_params{};
+    mutable bool m_ortho_cached{false};
+
+    mutable CameraSnapshot m_camera_snapshot{};
+
+    /**
+    * @brief The @ref Camera::view_version and the `m_perspective_version` of the snapshot, 0 before the first one.
+    */
+    mutable uint64_t m_snapshot_view_version{0};
+    mutable uint64_t m_snapshot_projection_version{0};
     Camera m_camera{};
     ImGuiContext *m_imgui_context{};
+
+    /**
+    * @brief Framebuffer the frames are drawn into in the headless mode. Its id is 0 otherwise.
+    */
+    Framebuffer m_offscreen{};
+
+    /**
+    * @brief Copy of the last drawn frame in the render on demand mode.
+    */
+    Framebuffer m_present_cache{};
+
+    FrameQueue m_frame_queue;
+    bool m_late_latch{false};
+
+    /**
+    * @brief Copy of the @ref FrameQueue::stats, taken while the render thread isn't running the frame queue.
+    */
+    LatencyStats m_latency_stats{};
+
+    RenderThread m_render_thread;
+    bool m_render_thread_enabled{false};
 };
 
 /**
 * @class GraphicsPlatformEventObserver
-* @brief Observers change in window size in order to update the projection matrix.
+* @brief Observers change in window size in order to update the projection matrix and the viewport.
 */
 class GraphicsPlatformEventObserver final : public platform::PlatformEventObserver {
 public:
@@ -8,6 +8,10 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
 #include <engine/resources/Shader.hpp>
 
 namespace engine::resources {
@@ -28,6 +32,36 @@ class Skybox;
 #define CHECKED_GL_CALL(func, ...) engine::graphics::OpenGL::call(std::source_location::current(), func, __VA_ARGS__)
 
 namespace engine::graphics {
+/**
+* @struct DecodedImage
+* @brief Pixels of an image file decoded into memory, ready to be uploaded with @ref OpenGL::upload_texture.
+*/
+struct DecodedImage {
+    /**
+    * @brief Frees the pixels with the image library that decoded them.
+    */
+    struct PixelsDeleter {
+        void operator()(uint8_t *pixels) const;
+    };
+
+    std::unique_ptr<uint8_t, PixelsDeleter> pixels;
+    int32_t width{};
+    int32_t height{};
+    int32_t channels{};
+};
+
+/**
+* @struct Framebuffer
+* @brief OpenGL framebuffer object with an RGBA8 color attachment and a combined depth/stencil attachment.
+*/
+struct Framebuffer {
+    uint32_t id{0};
+    uint32_t color{0};
+    uint32_t depth_stencil{0};
+    int32_t width{0};
+    int32_t height{0};
+};
+
 /**
 * @class OpenGL
 * @brief This class serves as the OpenGL interface for your app, since the engine doesn't directly link OpenGL to the app executable.
@@ -80,6 +114,41 @@ public:
     */
     static uint32_t generate_texture(const std::filesystem::path &path, bool flip_uvs);
 
+    /**
+    * @brief Decodes the image file from `path` into memory. Doesn't touch the OpenGL context, so it's safe to call from any thread.
+    * Throws @ref engine::util::EngineError::Type::AssetLoadingError if the image can't be decoded.
+    * @param path path to an image file.
+    * @param flip_uvs flip the image vertically.
+    * @returns @ref DecodedImage
+    */
+    static DecodedImage decode_image(const std::filesystem::path &path, bool flip_uvs);
+
+    /**
+    * @brief Decodes an image file that is already in memory, for example a @ref engine::util::MappedFile.
+    * Throws @ref engine::util::EngineError::Type::AssetLoadingError if the image can't be decoded.
+    * @param bytes contents of an image file.
+    * @param flip_uvs flip the image vertically.
+    * @param name used in the error message.
+    * @returns @ref DecodedImage
+    */
+    static DecodedImage decode_image(std::span<const std::byte> bytes, bool flip_uvs, std::string_view name);
+
+    /**
+    * @brief Uploads the `image` into the texture object `texture_id`, replacing its previous contents, and generates the mipmaps.
+    * @param texture_id OpenGL id of the texture object.
+    * @param image decoded with @ref OpenGL::decode_image.
+    */
+    static void upload_texture(uint32_t texture_id, const DecodedImage &image);
+
+    /**
+    * @brief Estimates the GPU memory of the texture object from the size and the format of its base level.
+    * The mipmaps add a third of the base level, if the minifying filter uses them.
+    * @param texture_id OpenGL id of the texture object.
+    * @param target GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+    * @returns The estimated size in bytes.
+    */
+    static uint64_t texture_memory_size(uint32_t texture_id, int32_t target);
+
     /**
     * @brief Get texture format for a `number_of_channels`.
     * @param number_of_channels that the texture has.
@@ -134,6 +203,70 @@ public:
     */
     static void clear_buffers();
 
+    /**
+    * @brief Creates a framebuffer object that can be rendered into instead of the window.
+    * @param width Width of the attachments in pixels.
+    * @param height Height of the attachments in pixels.
+    * @returns @ref Framebuffer
+    */
+    static Framebuffer create_framebuffer(int32_t width, int32_t height);
+
+    /**
+    * @brief Deletes the framebuffer object and its attachments.
+    */
+    static void destroy_framebuffer(Framebuffer &framebuffer);
+
+    /**
+    * @brief Binds the framebuffer for drawing and reading, and sets the viewport to its size.
+    */
+    static void bind_framebuffer(const Framebuffer &framebuffer);
+
+    /**
+    * @brief Copies the color buffer of the `source` framebuffer into the `destination`, 0 is the window.
+    * Binds the window framebuffer afterwards.
+    */
+    static void blit_framebuffer(uint32_t source, uint32_t destination, int32_t width, int32_t height);
+
+    /**
+    * @brief Reads the color attachment of the framebuffer back to the CPU. Waits for the GPU to finish the frame.
+    * @returns RGBA8 pixels, bottom row first.
+    */
+    static std::vector<uint8_t> read_pixels(const Framebuffer &framebuffer);
+
+    /**
+    * @brief Loads the optional OpenGL extensions that the engine uses when the driver supports them.
+    * Called once by the @ref GraphicsController::initialize, after the OpenGL context has been created.
+    * @param loader Function that returns the address of an OpenGL function for a given name.
+    */
+    static void load_extensions(void *(*loader)(const char *name));
+
+    /**
+    * @brief Check if the driver supports the `GL_KHR_parallel_shader_compile` extension.
+    * @returns true if shader programs are compiled and linked in the background by the driver.
+    */
+    static bool parallel_shader_compile_supported();
+
+    /**
+    * @brief Check if the driver finished compiling and linking the shader program. Never waits for the driver.
+    * If `GL_KHR_parallel_shader_compile` isn't supported this function always returns true, and the next status query blocks instead.
+    * @param shader_program_id Shader program to check.
+    * @returns true if the status of the shader program can be queried without blocking.
+    */
+    static bool shader_program_ready(uint32_t shader_program_id);
+
+    /**
+    * @brief Check if the shader program with the `shader_program_id` linked successfully.
+    * @returns true if the shader program linking succeeded, false otherwise.
+    */
+    static bool shader_program_linked_successfully(uint32_t shader_program_id);
+
+    /**
+    * @brief Retrieve the shader program link error log message.
+    * @param shader_program_id Shader program for which the linking failed.
+    * @returns shader program link error message.
+    */
+    static std::string get_link_error_message(uint32_t shader_program_id);
+
     /**
     * @brief Retrieve the shader compilation error log message.
     * @param shader_id Shader id for which the compilation failed.
@@ -0,0 +1,163 @@
+/**
+ * @file RenderThread.hpp
+ * @brief Defines the RenderThread class that owns the OpenGL context and draws the frame packets recorded on the main thread.
+*/
+
+#ifndef RENDER_THREAD_HPP
+#define RENDER_THREAD_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <imgui.h>
+
+struct GLFWwindow;
+
+namespace engine::graphics {
+/**
+* @class GuiDrawData
+* @brief A copy of the ImGui draw lists of a frame, so that the next frame can be built while this one is rendered.
+*
+* The draw lists are reused between frames, so that copying doesn't allocate once the buffers are large enough.
+*/
+class GuiDrawData {
+public:
+    GuiDrawData() = default;
+
+    GuiDrawData(const GuiDrawData &) = delete;
+
+    GuiDrawData &operator=(const GuiDrawData &) = delete;
+
+    ~GuiDrawData();
+
+    /**
+    * @brief Copies the draw lists of the frame. Call it after the `ImGui::Render`.
+    */
+    void capture(const ImDrawData *draw_data);
+
+    /**
+    * @brief Renders the copied draw lists with the ImGui OpenGL backend. Has to be called on the render thread.
+    */
+    void render();
+
+private:
+    std::vector<ImDrawList *> m_lists;
+    ImDrawData m_draw_data;
+};
+
+/**
+* @struct FramePacket
+* @brief Everything the render thread needs to draw a frame.
+*
+* The main thread records the packet during the draw, and doesn't touch it again until the render thread has drawn it.
+* The commands capture the matrices and uniforms by value, so the main thread can update the camera and the scene
+* for the next frame while the render thread draws this one.
+*/
+struct FramePacket {
+    /**
+    * @brief OpenGL calls of the frame, in the order they were submitted.
+    */
+    std::vector<std::function<void()>> commands;
+
+    GuiDrawData gui;
+
+    uint64_t frame{0};
+};
+
+/**
+* @class RenderThread
+* @brief A thread that owns the OpenGL context and draws the previous frame while the main thread builds the next one.
+*
+* There are two @ref FramePacket. The main thread records into one of them, and at the end of the frame
+* @ref RenderThread::submit_frame waits until the render thread has drawn the other one, and hands the recorded one over.
+* The main thread is at most one frame ahead of the render thread.
+*
+* Errors thrown by the commands are rethrown on the main thread by the next @ref RenderThread::submit_frame or
+* @ref RenderThread::run_sync.
+*/
+class RenderThread {
+public:
+    RenderThread() = default;
+
+    RenderThread(const RenderThread &) = delete;
+
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    ~RenderThread();
+
+    /**
+    * @brief Moves the OpenGL context of the window from the calling thread to a new render thread.
+    */
+    void start(GLFWwindow *window);
+
+    /**
+    * @brief Draws the submitted packet, stops the render thread, and makes the OpenGL context current on the calling thread again.
+    * The commands recorded but not submitted are discarded. Does nothing if the thread isn't running.
+    * An error of the submitted packet that wasn't rethrown yet is logged.
+    */
+    void stop();
+
+    bool is_running() const {
+        return m_thread.joinable();
+    }
+
+    /**
+    * @brief Whether the caller runs on the render thread, for example inside a command.
+    */
+    bool is_current_thread() const {
+        return std::this_thread::get_id() == m_thread.get_id();
+    }
+
+    /**
+    * @brief Get the packet that the main thread records the current frame into.
+    */
+    FramePacket &packet() {
+        return m_packets[m_recording];
+    }
+
+    /**
+    * @brief Waits until the render thread has drawn the previous packet, and hands it the current one.
+    * @param on_idle Called while the render thread is waiting for the packet, so it can read the state the render thread writes.
+    */
+    void submit_frame(const std::function<void()> &on_idle);
+
+    /**
+    * @brief Runs the function on the render thread, after the submitted packet, and waits for it to finish.
+    * Meant for the occasional OpenGL work outside the frame, like loading a resource or reading the pixels back.
+    */
+    void run_sync(const std::function<void()> &function);
+
+private:
+    void run();
+
+    /**
+    * @brief Waits until the render thread has nothing to do, and rethrows its error. Called with the lock held.
+    */
+    void wait_idle(std::unique_lock<std::mutex> &lock);
+
+    std::array<FramePacket, 2> m_packets;
+    uint32_t m_recording{0};
+    uint64_t m_frame{0};
+
+    GLFWwindow *m_window{nullptr};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    /**
+    * @brief Packet handed to the render thread and not taken yet.
+    */
+    FramePacket *m_pending{nullptr};
+    const std::function<void()> *m_sync_function{nullptr};
+    bool m_busy{false};
+    bool m_running{false};
+    std::exception_ptr m_error;
+    std::thread m_thread;
+};
+} // namespace engine::graphics
+
+#endif //RENDER_THREAD_HPP
@@ -0,0 +1,58 @@
+/**
+ * @file FrameLimiter.hpp
+ * @brief Defines the FrameLimiter class that caps the frame rate of the main loop.
+*/
+
+#ifndef FRAME_LIMITER_HPP
+#define FRAME_LIMITER_HPP
+
+#include <chrono>
+
+namespace engine::platform {
+/**
+* @class FrameLimiter
+* @brief Waits until the target frame duration has passed since the previous frame began.
+*
+* The OS sleep wakes up late by up to a scheduler tick, so the limiter sleeps until shortly before the deadline,
+* and then spins for the rest of the time. The sleep margin adapts to the oversleep it measures.
+*/
+class FrameLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+    * @brief Sets the target frame rate.
+    * @param fps Frames per second. 0 disables the limiter.
+    */
+    void set_target_fps(double fps);
+
+    /**
+    * @brief Returns the target frame rate, 0 if the limiter is disabled.
+    */
+    double target_fps() const {
+        return m_target_fps;
+    }
+
+    /**
+    * @brief Blocks until the target frame duration has passed since the previous call, and starts the next frame.
+    */
+    void wait();
+
+private:
+    /**
+    * @brief The upper bound for the sleep margin, in case a single sleep wakes up extremely late.
+    */
+    static constexpr std::chrono::microseconds MAX_SLEEP_MARGIN{4000};
+
+    double m_target_fps{0.0};
+    Clock::duration m_frame_duration{};
+    Clock::time_point m_next_frame{};
+
+    /**
+    * @brief How long before the deadline the limiter stops sleeping and starts spinning.
+    */
+    Clock::duration m_sleep_margin{std::chrono::microseconds(1000)};
+};
+} // namespace engine::platform
+
+#endif //FRAME_LIMITER_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file FrameStats.hpp
+ * @brief Defines the FrameStats class that keeps rolling frame-time percentiles, a histogram, and the recent hitches.
+*/
+
+#ifndef FRAME_STATS_HPP
+#define FRAME_STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace engine::platform {
+/**
+* @struct FrameTimeSummary
+* @brief Frame-time statistics over the last @ref FrameStats::WINDOW frames, in milliseconds.
+*/
+struct FrameTimeSummary {
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double average_ms;
+    double max_ms;
+
+    /**
+    * @brief Standard deviation of the frame times, how unevenly the frames are paced.
+    */
+    double jitter_ms;
+};
+
+/**
+* @struct Hitch
+* @brief A frame that took much longer than the frames around it.
+*/
+struct Hitch {
+    uint64_t frame;
+
+    /**
+    * @brief When the frame ended, in nanoseconds since the platform was initialized.
+    */
+    int64_t time_ns;
+    int64_t duration_ns;
+
+    /**
+    * @brief The median frame time of the window when the hitch happened.
+    */
+    int64_t median_ns;
+};
+
+/**
+* @class FrameStats
+* @brief Collects the durations of the frames measured by the @ref PlatformController.
+*
+* A frame is a hitch when it takes longer than `hitch_factor` times the median frame of the window, and longer than
+* `hitch_min_ms`. Both are set in the config.json:
+* @code
+* "engine": {
+*   "frame_stats": {
+*     "hitch_factor": 2.0,
+*     "hitch_min_ms": 4.0
+*   }
+* }
+* @endcode
+*/
+class FrameStats {
+public:
+    /**
+    * @brief Number of recent frames the percentiles are computed from.
+    */
+    static constexpr uint32_t WINDOW = 512;
+
+    static constexpr uint32_t HISTOGRAM_BUCKETS = 64;
+
+    /**
+    * @brief Width of a histogram bucket. The last bucket counts all the frames longer than the others cover.
+    */
+    static constexpr double HISTOGRAM_BUCKET_MS = 0.5;
+
+    /**
+    * @brief Number of most recent hitches that are kept.
+    */
+    static constexpr uint32_t MAX_HITCHES = 32;
+
+    void configure(double hitch_factor, double hitch_min_ms);
+
+    /**
+    * @brief Adds a frame. The median the hitches are compared to is updated only every few frames, so adding is cheap.
+    */
+    void add_frame(int64_t duration_ns, int64_t time_ns);
+
+    /**
+    * @brief Computes the statistics of the frames in the window.
+    */
+    FrameTimeSummary summary() const;
+
+    /**
+    * @brief Number of frames in each bucket, since the start or the last @ref FrameStats::reset_histogram.
+    */
+    std::span<const uint64_t> histogram() const {
+        return m_histogram;
+    }
+
+    void reset_histogram() {
+        m_histogram.fill(0);
+    }
+
+    /**
+    * @brief The most recent hitches, oldest first.
+    */
+    std::span<const Hitch> hitches() const {
+        return std::span(m_hitches).first(std::min<uint64_t>(m_hitch_count, MAX_HITCHES));
+    }
+
+    /**
+    * @brief Number of hitches since the start, including the ones no longer kept.
+    */
+    uint64_t hitch_count() const {
+        return m_hitch_count;
+    }
+
+    uint64_t frame_count() const {
+        return m_frame_count;
+    }
+
+private:
+    static constexpr uint32_t MEDIAN_INTERVAL = 16;
+
+    /**
+    * @brief Copies the window into `m_sorted` and partially sorts it.
+    */
+    std::span<int64_t> sorted_window() const;
+
+    std::array<int64_t, WINDOW> m_frames{};
+    uint64_t m_frame_count{0};
+    int64_t m_median_ns{0};
+
+    std::array<uint64_t, HISTOGRAM_BUCKETS> m_histogram{};
+
+    /**
+    * @brief The last hitches, oldest first. When it's full, the oldest one is shifted out.
+    */
+    std::array<Hitch, MAX_HITCHES> m_hitches{};
+    uint64_t m_hitch_count{0};
+
+    double m_hitch_factor{2.0};
+    int64_t m_hitch_min_ns{4'000'000};
+
+    /**
+    * @brief Scratch space for the percentiles, so that computing them doesn't allocate.
+    */
+    mutable std::array<int64_t, WINDOW> m_sorted{};
+};
+} // namespace engine::platform
+
+#endif //FRAME_STATS_HPP
@@ -154,6 +154,7 @@ enum KeyId {
 */
 class Key final {
     friend class PlatformController;
+    friend class PlatformEventObserver;
 
 public:
     /**
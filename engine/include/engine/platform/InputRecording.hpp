@@ -0,0 +1,139 @@
+/**
+ * @file InputRecording.hpp
+ * @brief Defines the binary format of the input recordings, and the classes that write and read them.
+*/
+
+#ifndef INPUT_RECORDING_HPP
+#define INPUT_RECORDING_HPP
+
+#include <engine/platform/Input.hpp>
+#include <bitset>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace engine::platform {
+/**
+* @struct InputFrame
+* @brief The input state of a single frame, as the @ref PlatformController saw it after polling the events.
+*/
+struct InputFrame {
+    /**
+    * @brief Elapsed seconds for the previous frame in the recorded run.
+    */
+    float dt;
+
+    /**
+    * @brief The mouse state at the end of the frame.
+    */
+    MousePosition mouse;
+
+    /**
+    * @brief Keys and mouse buttons that were down, indexed by @ref KeyId.
+    * The @ref Key::State is derived from them by the same state machine as the live input.
+    */
+    std::bitset<KEY_COUNT> keys_down;
+
+    /**
+    * @brief The framebuffer size after a resize event in this frame, zero if the framebuffer wasn't resized.
+    */
+    int32_t resize_width;
+
+    int32_t resize_height;
+};
+
+/**
+* @struct InputRecordingHeader
+* @brief Written once at the beginning of the recording file.
+*/
+struct InputRecordingHeader {
+    static constexpr uint32_t MAGIC = 0x4e494752; // "RGIN"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic{MAGIC};
+    uint32_t version{VERSION};
+
+    /**
+    * @brief Number of keys in a frame. A recording can only be replayed by a build with the same @ref KEY_COUNT.
+    */
+    uint32_t key_count{KEY_COUNT};
+
+    /**
+    * @brief Every replayed frame advances the time by this many seconds.
+    */
+    float replay_dt;
+
+    int32_t window_width;
+    int32_t window_height;
+};
+
+/**
+* @class InputRecorder
+* @brief Appends the @ref InputFrame of every frame to a recording file.
+*
+* Start the app with `--record-input input.rgin` to record a run, and with `--replay-input input.rgin` to replay it.
+*/
+class InputRecorder {
+public:
+    /**
+    * @brief Creates the recording file and writes the header. Throws if the file can't be created.
+    */
+    InputRecorder(const std::filesystem::path &path, const InputRecordingHeader &header);
+
+    void write(const InputFrame &frame);
+
+    uint32_t frame_count() const {
+        return m_frame_count;
+    }
+
+private:
+    std::ofstream m_file;
+    std::filesystem::path m_path;
+    uint32_t m_frame_count{0};
+};
+
+/**
+* @class InputReplay
+* @brief Reads the frames of a recording file made by the @ref InputRecorder.
+*/
+class InputReplay {
+public:
+    /**
+    * @brief Opens the recording file and validates the header. Throws if the file isn't a compatible recording.
+    */
+    explicit InputReplay(const std::filesystem::path &path);
+
+    const InputRecordingHeader &header() const {
+        return m_header;
+    }
+
+    /**
+    * @brief Reads the next frame.
+    * @returns false when the recording has no more frames.
+    */
+    bool next(InputFrame &frame);
+
+    /**
+    * @brief Number of frames read so far.
+    */
+    uint32_t frame_count() const {
+        return m_frame_count;
+    }
+
+    /**
+    * @brief Sum of the recorded frame times read so far, in seconds.
+    */
+    double recorded_time() const {
+        return m_recorded_time;
+    }
+
+private:
+    std::ifstream m_file;
+    std::filesystem::path m_path;
+    InputRecordingHeader m_header{};
+    uint32_t m_frame_count{0};
+    double m_recorded_time{0.0};
+};
+} // namespace engine::platform
+
+#endif //INPUT_RECORDING_HPP
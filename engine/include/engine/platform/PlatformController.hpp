@@ -7,9 +7,15 @@
 #define MATF_RG_PROJECT_PLATFORM_H
 
 #include <engine/core/Controller.hpp>
+#include <algorithm>
+#include <bitset>
 #include <memory>
+#include <span>
 #include <vector>
+#include <engine/platform/FrameLimiter.hpp>
+#include <engine/platform/FrameStats.hpp>
 #include <engine/platform/Input.hpp>
+#include <engine/platform/InputRecording.hpp>
 #include <engine/platform/Window.hpp>
 #include <engine/platform/PlatformEventObserver.hpp>
 
@@ -19,6 +25,19 @@ namespace engine::platform {
 /**
 * @struct FrameTime
 * @brief Stores elapsed time for frames in seconds.
+*
+* The time is measured in integer nanoseconds on a monotonic clock, so it doesn't lose precision in long sessions.
+* The floating point values are converted from the nanoseconds every frame.
+*
+* The fixed timestep is configured in the config.json. The `max_fixed_steps` bounds the number of steps per frame,
+* so that a slow frame doesn't make the next one even slower. The `target_fps` caps the frame rate, 0 disables the cap:
+* @code
+* "engine": {
+*   "fixed_update_rate": 60,
+*   "max_fixed_steps": 8,
+*   "target_fps": 0
+* }
+* @endcode
 */
 struct FrameTime {
     /**
@@ -29,12 +48,65 @@ struct FrameTime {
     /**
     * @brief Time from the initialization of the Platform to the moment when the previous frame began.
     */
-    float previous;
+    double previous;
 
     /**
     * @brief Time from the initialization of the Platform to the moment when the current frame began.
     */
-    float current;
+    double current;
+
+    /**
+    * @brief The `dt` in nanoseconds.
+    */
+    int64_t dt_ns;
+
+    /**
+    * @brief The `previous` in nanoseconds.
+    */
+    int64_t previous_ns;
+
+    /**
+    * @brief The `current` in nanoseconds.
+    */
+    int64_t current_ns;
+
+    /**
+    * @brief Duration of a single @ref core::Controller::fixed_update step in seconds.
+    */
+    float fixed_dt;
+
+    /**
+    * @brief Number of @ref core::Controller::fixed_update steps that run in the current frame. Can be zero.
+    */
+    uint32_t fixed_steps;
+
+    /**
+    * @brief How far the current frame is between the last two fixed steps, in the range [0, 1).
+    * Use it in the @ref core::Controller::draw to interpolate between the previous and the current simulation state:
+    * @code
+    * glm::vec3 position = glm::mix(previous_position, current_position, frame_time.alpha);
+    * @endcode
+    */
+    float alpha;
+};
+
+/**
+* @brief How the buffer swap is synchronized with the display refresh.
+*/
+enum class VsyncMode {
+    /**
+    * @brief Swap immediately. The lowest latency, with tearing.
+    */
+    Off,
+    /**
+    * @brief Wait for the display refresh. No tearing, but a frame that misses the refresh waits for the next one.
+    */
+    On,
+    /**
+    * @brief Wait for the display refresh, but swap immediately when the frame is late, instead of waiting a whole refresh.
+    * Falls back to @ref VsyncMode::On if the driver doesn't support the swap control tear extension.
+    */
+    Adaptive
 };
 
 /**
@@ -71,6 +143,64 @@ public:
         return &m_window;
     }
 
+    /**
+    * @brief Check if the platform runs without a visible window.
+    *
+    * Start the app with `--headless`, or set it in the config.json:
+    * @code
+    * "window": {
+    *   "headless": true
+    * }
+    * @endcode
+    * The window is hidden when a display is available. Without a display, GLFW uses its null platform and
+    * creates the OpenGL context with EGL, or OSMesa as a fallback. The frame is drawn into an offscreen
+    * framebuffer owned by the @ref graphics::GraphicsController, and @ref PlatformController::swap_buffers does nothing.
+    * @returns true if the platform is headless.
+    */
+    bool is_headless() const {
+        return m_headless;
+    }
+
+    /**
+    * @brief Check if the input comes from a recording instead of the window.
+    *
+    * Start the app with `--record-input input.rgin` to record the key, mouse, scroll, and resize input of every frame,
+    * and with `--replay-input input.rgin` to feed the recording back through @ref PlatformController::key and
+    * @ref PlatformController::mouse. A replayed frame always advances the time by the fixed timestep of the recorded run,
+    * so a replay runs the same simulation regardless of how fast the frames are drawn. The app exits after the last
+    * recorded frame. The window input is ignored during the replay, but closing the window still exits.
+    * @returns true if the input is being replayed.
+    */
+    bool is_replaying_input() const {
+        return m_input_replay != nullptr;
+    }
+
+    /**
+    * @brief Polls the events again, and takes the mouse movement since the @ref PlatformController::poll_events.
+    *
+    * Use it right before the draw calls that depend on the mouse, to apply the latest movement to the frame.
+    * The taken movement is not repeated in the next frame's @ref PlatformController::mouse. Other events received
+    * here are delivered in the next frame. Returns no movement while the input is recorded or replayed.
+    * See @ref graphics::GraphicsController::late_latch_camera.
+    * @returns The current mouse position, and the movement since the last sample in `dx` and `dy`.
+    */
+    MousePosition late_latch_mouse();
+
+    /**
+    * @brief Get the time when the input of the current frame was last sampled, by the poll_events or a late latch.
+    * @returns Nanoseconds on the `std::chrono::steady_clock`.
+    */
+    int64_t input_sample_ns() const {
+        return m_input_sample_ns;
+    }
+
+    /**
+    * @brief Get the platform events of the current frame, in the order they happened.
+    */
+    std::span<const PlatformEvent> events() const {
+        return m_events;
+    }
+
     /**
     * @brief Register a @ref PlatformEventObserver callback for platform events.
     * By default, the @ref PlatformController registers a @ref PlatformEventObserver that does nothing.
@@ -93,6 +223,119 @@ public:
         return m_frame_time.dt;
     }
 
+    /**
+    * @brief Get the duration of a single fixed update step.
+    */
+    float fixed_dt() const {
+        return m_frame_time.fixed_dt;
+    }
+
+    /**
+    * @brief Get the statistics of the frame times measured by the platform: percentiles, the histogram, and the hitches.
+    */
+    const FrameStats &frame_stats() const {
+        return m_frame_stats;
+    }
+
+    void reset_frame_histogram() {
+        m_frame_stats.reset_histogram();
+    }
+
+    /**
+    * @brief Sets how the buffer swap waits for the display. The initial mode is set in the config.json,
+    * and the headless mode always uses @ref VsyncMode::Off:
+    * @code
+    * "window": {
+    *   "vsync": "on",
+    *   "swap_interval": 1
+    * }
+    * @endcode
+    * The `vsync` is "off", "on", or "adaptive".
+    * @param mode The vsync mode.
+    * @param interval Number of display refreshes per frame, used by the @ref VsyncMode::On and @ref VsyncMode::Adaptive.
+    */
+    void set_vsync(VsyncMode mode, int interval = 1);
+
+    /**
+    * @brief Get the vsync mode in effect. Differs from the requested one if the adaptive mode isn't supported.
+    */
+    VsyncMode vsync() const {
+        return m_vsync;
+    }
+
+    /**
+    * @brief Marks the frame dirty, so that the render on demand mode draws it.
+    *
+    * With the render on demand mode enabled, the frame is drawn only if something requested it. The platform requests
+    * it for the input events, for the keys held down, and for a resize. Controllers request it when their state
+    * changes, and every frame while they animate:
+    * @code
+    * void update() override {
+    *     if (m_animating) {
+    *         platform->request_redraw();
+    *     }
+    * }
+    * @endcode
+    * When no frame is requested, the @ref PlatformController::poll_events waits for an event or the `idle_timeout_ms`,
+    * and the window keeps showing the last drawn frame. The mode and the frame rates of an unfocused and a minimized
+    * window are set in the config.json, a frame rate of 0 doesn't throttle:
+    * @code
+    * "engine": {
+    *   "render_on_demand": true,
+    *   "idle_timeout_ms": 500,
+    *   "unfocused_fps": 10,
+    *   "minimized_fps": 5
+    * }
+    * @endcode
+    * A minimized window doesn't draw in either mode.
+    * @param frames Number of frames to draw, starting with the current one.
+    */
+    void request_redraw(uint32_t frames = 1) {
+        m_redraw_frames = std::max(m_redraw_frames, frames);
+    }
+
+    /**
+    * @brief Wakes up the main loop waiting for events in the render on demand mode. Can be called from any thread.
+    * The woken up frame doesn't draw unless a controller requests it with @ref PlatformController::request_redraw.
+    */
+    static void wake_up();
+
+    bool is_render_on_demand() const {
+        return m_render_on_demand;
+    }
+
+    void set_render_on_demand(bool enabled);
+
+    /**
+    * @brief Whether the current frame should be drawn. Checked by the @ref core::App before the draw.
+    */
+    bool is_redraw_needed() const {
+        return !m_minimized && (!m_render_on_demand || m_redraw_frames > 0);
+    }
+
+    /**
+    * @brief Whether the window lost its contents and has to show the last frame again, when it isn't redrawn anyway.
+    * See @ref graphics::GraphicsController::present_last_frame.
+    */
+    bool is_present_needed() const {
+        return m_present_needed;
+    }
+
+    bool is_focused() const {
+        return m_focused;
+    }
+
+    bool is_minimized() const {
+        return m_minimized;
+    }
+
+    /**
+    * @brief Get the frame limiter. Use it to change the target frame rate at runtime.
+    */
+    FrameLimiter *frame_limiter() {
+        return &m_frame_limiter;
+    }
+
     /**
     *  @brief Enables/disabled the visibility of the cursor on screen.
     */
@@ -100,6 +343,7 @@ public:
 
     /**
     * @brief Swaps the current draw buffer for the main window. Should be called at the end of the frame.
+    * Does nothing in the headless mode; use @ref graphics::GraphicsController::read_frame to get the rendered pixels.
     */
     void swap_buffers();
 
@@ -130,6 +374,21 @@ public:
 
     void _platform_on_mouse_button(int button, int action);
 
+    /**
+    * @brief Called from the platform-specific callback. You shouldn't call this function directly.
+    */
+    void _platform_on_window_focus(bool focused);
+
+    /**
+    * @brief Called from the platform-specific callback. You shouldn't call this function directly.
+    */
+    void _platform_on_window_minimize(bool minimized);
+
+    /**
+    * @brief Called from the platform-specific callback. You shouldn't call this function directly.
+    */
+    void _platform_on_window_refresh();
+
 private:
     Key &key_ref(KeyId key);
 
@@ -147,14 +406,131 @@ private:
 
     void poll_events() override;
 
+    /**
+    * @brief Counts the drawn frame against the frames requested by @ref PlatformController::request_redraw.
+    */
+    void end_draw() override;
+
+    /**
+    * @brief Waits for events instead of polling them when the frame doesn't need to be drawn, or when the window is
+    * throttled. Returns without waiting during an input replay.
+    */
+    void wait_events();
+
+    /**
+    * @brief Get the minimum duration of a frame for the unfocused or the minimized window, 0 if it isn't throttled.
+    */
+    int64_t throttle_interval_ns() const;
+
     void update_mouse();
 
-    void update_key(Key &key_data) const;
+    /**
+    * @brief Selects the GLFW platform and the context creation API before the glfwInit.
+    */
+    void select_platform();
+
+    /**
+    * @brief Creates the window, or an invisible window in the headless mode.
+    */
+    GLFWwindow *create_window(int width, int height, const std::string &title);
+
+    /**
+    * @brief Opens the input recording or replay requested on the command line.
+    */
+    void initialize_input_recording();
 
-    FrameTime m_frame_time;
+    /**
+    * @brief Applies the current frame of the input replay and notifies the observers.
+    */
+    void replay_input_frame();
+
+    /**
+    * @brief Writes the input state of the current frame into the input recording.
+    */
+    void record_input_frame();
+
+    /**
+    * @brief Transitions the keys that had events in this frame, or were just pressed or released in the previous one.
+    */
+    void update_keys();
+
+    void update_key(Key &key_data, bool down) const;
+
+    /**
+    * @brief Sets the key down or up, and queues the event.
+    */
+    void set_key_down(KeyId key, bool down);
+
+    static int64_t sample_time_ns();
+
+    /**
+    * @brief Advances the fixed timestep accumulator by the frame `dt`.
+    */
+    void advance_fixed_steps();
+
+    /**
+    * @brief Calls the glfwSwapInterval on the thread that owns the OpenGL context.
+    */
+    void apply_swap_interval(VsyncMode mode, int interval);
+
+    FrameTime m_frame_time{};
+    FrameLimiter m_frame_limiter;
+    FrameStats m_frame_stats;
+
+    /**
+    * @brief The `sample_time_ns` at the initialization, the frame times count from it.
+    */
+    int64_t m_start_ns{0};
+
+    /**
+    * @brief When the previous frame began, on the wall clock even when the input is replayed.
+    */
+    int64_t m_frame_wall_ns{0};
+    int64_t m_fixed_dt_ns{0};
+    int64_t m_fixed_accumulator_ns{0};
+    VsyncMode m_vsync{VsyncMode::On};
+    bool m_render_on_demand{false};
+
+    /**
+    * @brief Number of frames requested by @ref PlatformController::request_redraw. The first frame is always drawn.
+    */
+    uint32_t m_redraw_frames{1};
+    bool m_present_needed{false};
+    bool m_focused{true};
+    bool m_minimized{false};
+
+    /**
+    * @brief Whether the frame waited for the throttle, so that it isn't counted as a hitch.
+    */
+    bool m_throttled{false};
+    double m_idle_timeout{0.5};
+    int64_t m_unfocused_interval_ns{0};
+    int64_t m_minimized_interval_ns{0};
+    uint32_t m_max_fixed_steps{8};
+    bool m_headless{false};
+    int64_t m_input_sample_ns{0};
     Window m_window;
     std::vector<Key> m_keys;
+
+    /**
+    * @brief Keys that are down, updated by the key and mouse button events.
+    */
+    std::bitset<KEY_COUNT> m_keys_down;
+
+    /**
+    * @brief Keys that had an event in the current frame.
+    */
+    std::bitset<KEY_COUNT> m_key_events;
+
+    /**
+    * @brief Keys that are JustPressed or JustReleased, and have to transition in the next frame even without an event.
+    */
+    std::bitset<KEY_COUNT> m_keys_transitioning;
+    std::vector<PlatformEvent> m_events;
     std::vector<std::unique_ptr<PlatformEventObserver> > m_platform_event_observers;
+    std::unique_ptr<InputRecorder> m_input_recorder;
+    std::unique_ptr<InputReplay> m_input_replay;
+    InputFrame m_input_frame{};
 };
 } // namespace engine
 
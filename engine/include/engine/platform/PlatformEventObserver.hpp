@@ -7,8 +7,45 @@
 #define PLATFORMEVENTOBSERVER_HPP
 
 #include <engine/platform/Input.hpp>
+#include <cstdint>
+#include <span>
 
 namespace engine::platform {
+/**
+* @struct PlatformEvent
+* @brief A single platform event, queued by the @ref PlatformController while it polls the events of a frame.
+*/
+struct PlatformEvent {
+    enum class Type : uint8_t {
+        KeyPress,
+        KeyRelease,
+        MouseMove,
+        Scroll,
+        WindowResize
+    };
+
+    Type type;
+
+    /**
+    * @brief The key or mouse button of the KeyPress and KeyRelease events.
+    */
+    KeyId key;
+
+    /**
+    * @brief The mouse position of the MouseMove, the scroll offset of the Scroll, and the new size of the WindowResize.
+    */
+    float x;
+
+    float y;
+
+    /**
+    * @brief The mouse movement since the previous MouseMove event.
+    */
+    float dx;
+
+    float dy;
+};
+
 /**
 * @class PlatformEventObserver
 * @brief Platform events callback object.
@@ -17,6 +54,13 @@ namespace engine::platform {
 */
 class PlatformEventObserver {
 public:
+    /**
+    * @brief Called by @ref engine::platform::PlatformController once per frame with all the events of the frame,
+    * in the order they happened, after the key states have been updated.
+    * The default implementation calls the per-event methods below. Override it to handle the events in a single call.
+    */
+    virtual void on_events(std::span<const PlatformEvent> events);
+
     /**
     * @brief Called by @ref engine::platform::PlatformController for every frame in which the mouse moved.
     */
@@ -28,7 +72,9 @@ public:
     virtual void on_scroll(MousePosition position) {}
 
     /**
-    * @brief Called by @ref engine::platform::PlatformController for every frame in an event occurred on the keyboard or mouse key.
+    * @brief Called by @ref engine::platform::PlatformController for every press and release of a keyboard or mouse key.
+    * The state of the `key` is JustPressed for a press and JustReleased for a release, so a key pressed and released
+    * within one frame is delivered as both, while @ref PlatformController::key has the state at the end of the frame.
     */
     virtual void on_key(Key key) {}
 
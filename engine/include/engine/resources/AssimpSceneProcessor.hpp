@@ -0,0 +1,65 @@
+/**
+ * @file AssimpSceneProcessor.hpp
+ * @brief Defines the AssimpSceneProcessor class that converts an Assimp scene into engine meshes.
+*/
+
+#ifndef ASSIMP_SCENE_PROCESSOR_HPP
+#define ASSIMP_SCENE_PROCESSOR_HPP
+
+#include <engine/resources/Mesh.hpp>
+#include <filesystem>
+#include <vector>
+
+struct aiScene;
+struct aiNode;
+struct aiMesh;
+struct aiMaterial;
+
+namespace Assimp {
+class IOSystem;
+}
+
+namespace engine::resources {
+class ResourcesController;
+
+/**
+ * @brief Creates an Assimp IOSystem that opens the files through the @ref VirtualFileSystem, so that the models
+ * and the files they reference are read from the packs. Pass it to `Assimp::Importer::SetIOHandler`, which takes the ownership.
+ */
+Assimp::IOSystem *create_assimp_io_system();
+
+/**
+ * @class AssimpSceneProcessor
+ * @brief Processes the meshes in an Assimp scene.
+ *
+ * Used by the @ref ResourcesController to load models. The textures referenced by the scene materials are loaded
+ * through the @ref ResourcesController, relative to the model path.
+ */
+class AssimpSceneProcessor {
+public:
+    /**
+     * @brief Processes the meshes in the scene.
+     * @returns The meshes in the scene.
+     */
+    std::vector<Mesh> process_meshes();
+
+    explicit AssimpSceneProcessor(ResourcesController *resources_controller, const aiScene *scene,
+                                  std::filesystem::path model_path) :
+            m_scene(scene), m_model_path(std::move(model_path)), m_resources_controller(resources_controller) {
+    }
+
+private:
+    void process_node(const aiNode *node);
+
+    void process_mesh(aiMesh *mesh);
+
+    std::vector<Texture *> process_materials(const aiMaterial *material);
+
+    std::vector<Mesh> m_meshes;
+    const aiScene *m_scene;
+    std::filesystem::path m_model_path;
+    ResourcesController *m_resources_controller;
+};
+} // namespace engine::resources
+
+#endif //ASSIMP_SCENE_PROCESSOR_HPP
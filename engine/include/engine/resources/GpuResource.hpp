@@ -0,0 +1,106 @@
+/**
+ * @file GpuResource.hpp
+ * @brief Defines the GpuResource class that tracks the GPU memory of a resource and when it was last used.
+*/
+
+#ifndef GPU_RESOURCE_HPP
+#define GPU_RESOURCE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace engine::resources {
+/**
+* @class GpuResource
+* @brief Base of the resources that the @ref ResourcesController can evict from the GPU memory: @ref Texture,
+* @ref Model, and @ref Skybox.
+*
+* When the resources don't fit into the GPU memory budget, the least recently used ones are evicted.
+* An evicted resource keeps its CPU side data, or the path it was loaded from, and is restored when it's used again.
+* The resources retrieved from the @ref ResourcesController on the main thread are restored right away. A resource that is
+* drawn through a pointer kept from before, or retrieved on another thread, is restored before the next frame.
+*/
+class GpuResource {
+    friend class ResourcesController;
+
+public:
+    /**
+    * @brief Estimated size of the resource in the GPU memory, in bytes, when it's resident.
+    */
+    uint64_t gpu_memory_size() const {
+        return m_gpu_memory_size;
+    }
+
+    /**
+    * @brief Thread-safe. Once it returns true, the OpenGL objects of the resource are ready to be recorded.
+    */
+    bool is_resident() const {
+        return std::atomic_ref(m_resident).load(std::memory_order_acquire);
+    }
+
+    /**
+    * @brief Marks the resource as used in the current frame, and requests a restore if it's evicted.
+    * Called when the resource is retrieved or drawn. Thread-safe.
+    */
+    void mark_used() const;
+
+protected:
+    GpuResource() = default;
+
+    ~GpuResource() = default;
+
+    GpuResource(const GpuResource &) = default;
+
+    GpuResource(GpuResource &&) = default;
+
+    GpuResource &operator=(const GpuResource &) = default;
+
+    GpuResource &operator=(GpuResource &&) = default;
+
+    /**
+    * @brief Deletes the OpenGL objects, keeping what's needed to restore them. Called on the render thread.
+    */
+    virtual void evict_gpu_objects() = 0;
+
+    /**
+    * @brief Recreates the OpenGL objects and updates the @ref GpuResource::m_gpu_memory_size. Called on the render thread.
+    */
+    virtual void restore_gpu_objects() = 0;
+
+    uint64_t m_gpu_memory_size{0};
+
+private:
+    /**
+    * @brief Number of the frame being drawn, advanced by the @ref ResourcesController in the `begin_draw`.
+    */
+    static uint64_t current_frame();
+
+    static void begin_frame();
+
+    /**
+    * @returns true if a resource requested a restore since the last call.
+    */
+    static bool take_restore_requests();
+
+    /**
+    * @returns The frame in which the resource was last marked as used.
+    */
+    uint64_t last_used_frame() const;
+
+    bool restore_requested() const;
+
+    /**
+    * @brief Publishes the residency to the threads recording the draws, after the OpenGL objects were created or deleted.
+    */
+    void set_resident(bool resident);
+
+    /**
+    * @brief Written on the main thread and read by the workers recording the draws, always through std::atomic_ref.
+    */
+    mutable bool m_resident{true};
+    mutable uint64_t m_last_used_frame{0};
+    mutable bool m_restore_requested{false};
+};
+} // namespace engine::resources
+
+#endif //GPU_RESOURCE_HPP
@@ -0,0 +1,133 @@
+/**
+ * @file HotReloadController.hpp
+ * @brief Defines the HotReloadController class that reloads shaders and textures when their source files change.
+*/
+
+#ifndef HOT_RELOAD_CONTROLLER_HPP
+#define HOT_RELOAD_CONTROLLER_HPP
+
+#include <engine/core/Controller.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/ShaderCompiler.hpp>
+#include <engine/resources/Texture.hpp>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace engine::resources {
+/**
+* @class HotReloadController
+* @brief Watches the source files of the loaded shaders and textures, and reloads only the resources whose files changed.
+*
+* Enable it in the config.json:
+* @code
+* "resources": {
+*   "hot_reload": true
+* }
+* @endcode
+*
+* Files are watched with Linux `inotify`; on other platforms the controller disables itself.
+* Shaders are reloaded when their source file, or any of the files they include, changes.
+* Changed files are read, preprocessed, and decoded on a background thread. The new versions are swapped
+* in at the beginning of the frame, during @ref core::App::poll_events, so the `Shader*` and `Texture*`
+* pointers returned by the @ref ResourcesController stay valid.
+* If a changed shader fails to compile, the error is logged and the previous version of the shader is kept.
+*/
+class HotReloadController final : public core::Controller {
+public:
+    std::string_view name() const override {
+        return "HotReloadController";
+    }
+
+private:
+    /**
+    * @brief Shader that has to be recompiled when one of its files changes.
+    */
+    struct ShaderDependent {
+        Shader *shader;
+        ShaderSourceFile file;
+    };
+
+    /**
+    * @brief Texture that has to be decoded again when its file changes.
+    */
+    struct TextureDependent {
+        Texture *texture;
+        std::filesystem::path path;
+        bool flip_uvs;
+    };
+
+    /**
+    * @brief Starts watching the files of all the loaded resources.
+    */
+    void initialize() override;
+
+    /**
+    * @brief Swaps in the resources that finished reloading in the background. Runs at the frame boundary.
+    */
+    void poll_events() override;
+
+    /**
+    * @brief Stops the watcher thread.
+    */
+    void terminate() override;
+
+    /**
+    * @brief Rebuilds the map from files to the resources that depend on them, if resources were inserted or unloaded,
+    * or shader variants became ready, since the last update.
+    */
+    void update_dependency_map();
+
+    /**
+    * @returns true if the resource of the `dependent` is still loaded from the same file. The reloaded version is
+    * dropped otherwise, because the resource was unloaded and its slot may have been reused by another resource.
+    */
+    bool is_watched(const ShaderDependent &dependent) const;
+
+    bool is_watched(const TextureDependent &dependent) const;
+
+    /**
+    * @brief Watches the directory of the `file`. Must be called with the `m_mutex` locked.
+    */
+    void watch_directory_of(const std::filesystem::path &file);
+
+    /**
+    * @brief Watcher thread function. Waits for file changes and reloads the dependent resources.
+    */
+    void watch_files(std::stop_token stop_token);
+
+    /**
+    * @brief Reads, preprocesses, and decodes the resources that depend on the `changed_files`. Runs on the watcher thread.
+    */
+    void reload(const std::unordered_set<std::string> &changed_files);
+
+    int m_inotify_fd{-1};
+    /**
+    * @brief The @ref ResourcesController generation and the number of ready shader variants the map was built from.
+    */
+    uint64_t m_watched_generation{0};
+    size_t m_watched_variant_count{0};
+    std::jthread m_watcher;
+
+    /**
+    * @brief Guards all the fields below, they are shared with the watcher thread.
+    */
+    std::mutex m_mutex;
+    std::unordered_map<int, std::filesystem::path> m_watched_directories;
+    std::unordered_map<std::string, std::vector<ShaderDependent> > m_shader_dependents;
+    std::unordered_map<std::string, std::vector<TextureDependent> > m_texture_dependents;
+    std::vector<std::pair<ShaderDependent, ParsedShader> > m_parsed_shaders;
+    std::vector<std::pair<TextureDependent, graphics::DecodedImage> > m_decoded_textures;
+
+    /**
+    * @brief Shaders that have been submitted to the driver and are waiting to be swapped in. Used only on the main thread.
+    */
+    std::vector<std::pair<ShaderDependent, Shader> > m_compiling_shaders;
+};
+} // namespace engine::resources
+
+#endif //HOT_RELOAD_CONTROLLER_HPP
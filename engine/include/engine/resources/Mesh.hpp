@@ -7,7 +7,9 @@
 #define MATF_RG_PROJECT_MESH_HPP
 
 #include <glm/glm.hpp>
+#include <string>
 #include <vector>
+#include <engine/graphics/CommandList.hpp>
 #include <engine/resources/Texture.hpp>
 
 namespace engine::resources {
@@ -30,6 +32,7 @@ struct Vertex {
 */
 class Mesh {
     friend class AssimpSceneProcessor;
+    friend class Model;
 
 public:
 
@@ -39,6 +42,28 @@ public:
     */
     void draw(const Shader *shader);
 
+    /**
+    * @brief Records the draw of the mesh into the list, for the program bound earlier in the list.
+    * Doesn't call OpenGL, so it can be called on a worker thread.
+    * Marks the textures as used. An evicted texture is left unbound until it's restored.
+    */
+    void record_draw(graphics::CommandList &list) const;
+
+    /**
+    * @brief Returns the textures of the mesh.
+    * @returns The textures of the mesh.
+    */
+    const std::vector<Texture *> &textures() const {
+        return m_textures;
+    }
+
+    /**
+    * @brief Size of the vertex and index buffers in the GPU memory, in bytes.
+    */
+    uint64_t gpu_memory_size() const {
+        return static_cast<uint64_t>(m_num_vertices) * sizeof(Vertex) + static_cast<uint64_t>(m_num_indices) * sizeof(uint32_t);
+    }
+
     /**
     * @brief Destroys the mesh in the OpenGL context.
     */
@@ -54,9 +79,41 @@ private:
     Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
          std::vector<Texture *> textures);
 
+    /**
+    * @brief Creates the vertex array and the buffers, and uploads the `vertices` and the `indices` into them.
+    */
+    void upload(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+
+    /**
+    * @brief Reads the buffers back into @ref Mesh::m_evicted and deletes the OpenGL objects. Called by @ref Model.
+    */
+    void evict();
+
+    /**
+    * @brief Uploads the @ref Mesh::m_evicted data again and frees it. Called by @ref Model.
+    */
+    void restore();
+
     uint32_t m_vao{0};
+    uint32_t m_vbo{0};
+    uint32_t m_ebo{0};
+    uint32_t m_num_vertices{0};
     uint32_t m_num_indices{0};
     std::vector<Texture *> m_textures;
+
+    /**
+    * @struct EvictedData
+    * @brief The CPU side copy of the buffers while the mesh is evicted from the GPU memory.
+    */
+    struct EvictedData {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+    } m_evicted;
+
+    /**
+    * @brief The sampler uniform name for each texture, built once so that drawing doesn't allocate.
+    */
+    std::vector<std::string> m_texture_uniforms;
 };
 } // namespace engine
 
@@ -6,6 +6,7 @@
 #ifndef MATF_RG_PROJECT_MODEL_HPP
 #define MATF_RG_PROJECT_MODEL_HPP
 
+#include <engine/resources/GpuResource.hpp>
 #include <engine/resources/Mesh.hpp>
 #include <algorithm>
 #include <utility>
@@ -14,17 +15,28 @@ namespace engine::resources {
 /**
 * @class Model
 * @brief Represents a model object within the OpenGL context as an array of @ref Mesh objects.
+*
+* An evicted model keeps the vertices and the indices of its meshes in the CPU memory, see @ref GpuResource.
+* Its textures are evicted separately.
 */
-class Model {
+class Model final : public GpuResource {
     friend class ResourcesController;
 
 public:
     /**
     * @brief Draws the model using a given shader by drawing all the meshes in the model.
+    * Skipped while the model is evicted, until it's restored.
     * @param shader The shader to use for drawing.
     */
     void draw(const Shader *shader);
 
+    /**
+    * @brief Records the draws of all the meshes in the model into the list, see @ref graphics::CommandList.
+    * Doesn't call OpenGL, so it can be called on a worker thread. Skipped while the model is evicted, until it's restored.
+    * @param shader The shader to use for drawing.
+    */
+    void record_draw(graphics::CommandList &list, const Shader *shader) const;
+
     /**
     * @brief Destroys the model in the OpenGL context.
     */
@@ -70,6 +82,10 @@ private:
 
     Model() = default;
 
+    void evict_gpu_objects() override;
+
+    void restore_gpu_objects() override;
+
     /**
     * @brief Constructs a Model object. Used internally by the @ref engine::resources::ResourcesController class. You are not supposed to call this constructor directly from user code.
     * @param meshes The meshes in the model.
@@ -80,6 +96,9 @@ private:
           std::string name) : m_meshes(std::move(meshes))
                               , m_path(std::move(path))
                               , m_name(std::move(name)) {
+        for (const auto &mesh: m_meshes) {
+            m_gpu_memory_size += mesh.gpu_memory_size();
+        }
     }
 };
 } // namespace engine
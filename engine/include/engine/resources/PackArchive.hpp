@@ -0,0 +1,196 @@
+/**
+ * @file PackArchive.hpp
+ * @brief Defines the resource pack format, the PackArchive class that reads it, and the PackWriter class that builds it.
+*/
+
+#ifndef PACK_ARCHIVE_HPP
+#define PACK_ARCHIVE_HPP
+
+#include <engine/util/MappedFile.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::resources {
+/**
+* @struct PackHeader
+* @brief The first bytes of a pack file.
+*
+* A pack is laid out as: the header, the file payloads each starting at a multiple of @ref PackHeader::alignment,
+* the index of @ref PackEntry sorted by the path hash, and the paths of the entries.
+* All the integers are little-endian.
+*/
+struct PackHeader {
+    static constexpr std::array<char, 4> MAGIC = {'R', 'G', 'P', 'K'};
+    static constexpr uint32_t VERSION = 1;
+
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t alignment;
+    uint64_t index_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+};
+
+/**
+* @struct PackEntry
+* @brief A file in the pack index.
+*/
+struct PackEntry {
+    enum Flags : uint32_t {
+        /**
+        * @brief The payload is LZ4 block compressed, and decompresses to @ref PackEntry::original_size bytes.
+        */
+        Compressed = 1u << 0,
+    };
+
+    /**
+    * @brief @ref util::fnv1a of the path.
+    */
+    uint64_t path_hash;
+    uint64_t offset;
+
+    /**
+    * @brief Size of the payload stored in the pack.
+    */
+    uint64_t size;
+    uint64_t original_size;
+
+    /**
+    * @brief The path relative to the names block. Paths are normalized with forward slashes, see @ref PackArchive::normalize.
+    */
+    uint32_t path_offset;
+    uint32_t path_size;
+    uint32_t flags;
+    uint32_t reserved;
+
+    bool compressed() const {
+        return flags & Compressed;
+    }
+};
+
+static_assert(sizeof(PackHeader) == 40);
+static_assert(sizeof(PackEntry) == 48);
+
+/**
+* @class PackArchive
+* @brief A read-only pack file mapped into memory. Use it through the @ref VirtualFileSystem.
+*
+* Opening a pack reads only the index. The payloads are paged in by the OS when they are read,
+* so the uncompressed files are used straight from the mapping.
+*/
+class PackArchive {
+public:
+    /**
+    * @brief Maps the pack and validates its index.
+    * Throws @ref engine::util::EngineError::Type::AssetLoadingError if the file isn't a valid pack.
+    */
+    explicit PackArchive(const std::filesystem::path &path);
+
+    /**
+    * @brief Finds the entry with the `path` in O(log n) of the number of entries.
+    * @param path normalized with @ref PackArchive::normalize.
+    * @returns The entry, or nullptr if the pack doesn't contain the path.
+    */
+    const PackEntry *find(std::string_view path) const;
+
+    /**
+    * @brief The bytes of the entry as they are stored in the pack, compressed if the entry is.
+    */
+    std::span<const std::byte> payload(const PackEntry &entry) const;
+
+    /**
+    * @brief Decompresses the entry if it's compressed, otherwise copies it.
+    */
+    std::vector<std::byte> read(const PackEntry &entry) const;
+
+    std::string_view path(const PackEntry &entry) const;
+
+    /**
+    * @returns true if there are entries in the `directory`, normalized with @ref PackArchive::normalize.
+    */
+    bool contains_directory(std::string_view directory) const;
+
+    std::span<const PackEntry> entries() const {
+        return m_entries;
+    }
+
+    const std::filesystem::path &file_path() const {
+        return m_file.path();
+    }
+
+    /**
+    * @brief Converts the `path` into the form the entries are stored in: relative to the working directory,
+    * without `.` and `..` components, and with forward slashes.
+    */
+    static std::string normalize(const std::filesystem::path &path);
+
+private:
+    util::MappedFile m_file;
+    std::span<const PackEntry> m_entries;
+    std::string_view m_names;
+
+    /**
+    * @brief Sorted hashes of all the directories that contain the entries.
+    */
+    std::vector<uint64_t> m_directory_hashes;
+};
+
+/**
+* @class PackWriter
+* @brief Builds a pack from files on the disk. Used by the `rg-pack` tool:
+* @code
+* rg-pack resources.pack resources
+* @endcode
+*/
+class PackWriter {
+public:
+    /**
+    * @brief Payloads are aligned to the cache line, so that the files can be parsed in place.
+    */
+    static constexpr uint32_t DEFAULT_ALIGNMENT = 64;
+
+    /**
+    * @brief Compressed payloads are kept only if they save at least this fraction of the file size.
+    */
+    static constexpr double MIN_COMPRESSION_SAVING = 0.1;
+
+    /**
+    * @param compress compress the files, except the ones in formats that are already compressed, like png and jpg.
+    */
+    explicit PackWriter(bool compress = true, uint32_t alignment = DEFAULT_ALIGNMENT);
+
+    /**
+    * @brief Adds the file under the `path`, as normalized by @ref PackArchive::normalize.
+    */
+    void add_file(const std::filesystem::path &path);
+
+    /**
+    * @brief Adds all the files in the `directory` and its subdirectories.
+    */
+    void add_directory(const std::filesystem::path &directory);
+
+    /**
+    * @brief Writes the pack with all the added files.
+    * Throws @ref engine::util::EngineError::Type::GuaranteeViolation if two files have the same path hash.
+    */
+    void write(const std::filesystem::path &output) const;
+
+    size_t file_count() const {
+        return m_files.size();
+    }
+
+private:
+    std::vector<std::filesystem::path> m_files;
+    bool m_compress;
+    uint32_t m_alignment;
+};
+} // namespace engine::resources
+
+#endif //PACK_ARCHIVE_HPP
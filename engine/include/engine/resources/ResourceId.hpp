@@ -0,0 +1,50 @@
+/**
+ * @file ResourceId.hpp
+ * @brief Defines the ResourceId struct that identifies a resource by the hash of its name, and the `_rid` literal.
+*/
+
+#ifndef RESOURCE_ID_HPP
+#define RESOURCE_ID_HPP
+
+#include <engine/util/Utils.hpp>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace engine::resources {
+/**
+* @struct ResourceId
+* @brief The @ref util::fnv1a hash of a resource name. The `_rid` literal hashes the name at compile time,
+* so looking up a resource by its id doesn't hash a string at runtime:
+* @code
+* using namespace engine::resources::literals;
+* Shader *shader = resources->shader("basic"_rid);
+* @endcode
+*/
+struct ResourceId {
+    uint64_t hash;
+
+    constexpr explicit ResourceId(std::string_view name) : hash(util::fnv1a(name)) {
+    }
+
+    auto operator<=>(const ResourceId &) const = default;
+};
+
+/**
+* @brief The id is already a hash, so the hash maps keyed by ids use it as is.
+*/
+struct ResourceIdHash {
+    size_t operator()(uint64_t hash) const {
+        return static_cast<size_t>(hash);
+    }
+};
+
+inline namespace literals {
+consteval ResourceId operator""_rid(const char *name, size_t size) {
+    return ResourceId(std::string_view(name, size));
+}
+} // namespace literals
+} // namespace engine::resources
+
+#endif //RESOURCE_ID_HPP
@@ -11,14 +11,43 @@
 #include <engine/resources/Texture.hpp>
 #include <engine/resources/Shader.hpp>
 #include <engine/resources/Skybox.hpp>
+#include <engine/resources/ShaderCompiler.hpp>
+#include <engine/resources/ResourceId.hpp>
+#include <engine/util/SlotMap.hpp>
+#include <atomic>
+#include <future>
+#include <initializer_list>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace engine::resources {
 /**
 * @class ResourcesController
 * @brief Manages app resources: @ref Model, @ref Texture, @ref Shader, and @ref Skybox.
+*
+* Each resource type is stored in a @ref util::SlotMap, so the pointers to the resources stay valid while they are loaded.
+* A resource can be retrieved by its name, which loads it if needed, by its @ref ResourceId, or by its handle.
+* The handles and the ids are resolved without hashing a string, use them for the lookups done every frame:
+* @code
+* using namespace engine::resources::literals;
+* Shader *shader = resources->shader("basic"_rid);
+* util::Handle<Model> backpack = resources->handle<Model>("backpack"_rid);
+* Model *model = resources->get(backpack); // nullptr once the model is unloaded
+* @endcode
+*
+* The textures, models and skyboxes are kept within a GPU memory budget, set in the config.json in megabytes:
+* @code
+* "resources": {
+*   "gpu_memory_budget_mb": 512
+* }
+* @endcode
+* When the loaded resources exceed the budget, the least recently used ones are evicted at the end of the frame,
+* and restored when they are used again, see @ref GpuResource. Without the budget, or with 0, nothing is evicted.
 */
 class ResourcesController final : public core::Controller {
+    friend class HotReloadController;
+
 public:
     std::string_view name() const override {
         return "ResourcesController";
@@ -31,6 +60,11 @@ public:
     */
     Model *model(const std::string &name);
 
+    /**
+    * @brief Retrieves a loaded model. Throws @ref engine::util::EngineError::Type::GuaranteeViolation if the model isn't loaded.
+    */
+    Model *model(ResourceId id);
+
     /**
     * @brief Retrieves the @ref Texture with a given name. You are not supposed to call `delete` on this pointer.
     *
@@ -47,6 +81,11 @@ public:
                      TextureType texture_type = TextureType::Regular,
                      bool flip_uvs = false);
 
+    /**
+    * @brief Retrieves a loaded texture. Throws @ref engine::util::EngineError::Type::GuaranteeViolation if the texture isn't loaded.
+    */
+    Texture *texture(ResourceId id);
+
     /**
     * @brief Retrieves the @ref Skybox with a given name. You are not supposed to call `delete` on this pointer.
     *
@@ -61,6 +100,11 @@ public:
     Skybox *skybox(const std::string &name,
                    const std::filesystem::path &path = "", bool flip_uvs = false);
 
+    /**
+    * @brief Retrieves a loaded skybox. Throws @ref engine::util::EngineError::Type::GuaranteeViolation if the skybox isn't loaded.
+    */
+    Skybox *skybox(ResourceId id);
+
     /**
     * @brief Retrieves the @ref Shader with a given name. You are not supposed to call `delete` on this pointer.
     * @param name of the .glsl file in the `resources/shaders` directory
@@ -69,12 +113,237 @@ public:
     */
     Shader *shader(const std::string &name, const std::filesystem::path &path = "");
 
+    /**
+    * @brief Retrieves a loaded shader. Throws @ref engine::util::EngineError::Type::GuaranteeViolation if the shader isn't loaded.
+    */
+    Shader *shader(ResourceId id);
+
+    /**
+    * @brief Retrieves the variant of the @ref Shader `name` compiled with the `defines`. You are not supposed to call `delete` on this pointer.
+    *
+    * Variants are compiled lazily and in the background. The first call for a set of defines starts compiling the variant
+    * and returns the `fallback`. The function keeps returning the `fallback` until the driver finishes compiling the variant.
+    * Compiled variants are cached by the hash of the shader name and the defines, the order of the defines doesn't matter.
+    * @code
+    * auto shader = resources->shader_variant("basic", {"HAS_NORMAL_MAP"});
+    * @endcode
+    * @param name of the .glsl file in the `resources/shaders` directory.
+    * @param defines names to define in every stage of the shader. See @ref ShaderPreprocessor.
+    * @param fallback used while the variant is compiling. Defaults to the shader `name` without any defines.
+    * @returns The pointer to the compiled variant if it's ready, otherwise the `fallback`.
+    */
+    Shader *shader_variant(const std::string &name, std::initializer_list<std::string_view> defines,
+                           Shader *fallback = nullptr);
+
+    /**
+    * @brief Get the handle of a loaded resource.
+    * @tparam T one of @ref Model, @ref Texture, @ref Skybox, @ref Shader.
+    * @returns The handle, or a null handle if no resource of the type `T` with the `id` is loaded.
+    */
+    template<typename T>
+    util::Handle<T> handle(ResourceId id) {
+        auto &resources = storage<T>();
+        auto it = resources.ids.find(id.hash);
+        return it == resources.ids.end() ? util::Handle<T>{} : it->second.handle;
+    }
+
+    /**
+    * @brief Resolves the handle in O(1).
+    * @returns The resource, or nullptr if the handle is null or the resource was unloaded.
+    */
+    template<typename T>
+    T *get(util::Handle<T> handle) {
+        return use(storage<T>().slots.get(handle));
+    }
+
+    /**
+    * @brief Destroys the resource and frees its OpenGL objects. Its handles become stale and resolve to nullptr.
+    * The pointers to the resource become dangling, for example the texture pointers of the meshes that use the texture.
+    */
+    template<typename T>
+    void unload(util::Handle<T> handle);
+
+    /**
+    * @returns The estimated GPU memory of the resident textures, models, and skyboxes, in bytes.
+    */
+    uint64_t gpu_memory_used() const {
+        return m_gpu_memory_used;
+    }
+
+    /**
+    * @returns The GPU memory budget in bytes, 0 if there isn't one.
+    */
+    uint64_t gpu_memory_budget() const {
+        return m_gpu_memory_budget;
+    }
+
+    /**
+    * @brief Sets the GPU memory budget in bytes, 0 disables it. Enforced at the end of the next frame.
+    */
+    void set_gpu_memory_budget(uint64_t bytes) {
+        m_gpu_memory_budget = bytes;
+    }
+
 private:
+    /**
+    * @brief The resources used in the last few frames aren't evicted, so that the resources drawn every other frame,
+    * or loaded during the frame, don't bounce between the evicted and the restored state.
+    */
+    static constexpr uint64_t EVICTION_MIN_AGE_FRAMES = 3;
+
+    /**
+    * @struct ResourceStorage
+    * @brief The loaded resources of a type, and their handles by the hash of the resource name.
+    */
+    template<typename T>
+    struct ResourceStorage {
+        struct Entry {
+            util::Handle<T> handle;
+
+            /**
+            * @brief Only compared when a resource is loaded by name, to detect names with the same hash.
+            */
+            std::string name;
+        };
+
+        util::SlotMap<T> slots;
+        std::unordered_map<uint64_t, Entry, ResourceIdHash> ids;
+    };
+
+    template<typename T>
+    ResourceStorage<T> &storage() {
+        if constexpr (std::is_same_v<T, Model>) {
+            return m_models;
+        } else if constexpr (std::is_same_v<T, Texture>) {
+            return m_textures;
+        } else if constexpr (std::is_same_v<T, Skybox>) {
+            return m_sky_boxes;
+        } else if constexpr (std::is_same_v<T, Shader>) {
+            return m_shaders;
+        } else {
+            static_assert(false, "Not a resource type!");
+        }
+    }
+
+    /**
+    * @returns The resource loaded under the `name`, or nullptr.
+    */
+    template<typename T>
+    T *find_by_name(const std::string &name);
+
+    /**
+    * @returns The resource with the `id`. Throws if there isn't one.
+    */
+    template<typename T>
+    T *find_loaded(ResourceId id, std::string_view type);
+
+    template<typename T>
+    T *insert(const std::string &name, T resource);
+
+    /**
+    * @brief Marks the resource as used, see @ref ResourcesController::use_gpu_resource.
+    * @returns The `resource`.
+    */
+    template<typename T>
+    T *use(T *resource) {
+        if constexpr (std::is_base_of_v<GpuResource, T>) {
+            if (resource) {
+                use_gpu_resource(resource);
+            }
+        }
+        return resource;
+    }
+
+    /**
+    * @brief Marks the resource as used. An evicted resource is restored right away on the main thread,
+    * and at the beginning of the next frame on the other threads.
+    */
+    void use_gpu_resource(GpuResource *resource);
+
+    /**
+    * @brief Marks the model and its textures as used, so that the model isn't drawn with evicted textures.
+    */
+    void use_gpu_resource(Model *model);
+
+    /**
+    * @brief Calls `action(GpuResource &)` for each loaded texture, model, and skybox.
+    */
+    template<typename Action>
+    void for_each_gpu_resource(Action action) {
+        m_textures.slots.for_each([&](auto, GpuResource &resource) { action(resource); });
+        m_models.slots.for_each([&](auto, GpuResource &resource) { action(resource); });
+        m_sky_boxes.slots.for_each([&](auto, GpuResource &resource) { action(resource); });
+    }
+
+    /**
+    * @brief Restores the evicted `resources` on the render thread and accounts for their GPU memory.
+    */
+    void restore(const std::vector<GpuResource *> &resources);
+
+    /**
+    * @brief Evicts the least recently used resources until the resident ones fit into the budget.
+    */
+    void enforce_gpu_memory_budget();
+
+    /**
+    * @brief Replaces the accounted GPU memory of the `resource`, for example after it's reloaded.
+    */
+    void update_gpu_memory_size(GpuResource *resource, uint64_t size);
+
+    /**
+    * @struct ShaderVariant
+    * @brief Shader variant that is either being parsed on a worker thread, or has been submitted to the driver.
+    *
+    * The variant is submitted and polled by the commands of the frame, so the main thread never waits for the
+    * render thread. The `shader` is written on the render thread, and read on the main thread only once `ready` is set.
+    */
+    struct ShaderVariant {
+        /**
+        * @brief The shader name and the sorted defines, compared on every lookup to detect keys with the same hash.
+        */
+        std::string name;
+        std::vector<std::string> defines;
+
+        std::future<ParsedShader> parsing;
+        std::unique_ptr<Shader> shader;
+
+        /**
+        * @brief Set by the render thread once the driver has finished compiling the shader.
+        */
+        std::atomic<bool> ready{false};
+
+        /**
+        * @brief Set on the main thread once the parsed shader is queued for the driver.
+        */
+        bool submitted{false};
+
+        /**
+        * @brief The frame of the last queued readiness check, so that the check is queued at most once per frame.
+        */
+        uint64_t polled_frame{0};
+    };
+
     /**
     * @brief Loads all the resources from the "resources/" directory.
     */
     void initialize() override;
 
+    /**
+    * @brief Advances the frame used to find the least recently used resources, and restores the evicted resources
+    * that were used since the last frame.
+    */
+    void begin_draw() override;
+
+    /**
+    * @brief Enforces the GPU memory budget, see @ref ResourcesController::enforce_gpu_memory_budget.
+    */
+    void end_draw() override;
+
+    /**
+    * @brief Logs the GPU memory used, and how many resources were evicted and restored, if there is a budget.
+    */
+    void terminate() override;
+
     /**
     * @brief Loads all the models from the "resources/models" directory based on the provided configuration. Called during @ref ResourcesController::initialize.
     */
@@ -96,21 +365,51 @@ private:
     void load_shaders();
 
     /**
-    * @brief A hashmap of all the loaded @ref Model.
+    * @brief Replaces the shader program of the `shader` with the `replacement`. The `shader` pointer stays valid.
+    * Waits for the `replacement` to finish compiling. If the `replacement` fails to compile, it's destroyed, the
+    * `shader` is left unchanged, and the compilation error is thrown.
     */
-    std::unordered_map<std::string, std::unique_ptr<Model> > m_models;
+    void replace_shader(Shader *shader, Shader replacement);
+
+    /**
+    * @brief All the loaded @ref Model.
+    */
+    ResourceStorage<Model> m_models;
+    /**
+    * @brief All the loaded @ref Texture.
+    */
+    ResourceStorage<Texture> m_textures;
+    /**
+    * @brief All the loaded @ref Skybox.
+    */
+    ResourceStorage<Skybox> m_sky_boxes;
     /**
-    * @brief A hashmap of all the loaded @ref Texture.
+    * @brief All the loaded @ref Shader.
     */
-    std::unordered_map<std::string, std::unique_ptr<Texture> > m_textures;
+    ResourceStorage<Shader> m_shaders;
+    /**
+    * @brief A hashmap of all the requested shader variants, keyed by the hash of the shader name and the defines.
+    */
+    std::unordered_map<uint64_t, ShaderVariant> m_shader_variants;
+
+    /**
+    * @brief Incremented whenever a resource is inserted or unloaded. The @ref HotReloadController compares it to know
+    * when to rebuild its map of watched files, since an unloaded slot is reused at the same address.
+    */
+    uint64_t m_generation{0};
+
+    uint64_t m_gpu_memory_used{0};
+    uint64_t m_gpu_memory_budget{0};
+    uint64_t m_eviction_count{0};
+    uint64_t m_restore_count{0};
     /**
-    * @brief A hashmap of all the loaded @ref Skybox.
+    * @brief Set once the over budget warning is logged, until the resources fit into the budget again.
     */
-    std::unordered_map<std::string, std::unique_ptr<Skybox> > m_sky_boxes;
+    bool m_over_budget_reported{false};
     /**
-    * @brief A hashmap of all the loaded @ref Shader.
+    * @brief The thread that initialized the controller. Only the lookups on this thread restore the resources right away.
     */
-    std::unordered_map<std::string, std::unique_ptr<Shader> > m_shaders;
+    std::thread::id m_main_thread;
 
     const std::filesystem::path m_models_path = "resources/models";
     const std::filesystem::path m_textures_path = "resources/textures";
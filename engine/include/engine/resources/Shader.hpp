@@ -7,7 +7,9 @@
 #define MATF_RG_PROJECT_SHADER_HPP
 
 #include <engine/util/Utils.hpp>
+#include <array>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace engine::resources {
@@ -34,10 +36,14 @@ std::string_view to_string(ShaderType type);
 */
 class Shader {
     friend class ShaderCompiler;
+    friend class ResourcesController;
+    friend class HotReloadController;
 
 public:
     /**
     * @brief Binds the shader program.
+    * If the shader program was submitted for compilation with @ref ShaderCompiler::submit_batch, the first call
+    * waits for the driver to finish the compilation and throws if the compilation or linking failed.
     */
     void use() const;
 
@@ -47,6 +53,12 @@ public:
     */
     unsigned id() const;
 
+    /**
+    * @brief Checks whether the driver finished compiling the shader program, without waiting for it.
+    * @returns true if the @ref Shader::use won't block on the driver compiling the shader program.
+    */
+    bool is_ready() const;
+
     /**
     * @brief Sets a boolean uniform value.
     * @param name The name of the uniform.
@@ -128,6 +140,18 @@ public:
     */
     const std::filesystem::path &source_path() const;
 
+    /**
+    * @brief Returns the names that were defined when compiling this variant of the shader program.
+    * @returns The defines of the shader variant, empty for the base shader.
+    */
+    const std::vector<std::string> &defines() const;
+
+    /**
+    * @brief Returns the files included by the shader source, see @ref ShaderPreprocessor.
+    * @returns The paths to the included files.
+    */
+    const std::vector<std::filesystem::path> &dependencies() const;
+
 private:
     /**
     * @brief Constructs a Shader object.
@@ -155,6 +179,19 @@ private:
     std::string m_name;
     std::string m_source;
     std::filesystem::path m_source_path;
+    std::vector<std::string> m_defines;
+    std::vector<std::filesystem::path> m_dependencies;
+
+    /**
+    * @brief Shader objects for each of the @ref ShaderType stages, kept until the compilation status is checked.
+    * Zero for the stages that the shader program doesn't have.
+    */
+    mutable std::array<uint32_t, 3> m_pending_stages{};
+
+    /**
+    * @brief True until the compilation and link status of the shader program has been checked.
+    */
+    mutable bool m_pending{false};
 };
 } // namespace engine
 
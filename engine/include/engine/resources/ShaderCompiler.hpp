@@ -9,7 +9,10 @@
 #include <engine/graphics/OpenGL.hpp>
 #include <engine/resources/Shader.hpp>
 #include <filesystem>
+#include <future>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace engine::resources {
 /**
@@ -22,6 +25,36 @@ struct ShaderParsingResult {
     std::string geometry_shader;
 };
 
+/**
+* @struct ShaderSourceFile
+* @brief Names a shader source file for the @ref ShaderCompiler::submit_batch.
+*/
+struct ShaderSourceFile {
+    std::string name;
+    std::filesystem::path path;
+    /**
+    * @brief Names that are defined at the beginning of every stage of the shader. See @ref ShaderPreprocessor::inject_defines.
+    */
+    std::vector<std::string> defines{};
+};
+
+/**
+* @struct ParsedShader
+* @brief Shader source that has been preprocessed and split into stages. Submit it to the driver with @ref ShaderCompiler::submit.
+*/
+struct ParsedShader {
+    ShaderSourceFile file;
+    /**
+    * @brief Shader source with all the includes expanded.
+    */
+    std::string source;
+    ShaderParsingResult stages;
+    /**
+    * @brief Files included by the shader source.
+    */
+    std::vector<std::filesystem::path> dependencies;
+};
+
 /**
 * @class ShaderCompiler
 * @brief Compiles GLSL shaders from a single source file.
@@ -65,37 +98,70 @@ public:
     static Shader compile_from_file(std::string shader_name, const std::filesystem::path &shader_path);
 
     /**
-    * @brief Splits a single shader source string into `vertex`, `fragment`, [`geometry`] shader strings.
-    * @returns @ref ShaderParsingResult
+    * @brief Submits all the shader `files` for compilation without waiting for the driver to compile any of them.
+    *
+    * Source files are read and parsed on worker threads. The compilation and link status of each shader
+    * is checked only when the shader is first used, see @ref Shader::use. When the driver supports
+    * `GL_KHR_parallel_shader_compile` the compilation runs on the driver threads, overlapping with whatever
+    * the caller does next.
+    * @param files Shader source files to compile.
+    * @returns Shaders in the same order as `files`.
     */
-    ShaderParsingResult parse_source();
+    static std::vector<Shader> submit_batch(std::span<const ShaderSourceFile> files);
+
+    /**
+    * @brief Reads, preprocesses, and parses the shader `file` on a worker thread. Doesn't touch the OpenGL context.
+    * @param file Shader source file with the defines of the variant to build.
+    * @returns The future @ref ParsedShader. Pass it to @ref ShaderCompiler::submit on the thread that owns the OpenGL context.
+    */
+    static std::future<ParsedShader> parse_async(ShaderSourceFile file);
 
-private:
     /**
-    * @brief Compile shader sources into a OpenGL shader program.
-    * @returns A @ref graphics::OpenGL::ShaderProgramId referencing OpenGL shader program.
+    * @brief Reads, preprocesses, and parses the shader `file` on the calling thread. Doesn't touch the OpenGL context.
     */
-    graphics::OpenGL::ShaderProgramId compile(const ShaderParsingResult &shader_sources);
+    static ParsedShader parse_file(ShaderSourceFile file);
 
+    /**
+    * @brief Submits the shader stages for compilation and linking into a OpenGL shader program. Doesn't wait for the driver.
+    * The compilation status is checked the first time the shader is used, see @ref Shader::use.
+    * @param parsed_shader Parsed shader sources.
+    * @returns A @ref Shader that is pending compilation.
+    */
+    static Shader submit(ParsedShader parsed_shader);
+
+    /**
+    * @brief Waits for the driver to finish compiling the `shader` and checks the compilation and link status.
+    * Throws @ref util::EngineError::Type::ShaderCompilationError if any of the shader stages fails to compile or link.
+    */
+    static void finish_compilation(const Shader &shader);
+
+    /**
+    * @brief Creates a compiler for the already preprocessed `shader_source`. Use it with @ref ShaderCompiler::parse_source.
+    */
     ShaderCompiler(std::string shader_name, std::string shader_source) : m_shader_name(
             std::move(shader_name))
                                                                          , m_sources(std::move(shader_source)) {
     }
 
     /**
-    * @brief Returns the output field from the @ref ShaderParsingResult for which to continue appending `line`s of the `m_sources`.
-    * Detects if the line contains `//#shader` directive and returns a pointer to the appropriate
-    * field in the @ref ShaderParsingResult.
+    * @brief Splits a single shader source string into `vertex`, `fragment`, [`geometry`] shader strings.
+    * Iterates over the source lines as `std::string_view`s, so no memory is allocated per line.
+    * @returns @ref ShaderParsingResult
+    */
+    ShaderParsingResult parse_source();
+
+private:
+    /**
+    * @brief Expands the includes in the `source`, and splits it into stages with the `file` defines injected.
     */
-    std::string *now_parsing(ShaderParsingResult &result, const std::string &line);
+    static ParsedShader parse(ShaderSourceFile file, std::string_view source);
 
     /**
-    * @brief Compiles a single shader (Vertex|Fragment|Geometry) (not the whole program).
-    * @param shader_source
-    * @param type of the shader to compile Vertex|Fragment|Geometry
-    * @returns OpenGL id to a compiled shader.
+    * @brief Returns the output field from the @ref ShaderParsingResult for which to continue appending `line`s of the `m_sources`.
+    * Detects if the line contains `//#shader` directive and returns a pointer to the appropriate
+    * field in the @ref ShaderParsingResult.
     */
-    uint32_t compile(const std::string &shader_source, ShaderType type);
+    std::string *now_parsing(ShaderParsingResult &result, std::string_view line);
 
     std::string m_shader_name;
     std::string m_sources;
@@ -0,0 +1,96 @@
+/**
+ * @file ShaderPreprocessor.hpp
+ * @brief Defines the ShaderPreprocessor class that expands includes and injects defines into GLSL sources.
+*/
+
+#ifndef SHADER_PREPROCESSOR_HPP
+#define SHADER_PREPROCESSOR_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::resources {
+/**
+* @struct PreprocessedSource
+* @brief The shader source with all the `#include` directives expanded, and the list of files it was built from.
+*/
+struct PreprocessedSource {
+    std::string source;
+    /**
+    * @brief All the files that were included while expanding the source, in the order of inclusion.
+    * Doesn't contain the root source file.
+    */
+    std::vector<std::filesystem::path> dependencies;
+};
+
+/**
+* @class ShaderPreprocessor
+* @brief Runs before the @ref ShaderCompiler splits the source into stages.
+*
+* Shared GLSL code can be moved into a separate file and included with:
+* @code
+* #include "include/lighting.glsl"
+* @endcode
+* The path is resolved relative to the including file first, and then relative to the @ref ShaderPreprocessor::INCLUDE_DIRECTORY.
+* Every file is included at most once per shader, so the include files don't need include guards.
+* Keep the include files in a subdirectory of the `resources/shaders`, otherwise the @ref ResourcesController
+* will try to compile them as standalone shaders.
+*
+* Shader variants are built by injecting `#define NAME` lines right after the `#version` directive of every stage:
+* @code
+* #ifdef HAS_NORMAL_MAP
+*     vec3 normal = texture(texture_normal1, TexCoords).rgb;
+* #endif
+* @endcode
+*/
+class ShaderPreprocessor {
+public:
+    /**
+    * @brief Directory in which the included files are searched for if they aren't found relative to the including file.
+    */
+    static constexpr std::string_view INCLUDE_DIRECTORY = "resources/shaders/include";
+
+    /**
+    * @brief Expands all the `#include` directives in the `source` recursively.
+    * @param source The shader source code.
+    * @param source_path The path of the file from which the `source` was read. Used to resolve relative includes.
+    * @returns @ref PreprocessedSource
+    */
+    static PreprocessedSource expand_includes(std::string_view source, const std::filesystem::path &source_path);
+
+    /**
+    * @brief Inserts a `#define` line for each of the `defines` after the `#version` directive of the `stage_source`.
+    * If the stage has no `#version` directive the defines are inserted at the beginning.
+    * @param stage_source Source of a single shader stage.
+    * @param defines Names to define.
+    */
+    static void inject_defines(std::string &stage_source, std::span<const std::string> defines);
+
+    /**
+    * @brief Computes a hash of a set of defines that doesn't depend on the order of the defines.
+    * @returns Hash of the defines, zero for an empty set.
+    */
+    static uint64_t defines_hash(std::initializer_list<std::string_view> defines);
+
+    /**
+    * @brief Removes the first line from the `text` and returns it without the line terminator.
+    * Used to iterate over the lines of a source without allocating a string for every line.
+    * @param text The remaining text. Shrinks by the returned line.
+    * @returns The first line in the `text`.
+    */
+    static std::string_view next_line(std::string_view &text);
+
+private:
+    static void expand(std::string_view source, const std::filesystem::path &source_path,
+                       const std::filesystem::path &root_path, PreprocessedSource &result);
+
+    static std::filesystem::path resolve_include(std::string_view include, const std::filesystem::path &source_path);
+};
+} // namespace engine::resources
+
+#endif //SHADER_PREPROCESSOR_HPP
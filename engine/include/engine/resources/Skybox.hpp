@@ -6,16 +6,20 @@
 #ifndef SKYBOX_HPP
 #define SKYBOX_HPP
 
+#include <engine/resources/GpuResource.hpp>
 #include <cstdint>
 #include <filesystem>
+#include <string>
 #include <utility>
 
 namespace engine::resources {
 /**
 * @class Skybox
 * @brief Represents a skybox object within the OpenGL context.
+*
+* The cube vertex array is shared by all the skyboxes, only the cubemap texture is evicted, see @ref GpuResource.
 */
-class Skybox {
+class Skybox final : public GpuResource {
     friend class ResourcesController;
 
 public:
@@ -43,10 +47,15 @@ public:
 private:
     Skybox() = default;
 
+    void evict_gpu_objects() override;
+
+    void restore_gpu_objects() override;
+
     uint32_t m_vao{0};
     uint32_t m_texture_id{0};
     std::filesystem::path m_path{};
     std::string m_name{};
+    bool m_flip_uvs{false};
 
     /**
     * @brief Constructs a Skybox object.
@@ -54,12 +63,14 @@ private:
     * @param texture_id The OpenGL ID of the skybox texture.
     * @param path The path to the skybox texture.
     * @param name The name of the skybox.
+    * @param flip_uvs Whether the textures were flipped vertically when loaded.
     */
-    Skybox(uint32_t vao, uint32_t texture_id, std::filesystem::path path, std::string name)
+    Skybox(uint32_t vao, uint32_t texture_id, std::filesystem::path path, std::string name, bool flip_uvs)
             : m_vao(vao)
               , m_texture_id(texture_id)
               , m_path(std::move(path))
-              , m_name(std::move(name)) {
+              , m_name(std::move(name))
+              , m_flip_uvs(flip_uvs) {
     }
 };
 }
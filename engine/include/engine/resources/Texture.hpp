@@ -6,6 +6,7 @@
 #ifndef MATF_RG_PROJECT_TEXTURE_HPP
 #define MATF_RG_PROJECT_TEXTURE_HPP
 
+#include <engine/resources/GpuResource.hpp>
 #include <string_view>
 #include <filesystem>
 #include <utility>
@@ -27,8 +28,10 @@ enum class TextureType {
 /**
 * @class Texture
 * @brief Represents a texture object within the OpenGL context.
+*
+* An evicted texture has the id 0, and is restored by loading it again from its @ref Texture::path, see @ref GpuResource.
 */
-class Texture {
+class Texture final : public GpuResource {
     friend class ResourcesController;
 
 public:
@@ -90,6 +93,14 @@ public:
         return m_name;
     }
 
+    /**
+    * @brief Returns whether the texture was flipped vertically when loaded.
+    * @returns true if the texture was flipped on load.
+    */
+    bool flip_uvs() const {
+        return m_flip_uvs;
+    }
+
     Texture() = default;
 
 private:
@@ -107,10 +118,15 @@ private:
               , m_name(std::move(name)) {
     }
 
+    void evict_gpu_objects() override;
+
+    void restore_gpu_objects() override;
+
     uint32_t m_id{};
     TextureType m_type{};
     std::filesystem::path m_path{};
     std::string m_name{};
+    bool m_flip_uvs{false};
 };
 } // namespace engine
 #endif//MATF_RG_PROJECT_TEXTURE_HPP
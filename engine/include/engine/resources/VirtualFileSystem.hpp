@@ -0,0 +1,113 @@
+/**
+ * @file VirtualFileSystem.hpp
+ * @brief Defines the VirtualFileSystem class that the resource loaders read the files through.
+*/
+
+#ifndef VIRTUAL_FILE_SYSTEM_HPP
+#define VIRTUAL_FILE_SYSTEM_HPP
+
+#include <engine/resources/PackArchive.hpp>
+#include <engine/util/MappedFile.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace engine::resources {
+/**
+* @class FileContents
+* @brief The contents of a file read through the @ref VirtualFileSystem.
+*
+* Points into the pack mapping for the uncompressed pack entries, owns a mapping for the files on the disk,
+* and owns a buffer for the decompressed pack entries.
+*/
+class FileContents {
+    friend class VirtualFileSystem;
+
+public:
+    std::span<const std::byte> bytes() const {
+        return m_bytes;
+    }
+
+    /**
+    * @brief The contents as text. Not null-terminated.
+    */
+    std::string_view text() const {
+        return {reinterpret_cast<const char *>(m_bytes.data()), m_bytes.size()};
+    }
+
+    size_t size() const {
+        return m_bytes.size();
+    }
+
+private:
+    std::span<const std::byte> m_bytes;
+    std::optional<util::MappedFile> m_file;
+    std::vector<std::byte> m_buffer;
+};
+
+/**
+* @class VirtualFileSystem
+* @brief Reads the resource files from the mounted @ref PackArchive files, and from the disk for the files
+* that aren't in any of the packs.
+*
+* The app mounts the packs listed in the config.json before the controllers are initialized:
+* @code
+* "resources": {
+*   "packs": ["resources.pack"]
+* }
+* @endcode
+* The packs are built with the `rg-pack` tool, see @ref PackWriter. The paths in a pack are relative to the
+* working directory of the app, so the resource paths like "resources/textures/wall.png" are the same with and without packs.
+* The packs aren't mounted when the hot reload is enabled, so that the edited files on the disk are read.
+*
+* Mounting isn't thread-safe, all the other functions can be called from any thread once the packs are mounted.
+*/
+class VirtualFileSystem {
+public:
+    static VirtualFileSystem *instance();
+
+    /**
+    * @brief Mounts the pack. Files in packs mounted later take precedence over the same files in earlier packs.
+    * Throws @ref engine::util::EngineError::Type::AssetLoadingError if the file isn't a valid pack.
+    */
+    void mount(const std::filesystem::path &pack_path);
+
+    void unmount_all();
+
+    /**
+    * @returns true if the `path` is a file or a directory in a pack or on the disk.
+    */
+    bool exists(const std::filesystem::path &path) const;
+
+    /**
+    * @returns true if the `path` is a directory in a pack or on the disk.
+    */
+    bool is_directory(const std::filesystem::path &path) const;
+
+    /**
+    * @brief Reads the whole file. Throws @ref engine::util::EngineError::Type::FileNotFound if the file doesn't exist.
+    */
+    FileContents read(const std::filesystem::path &path) const;
+
+    /**
+    * @brief Lists the files and the directories directly inside the `directory`, from the packs and the disk, sorted.
+    * Replaces `std::filesystem::directory_iterator` in the resource loaders.
+    */
+    std::vector<std::filesystem::path> list(const std::filesystem::path &directory) const;
+
+    size_t pack_count() const {
+        return m_packs.size();
+    }
+
+private:
+    VirtualFileSystem() = default;
+
+    std::vector<std::unique_ptr<PackArchive> > m_packs;
+};
+} // namespace engine::resources
+
+#endif //VIRTUAL_FILE_SYSTEM_HPP
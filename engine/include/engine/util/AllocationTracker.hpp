@@ -0,0 +1,131 @@
+/**
+ * @file AllocationTracker.hpp
+ * @brief Defines the AllocationTracker that counts the heap allocations per frame and per profiled scope.
+*/
+
+#ifndef ALLOCATION_TRACKER_HPP
+#define ALLOCATION_TRACKER_HPP
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::util {
+/**
+* @struct AllocationSite
+* @brief Allocations made inside a single profiled scope during a frame.
+*/
+struct AllocationSite {
+    std::string_view name;
+    std::string_view detail;
+    uint64_t count;
+    uint64_t bytes;
+};
+
+/**
+* @struct AllocationScope
+* @brief The scope that the allocations on a thread are attributed to.
+*/
+struct AllocationScope {
+    std::string_view name;
+    std::string_view detail;
+
+    /**
+    * @brief True if this scope, or a scope that encloses it, is a strict phase.
+    */
+    bool strict;
+};
+
+/**
+* @struct AllocationFrameStats
+* @brief Heap allocations of a single frame.
+*/
+struct AllocationFrameStats {
+    static constexpr size_t MAX_SITES = 256;
+
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t frees;
+    std::array<AllocationSite, MAX_SITES> site_storage;
+    size_t site_count;
+
+    /**
+    * @brief Allocation sites sorted by the number of allocated bytes, largest first.
+    * Allocations made outside any profiled scope have an empty name.
+    */
+    std::span<const AllocationSite> sites() const {
+        return {site_storage.data(), site_count};
+    }
+};
+
+/**
+* @class AllocationTracker
+* @brief Counts the calls to the global `operator new` and `operator delete`.
+*
+* Tracking is compiled in only when the engine is configured with `-DRG_TRACK_ALLOCATIONS=ON`, otherwise
+* the functions do nothing and @ref AllocationTracker::is_available returns false. The allocations are attributed to
+* the innermost @ref RG_PROFILE_SCOPE on the allocating thread, which includes every controller phase,
+* even when the @ref Profiler isn't recording.
+*
+* The strict mode turns allocations in the steady-state phases into errors. A scope is in a strict phase when its name
+* or detail, or those of an enclosing scope, is listed in the config.json. After the warmup frames, an allocation in a
+* strict phase throws an @ref EngineError at the beginning of the next frame:
+* @code
+* "engine": {
+*   "allocation_tracking": {
+*     "strict_phases": ["draw"],
+*     "warmup_frames": 120
+*   }
+* }
+* @endcode
+*/
+class AllocationTracker {
+public:
+    static constexpr bool is_available() {
+#ifdef RG_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+    * @brief Sets the strict phases. Called by the @ref core::App during the engine setup.
+    */
+    static void configure(std::vector<std::string> strict_phases, uint32_t warmup_frames);
+
+    /**
+    * @brief Finishes the statistics of the previous frame. Called by the @ref core::App at the beginning of every frame.
+    * Throws an @ref EngineError if a strict phase allocated in the previous frame.
+    */
+    static void begin_frame();
+
+    /**
+    * @brief Get the allocations of the previous frame.
+    */
+    static const AllocationFrameStats &last_frame();
+
+    /**
+    * @brief Makes the scope current on the calling thread. Used by @ref ProfileScope.
+    * @returns The previously current scope, that has to be passed to @ref AllocationTracker::exit_scope.
+    */
+    static AllocationScope enter_scope(std::string_view name, std::string_view detail);
+
+    static void exit_scope(const AllocationScope &previous);
+
+    /**
+    * @brief Called from the global `operator new`. You shouldn't call this function directly.
+    */
+    static void _record_allocation(size_t bytes);
+
+    /**
+    * @brief Called from the global `operator delete`. You shouldn't call this function directly.
+    */
+    static void _record_free();
+};
+} // namespace engine::util
+
+#endif //ALLOCATION_TRACKER_HPP
@@ -51,6 +51,13 @@ public:
         }
     }
 
+    /**
+    * @brief Check if a flag without a value was passed, for example `--headless`.
+    * @param name The name of the flag.
+    * @returns true if the flag is present in the command line arguments.
+    */
+    bool has_flag(std::string_view name) const;
+
     /**
     * @brief Initialize the ArgParser with the command line arguments.
     * @param argc The number of command line arguments.
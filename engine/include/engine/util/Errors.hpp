@@ -104,6 +104,10 @@ public:
         * @brief The error that occurs when an asset loading fails.
         */
         AssetLoadingError,
+        /**
+        * @brief The error that occurs when a strict phase allocates on the heap. See @ref AllocationTracker.
+        */
+        SteadyStateAllocation,
 
         EngineErrorCount
     };
@@ -0,0 +1,155 @@
+/**
+ * @file FrameArena.hpp
+ * @brief Defines the FrameArena, a bump allocator for the data that lives only for a few frames.
+*/
+
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace engine::util {
+/**
+* @struct FrameArenaStats
+* @brief Memory usage of the @ref FrameArena, in bytes.
+*/
+struct FrameArenaStats {
+    /**
+    * @brief Bytes allocated in the previous frame.
+    */
+    size_t last_frame_bytes;
+
+    /**
+    * @brief The most bytes allocated in a single frame since the start.
+    */
+    size_t peak_frame_bytes;
+
+    /**
+    * @brief Size of a single frame buffer.
+    */
+    size_t capacity_bytes;
+
+    /**
+    * @brief Number of frames that didn't fit into their buffer, and fell back to the heap.
+    */
+    uint32_t overflow_frames;
+};
+
+/**
+* @class FrameArena
+* @brief A linear allocator for transient per-frame data.
+*
+* Allocating moves a pointer forward, and nothing is freed individually. The arena has
+* @ref FrameArena::FRAMES_IN_FLIGHT buffers, and @ref FrameArena::begin_frame switches to the next one and resets it,
+* so the memory allocated in a frame stays valid for the next `FRAMES_IN_FLIGHT - 1` frames, for example
+* until the GPU has consumed it. Allocating is lock-free and can be done from the @ref core::JobSystem workers.
+*
+* When a frame allocates more than the buffer holds, the rest comes from the heap, and the buffer grows when it is
+* reset, so that after the first frames the allocations from the arena don't touch the general heap.
+* The initial size is set in the config.json:
+* @code
+* "engine": {
+*   "frame_arena_size": 1048576
+* }
+* @endcode
+*
+* The arena is a `std::pmr::memory_resource`, so standard containers can use it:
+* @code
+* std::pmr::vector<const Mesh *> visible(util::FrameArena::instance());
+* @endcode
+* Destructors of the objects in the arena are never called. The objects created with @ref FrameArena::create are
+* either trivially destructible, or allocate their own memory from the arena too, like the @ref graphics::CommandList
+* of a frame:
+* @code
+* auto *list = util::FrameArena::instance()->create<graphics::CommandList>();
+* @endcode
+*/
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+    static FrameArena *instance();
+
+    /**
+    * @brief Allocates the buffers. Called by the @ref core::App during the engine setup.
+    * @param capacity Initial size of a single frame buffer in bytes.
+    */
+    void initialize(size_t capacity);
+
+    /**
+    * @brief Switches to the next buffer and releases everything that was allocated in it
+    * `FRAMES_IN_FLIGHT` frames ago. Called by the @ref core::App at the beginning of every frame.
+    * Must not be called while other threads allocate.
+    */
+    void begin_frame();
+
+    /**
+    * @brief Allocates an uninitialized array of `count` elements that lives for `FRAMES_IN_FLIGHT` frames.
+    */
+    template<typename T>
+    std::span<T> allocate_array(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "The FrameArena never calls destructors.");
+        return {static_cast<T *>(allocate(count * sizeof(T), alignof(T))), count};
+    }
+
+    /**
+    * @brief Constructs an object that lives for `FRAMES_IN_FLIGHT` frames. An object that takes a
+    * `std::pmr::polymorphic_allocator` is constructed with the arena as its allocator.
+    */
+    template<typename T, typename... Args>
+    T *create(Args &&... args) {
+        static_assert(std::is_trivially_destructible_v<T> ||
+                      std::uses_allocator_v<T, std::pmr::polymorphic_allocator<std::byte> >,
+                      "The FrameArena never calls destructors, so the objects can own only the memory of the arena.");
+        return std::uninitialized_construct_using_allocator(static_cast<T *>(allocate(sizeof(T), alignof(T))),
+                                                            std::pmr::polymorphic_allocator<std::byte>(this),
+                                                            std::forward<Args>(args)...);
+    }
+
+    FrameArenaStats stats() const;
+
+private:
+    struct Buffer {
+        std::unique_ptr<std::byte[]> memory;
+        size_t capacity{0};
+        std::atomic<size_t> offset{0};
+
+        /**
+        * @brief Heap allocations made after the buffer was full. Guarded by the `m_overflow_mutex`.
+        */
+        std::vector<std::pair<void *, size_t> > overflow;
+        size_t overflow_bytes{0};
+    };
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    void *allocate_overflow(Buffer &buffer, size_t bytes, size_t alignment);
+
+    static void reset(Buffer &buffer);
+
+    std::array<Buffer, FRAMES_IN_FLIGHT> m_buffers;
+    uint32_t m_current{0};
+    std::mutex m_overflow_mutex;
+    size_t m_last_frame_bytes{0};
+    size_t m_peak_frame_bytes{0};
+    uint32_t m_overflow_frames{0};
+};
+} // namespace engine::util
+
+#endif //FRAME_ARENA_HPP
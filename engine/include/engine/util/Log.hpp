@@ -0,0 +1,172 @@
+/**
+ * @file Log.hpp
+ * @brief Defines the logging macros that are stripped at compile time, and the asynchronous log sink.
+*/
+
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/sink.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <json.hpp>
+
+/**
+* @brief The logging macros for the code that runs every frame or every event.
+*
+* Calls below the `SPDLOG_ACTIVE_LEVEL` compile to nothing, and their arguments aren't evaluated.
+* The engine sets the level per build type: trace in Debug, debug in RelWithDebInfo, and info otherwise.
+* @code
+* RG_LOG_TRACE("Mouse moved to {} {}", position.x, position.y);
+* @endcode
+*/
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define RG_LOG_TRACE(...) ::spdlog::trace(__VA_ARGS__)
+#else
+#define RG_LOG_TRACE(...) static_cast<void>(0)
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define RG_LOG_DEBUG(...) ::spdlog::debug(__VA_ARGS__)
+#else
+#define RG_LOG_DEBUG(...) static_cast<void>(0)
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define RG_LOG_INFO(...) ::spdlog::info(__VA_ARGS__)
+#else
+#define RG_LOG_INFO(...) static_cast<void>(0)
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define RG_LOG_WARN(...) ::spdlog::warn(__VA_ARGS__)
+#else
+#define RG_LOG_WARN(...) static_cast<void>(0)
+#endif
+
+#define RG_LOG_ERROR(...) ::spdlog::error(__VA_ARGS__)
+
+namespace engine::util {
+/**
+* @class AsyncLogSink
+* @brief A spdlog sink that hands the messages to a background thread, which writes them to the wrapped sinks.
+*
+* Logging copies the message into a slot of a bounded lock-free ring buffer, so a thread that logs never waits
+* for the console. Short messages are stored inline in the slot, longer ones are copied to the heap.
+* When the buffer is full, the message is either dropped and counted, or the logging thread waits for a free slot.
+* Warnings and errors flush the buffer, so they are written before the call returns.
+*/
+class AsyncLogSink final : public spdlog::sinks::sink {
+public:
+    /**
+    * @brief What happens when a message is logged and the ring buffer is full.
+    */
+    enum class OverflowPolicy {
+        /**
+        * @brief Wait until the background thread frees a slot. No message is lost.
+        */
+        Block,
+        /**
+        * @brief Drop the message. The number of dropped messages is reported by the background thread.
+        */
+        Drop
+    };
+
+    /**
+    * @brief Number of message bytes stored inline in a slot.
+    */
+    static constexpr size_t INLINE_MESSAGE_SIZE = 192;
+
+    /**
+    * @param sinks Sinks that the background thread writes to.
+    * @param capacity Number of slots in the ring buffer, rounded up to a power of two.
+    * @param policy What to do when the ring buffer is full.
+    */
+    AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, size_t capacity, OverflowPolicy policy);
+
+    /**
+    * @brief Writes the remaining messages, and stops the background thread.
+    */
+    ~AsyncLogSink() override;
+
+    void log(const spdlog::details::log_msg &msg) override;
+
+    /**
+    * @brief Waits until the background thread has written the messages logged so far, and flushes the wrapped sinks.
+    */
+    void flush() override;
+
+    void set_pattern(const std::string &pattern) override;
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    /**
+    * @brief Number of messages dropped because the ring buffer was full.
+    */
+    uint64_t dropped_count() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        spdlog::level::level_enum level;
+        spdlog::log_clock::time_point time;
+        size_t thread_id;
+        spdlog::string_view_t logger_name;
+        size_t size;
+        char message[INLINE_MESSAGE_SIZE];
+        std::string long_message;
+    };
+
+    void run();
+
+    /**
+    * @brief Writes the next message in the ring buffer.
+    * @returns false if the ring buffer is empty.
+    */
+    bool write_next();
+
+    std::vector<spdlog::sink_ptr> m_sinks;
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    OverflowPolicy m_policy;
+
+    alignas(64) std::atomic<size_t> m_enqueue_position{0};
+    alignas(64) std::atomic<size_t> m_dequeue_position{0};
+
+    /**
+    * @brief Counts the logged messages. The background thread waits on it when the ring buffer is empty.
+    */
+    alignas(64) std::atomic<uint32_t> m_signal{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_running{true};
+    std::thread m_thread;
+};
+
+/**
+* @brief Configures the default logger from the `logging` object of the config.json. Called by the @ref core::App.
+* @code
+* "logging": {
+*   "level": "info",
+*   "async": true,
+*   "queue_size": 8192,
+*   "overflow": "block"
+* }
+* @endcode
+* The `overflow` is either "block" or "drop", see @ref AsyncLogSink::OverflowPolicy.
+*/
+void initialize_logging(const nlohmann::json &config);
+
+/**
+* @brief Writes the remaining messages and replaces the asynchronous logger with a synchronous one.
+*/
+void shutdown_logging();
+} // namespace engine::util
+
+#endif //LOG_HPP
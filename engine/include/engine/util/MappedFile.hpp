@@ -0,0 +1,97 @@
+/**
+ * @file MappedFile.hpp
+ * @brief Defines the MappedFile class that maps a file into memory for reading.
+*/
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace engine::util {
+/**
+* @class MappedFile
+* @brief Read-only memory mapping of a whole file.
+*
+* The bytes are read by the OS straight into the page cache and the mapping points at them,
+* so the file is read once, without copying it through stream buffers.
+* Decoders that take a memory buffer, like `stbi_load_from_memory`, read the @ref MappedFile::bytes directly.
+* @code
+* util::MappedFile file(path);
+* parse(file.text());
+* @endcode
+* The file must not be truncated by another process while it's mapped. Editors and the asset tools replace
+* a file by writing a new one, which is fine, the mapping keeps the old contents.
+*/
+class MappedFile {
+public:
+    /**
+    * @brief How the file is going to be read, passed to the OS with `madvise` so that it reads ahead accordingly.
+    */
+    enum class Access {
+        /**
+        * @brief Read once from the start to the end, like parsing or decoding. Reads ahead aggressively.
+        */
+        Sequential,
+        /**
+        * @brief Read at random offsets, like an archive. Reads only the pages that are touched.
+        */
+        Random,
+        /**
+        * @brief Read all of it soon. Starts reading the whole file in the background.
+        */
+        WillNeed,
+    };
+
+    /**
+    * @brief Maps the file at `path`. An empty file maps to an empty span.
+    * Throws @ref engine::util::EngineError::Type::FileNotFound if the file doesn't exist or can't be opened.
+    */
+    explicit MappedFile(const std::filesystem::path &path, Access access = Access::Sequential);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    std::span<const std::byte> bytes() const {
+        return {m_data, m_size};
+    }
+
+    /**
+    * @brief The contents as text. Not null-terminated.
+    */
+    std::string_view text() const {
+        return {reinterpret_cast<const char *>(m_data), m_size};
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    const std::filesystem::path &path() const {
+        return m_path;
+    }
+
+private:
+    void unmap();
+
+    std::filesystem::path m_path;
+    const std::byte *m_data{nullptr};
+    size_t m_size{0};
+};
+} // namespace engine::util
+
+#endif //MAPPED_FILE_HPP
@@ -0,0 +1,173 @@
+/**
+ * @file Profiler.hpp
+ * @brief Defines the Profiler that records timed scopes and exports them in the Chrome trace-event format.
+*/
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <engine/util/AllocationTracker.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <source_location>
+
+#define RG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RG_PROFILE_CONCAT(a, b) RG_PROFILE_CONCAT_IMPL(a, b)
+
+/**
+* @brief Profiles the enclosing scope. The name must outlive the profiler, use string literals or names
+* returned by @ref engine::core::Controller::name.
+* @code
+* void ParticleController::update() {
+*     RG_PROFILE_SCOPE("ParticleController::update");
+*     ...
+* }
+* @endcode
+*/
+#define RG_PROFILE_SCOPE(...) ::engine::util::ProfileScope RG_PROFILE_CONCAT(rg_profile_scope_, __LINE__)(__VA_ARGS__)
+
+/**
+* @brief Profiles the enclosing function. Uses the function name as the scope name.
+*/
+#define RG_PROFILE_FUNCTION() RG_PROFILE_SCOPE(std::source_location::current().function_name())
+
+namespace engine::util {
+/**
+* @struct ProfileEvent
+* @brief A single completed scope.
+*/
+struct ProfileEvent {
+    std::string_view name;
+    /**
+    * @brief Optional second part of the name, for example the main loop phase of a controller.
+    * Exported as `name::detail`.
+    */
+    std::string_view detail;
+    int64_t begin_ns;
+    int64_t end_ns;
+    /**
+    * @brief Number of the profiled scopes that enclosed this scope on the same thread.
+    */
+    uint32_t depth;
+};
+
+/**
+* @class Profiler
+* @brief Records the duration of the profiled scopes on every thread.
+*
+* Every thread writes into its own ring buffer, so recording doesn't take a lock. When a buffer is full,
+* the oldest events are overwritten. Recording is off by default and costs a single atomic load per scope.
+*
+* Start the app with `--profile out.json` to record the whole run and write it on exit.
+* Open the file in `chrome://tracing` or https://ui.perfetto.dev.
+*/
+class Profiler {
+public:
+    /**
+    * @brief Number of events each thread keeps.
+    */
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+    /**
+    * @brief Starts or stops recording.
+    */
+    static void set_enabled(bool enabled);
+
+    /**
+    * @brief Returns true if the profiler is recording.
+    */
+    static bool is_enabled() {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @brief Sets the name under which the calling thread's events are shown in the trace.
+    * Doesn't allocate the thread's buffer, that happens when the thread records its first event.
+    */
+    static void set_thread_name(std::string name);
+
+    /**
+    * @brief Returns the number of nanoseconds on the profiler clock.
+    */
+    static int64_t now_ns();
+
+    /**
+    * @brief Records a completed scope on the calling thread.
+    */
+    static void record(const ProfileEvent &event);
+
+    /**
+    * @brief Returns the depth of the calling thread's scopes. Used by @ref ProfileScope.
+    */
+    static uint32_t &thread_depth();
+
+    /**
+    * @brief Writes all the recorded events as a Chrome trace-event JSON file.
+    * Call it when no other thread is recording, otherwise the oldest events of those threads may be torn.
+    * @param path Where to write the trace.
+    */
+    static void export_chrome_trace(const std::filesystem::path &path);
+
+    /**
+    * @brief The ring buffer of a single thread.
+    */
+    struct ThreadEvents;
+
+private:
+    static ThreadEvents &thread_events();
+
+    /**
+    * @brief Returns the buffer of the calling thread, and creates it if needed. Must be called with the registry locked.
+    */
+    static ThreadEvents &thread_events_locked();
+
+    static inline std::atomic<bool> m_enabled{false};
+};
+
+/**
+* @class ProfileScope
+* @brief Records the time between its construction and destruction. Use it through @ref RG_PROFILE_SCOPE.
+*/
+class ProfileScope {
+public:
+    explicit ProfileScope(std::string_view name, std::string_view detail = {}) {
+#ifdef RG_TRACK_ALLOCATIONS
+        m_previous_allocation_scope = AllocationTracker::enter_scope(name, detail);
+#endif
+        if (Profiler::is_enabled()) {
+            m_name = name;
+            m_detail = detail;
+            m_depth = Profiler::thread_depth()++;
+            m_begin_ns = Profiler::now_ns();
+        }
+    }
+
+    ~ProfileScope() {
+        if (m_begin_ns >= 0) {
+            Profiler::record(ProfileEvent{m_name, m_detail, m_begin_ns, Profiler::now_ns(), m_depth});
+            --Profiler::thread_depth();
+        }
+#ifdef RG_TRACK_ALLOCATIONS
+        AllocationTracker::exit_scope(m_previous_allocation_scope);
+#endif
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    std::string_view m_name;
+    std::string_view m_detail;
+    int64_t m_begin_ns{-1};
+    uint32_t m_depth{0};
+#ifdef RG_TRACK_ALLOCATIONS
+    AllocationScope m_previous_allocation_scope;
+#endif
+};
+} // namespace engine::util
+
+#endif //PROFILER_HPP
@@ -0,0 +1,129 @@
+/**
+ * @file SimdMath.hpp
+ * @brief Defines SIMD kernels that transform large arrays of matrices, transforms, and bounding volumes.
+*/
+
+#ifndef SIMD_MATH_HPP
+#define SIMD_MATH_HPP
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace engine::util::simd {
+/**
+* @brief Get the instruction set the kernels were compiled for: "AVX2", "SSE2", or "scalar".
+*
+* SSE2 is used on every x86-64 build. AVX2 with FMA needs the engine to be configured with `-DRG_SIMD_AVX2=ON`,
+* and the binary then runs only on CPUs that support it. Other architectures use the scalar code.
+*/
+std::string_view instruction_set();
+
+/**
+* @struct Aabb
+* @brief Axis-aligned bounding box.
+*/
+struct Aabb {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+/**
+* @struct TransformArrays
+* @brief Positions, rotations, and scales of objects, stored as structure of arrays, so that the kernels
+* load the same component of several objects with a single instruction.
+*/
+struct TransformArrays {
+    std::vector<float> position_x, position_y, position_z;
+
+    /**
+    * @brief Unit quaternions.
+    */
+    std::vector<float> rotation_x, rotation_y, rotation_z, rotation_w;
+    std::vector<float> scale_x, scale_y, scale_z;
+
+    void resize(size_t count);
+
+    size_t size() const {
+        return position_x.size();
+    }
+
+    void set(size_t index, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+};
+
+/**
+* @struct PointArrays
+* @brief Points, or sphere centers with a radius, stored as structure of arrays.
+*/
+struct PointArrays {
+    std::vector<float> x, y, z;
+
+    /**
+    * @brief The sphere radii for @ref cull_spheres, unused by @ref to_clip_space.
+    */
+    std::vector<float> radius;
+
+    void resize(size_t count);
+
+    size_t size() const {
+        return x.size();
+    }
+};
+
+/**
+* @struct ClipArrays
+* @brief Homogeneous clip space coordinates, stored as structure of arrays.
+*/
+struct ClipArrays {
+    std::vector<float> x, y, z, w;
+
+    void resize(size_t count);
+
+    size_t size() const {
+        return x.size();
+    }
+};
+
+/**
+* @brief Computes `out[i] = a[i] * b[i]`. The `out` can be the same array as the `a` or the `b`.
+*/
+void multiply(std::span<const glm::mat4> a, std::span<const glm::mat4> b, std::span<glm::mat4> out);
+
+/**
+* @brief Computes `out[i] = a * b[i]`, for example the view-projection times the model matrices.
+* The `out` can be the same array as the `b`.
+*/
+void multiply(const glm::mat4 &a, std::span<const glm::mat4> b, std::span<glm::mat4> out);
+
+/**
+* @brief Computes `out[i] = translate(position[i]) * mat4_cast(rotation[i]) * scale(scale[i])`.
+*/
+void compose_trs(const TransformArrays &transforms, std::span<glm::mat4> out);
+
+/**
+* @brief Transforms the local boxes by their matrices into world space boxes that enclose them.
+* The `out` can be the same array as the `local`.
+*/
+void transform_aabbs(std::span<const glm::mat4> transforms, std::span<const Aabb> local, std::span<Aabb> out);
+
+/**
+* @brief Transforms the points into clip space, where a point is visible if `-w <= x, y, z <= w`.
+* @param view_projection Usually the @ref graphics::CameraSnapshot::view_projection.
+*/
+void to_clip_space(const glm::mat4 &view_projection, const PointArrays &points, ClipArrays &out);
+
+/**
+* @brief Tests the spheres against the frustum planes.
+* @param planes The normalized planes of a @ref graphics::Frustum, with the normals pointing inside.
+* @param visible Set to 1 for the spheres that intersect the frustum, and to 0 for the others.
+* @returns Number of visible spheres.
+*/
+size_t cull_spheres(const std::array<glm::vec4, 6> &planes, const PointArrays &spheres, std::span<uint8_t> visible);
+} // namespace engine::util::simd
+
+#endif //SIMD_MATH_HPP
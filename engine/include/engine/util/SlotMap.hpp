@@ -0,0 +1,190 @@
+/**
+ * @file SlotMap.hpp
+ * @brief Defines the SlotMap container that addresses its values with generational handles.
+*/
+
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace engine::util {
+/**
+* @struct Handle
+* @brief Refers to a value in a @ref SlotMap<T>. The type parameter only keeps the handles of different types apart.
+*
+* A default constructed handle is null. A handle becomes stale once its value is erased, even if the slot is reused,
+* because the slot generation changes.
+*/
+template<typename T>
+struct Handle {
+    uint32_t index{0};
+    uint32_t generation{0};
+
+    bool is_null() const {
+        return generation == 0;
+    }
+
+    bool operator==(const Handle &) const = default;
+};
+
+/**
+* @class SlotMap
+* @brief Stores values in chunks of contiguous slots, and gives out a @ref Handle<T> for each value.
+*
+* Resolving a handle is an index into a chunk and a comparison of the generation, O(1) and without hashing.
+* The chunks never move, so the pointers to the values stay valid until the values are erased.
+* Erased slots are reused by the next inserted values.
+* @code
+* util::SlotMap<Texture> textures;
+* util::Handle<Texture> handle = textures.emplace(...);
+* Texture *texture = textures.get(handle); // nullptr after textures.erase(handle)
+* @endcode
+*/
+template<typename T, uint32_t CHUNK_SIZE = 64>
+class SlotMap {
+public:
+    SlotMap() = default;
+
+    ~SlotMap() {
+        clear();
+    }
+
+    SlotMap(const SlotMap &) = delete;
+
+    SlotMap &operator=(const SlotMap &) = delete;
+
+    template<typename... Args>
+    Handle<T> emplace(Args &&... args) {
+        uint32_t index;
+        if (!m_free.empty()) {
+            index = m_free.back();
+            m_free.pop_back();
+        } else {
+            index = m_slot_count++;
+            if (index % CHUNK_SIZE == 0) {
+                m_chunks.push_back(std::make_unique<Chunk>());
+            }
+        }
+        Chunk &chunk = chunk_of(index);
+        const uint32_t slot = index % CHUNK_SIZE;
+        try {
+            std::construct_at(chunk.value(slot), std::forward<Args>(args)...);
+        } catch (...) {
+            m_free.push_back(index);
+            throw;
+        }
+        // Odd generations are occupied slots, so a null handle never resolves.
+        ++chunk.generations[slot];
+        ++m_size;
+        return {index, chunk.generations[slot]};
+    }
+
+    /**
+    * @returns The value, or nullptr if the handle is null or stale.
+    */
+    T *get(Handle<T> handle) {
+        if (handle.index >= m_slot_count) {
+            return nullptr;
+        }
+        Chunk &chunk = chunk_of(handle.index);
+        const uint32_t slot = handle.index % CHUNK_SIZE;
+        return (handle.generation & 1) && chunk.generations[slot] == handle.generation ? chunk.value(slot) : nullptr;
+    }
+
+    const T *get(Handle<T> handle) const {
+        return const_cast<SlotMap *>(this)->get(handle);
+    }
+
+    bool contains(Handle<T> handle) const {
+        return get(handle) != nullptr;
+    }
+
+    /**
+    * @brief Destroys the value. Its handles become stale.
+    * @returns false if the handle was already stale.
+    */
+    bool erase(Handle<T> handle) {
+        T *value = get(handle);
+        if (!value) {
+            return false;
+        }
+        release(handle.index, value);
+        return true;
+    }
+
+    /**
+    * @brief Calls `action(handle, value)` for each value, in the order of the slots.
+    */
+    template<typename Action>
+    void for_each(Action action) {
+        for (uint32_t index = 0; index < m_slot_count; ++index) {
+            Chunk &chunk = chunk_of(index);
+            const uint32_t slot = index % CHUNK_SIZE;
+            if (chunk.generations[slot] & 1) {
+                action(Handle<T>{index, chunk.generations[slot]}, *chunk.value(slot));
+            }
+        }
+    }
+
+    /**
+    * @brief Destroys all the values. All the handles become stale, the chunks are kept for reuse.
+    */
+    void clear() {
+        for (uint32_t index = 0; index < m_slot_count; ++index) {
+            Chunk &chunk = chunk_of(index);
+            const uint32_t slot = index % CHUNK_SIZE;
+            if (chunk.generations[slot] & 1) {
+                release(index, chunk.value(slot));
+            }
+        }
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+private:
+    struct Chunk {
+        std::array<uint32_t, CHUNK_SIZE> generations{};
+        alignas(T) std::byte storage[CHUNK_SIZE * sizeof(T)];
+
+        T *value(uint32_t slot) {
+            return std::launder(reinterpret_cast<T *>(storage) + slot);
+        }
+    };
+
+    Chunk &chunk_of(uint32_t index) {
+        return *m_chunks[index / CHUNK_SIZE];
+    }
+
+    void release(uint32_t index, T *value) {
+        std::destroy_at(value);
+        uint32_t &generation = chunk_of(index).generations[index % CHUNK_SIZE];
+        ++generation;
+        --m_size;
+        // A slot whose generation would wrap around is retired, so that an old handle can't resolve to a new value.
+        if (generation != std::numeric_limits<uint32_t>::max() - 1) {
+            m_free.push_back(index);
+        }
+    }
+
+    std::vector<std::unique_ptr<Chunk> > m_chunks;
+    std::vector<uint32_t> m_free;
+    uint32_t m_slot_count{0};
+    size_t m_size{0};
+};
+} // namespace engine::util
+
+#endif //SLOT_MAP_HPP
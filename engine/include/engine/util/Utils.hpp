@@ -6,7 +6,9 @@
 #ifndef MATF_RG_PROJECT_UTILS_HPP
 #define MATF_RG_PROJECT_UTILS_HPP
 
+#include <cstdint>
 #include <format>
+#include <string_view>
 #include <source_location>
 #include <vector>
 #include <mutex>
@@ -89,12 +91,25 @@ void tracing_off();
 void trace(std::source_location location = std::source_location::current());
 
 /**
-* @brief Reads a text file.
+* @brief Reads a text file. Use @ref MappedFile instead when the contents don't need to outlive the parsing.
 * @param path The path to the file.
 * @returns The content of the file.
 */
 std::string read_text_file(const std::filesystem::path &path);
 
+/**
+* @brief 64-bit FNV-1a hash of a string. Usable at compile time, and stable across runs and platforms,
+* unlike `std::hash`, so the hashes can be stored in files.
+*/
+constexpr uint64_t fnv1a(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c: text) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 /**
 * @brief Calls an action once.
 * @param action The action to call.
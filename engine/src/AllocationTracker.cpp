@@ -0,0 +1,279 @@
+#include <engine/util/AllocationTracker.hpp>
+#include <engine/util/Errors.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <new>
+
+namespace engine::util {
+
+#ifdef RG_TRACK_ALLOCATIONS
+
+/**
+* @brief The allocation that broke the strict mode.
+*/
+struct StrictViolation {
+    bool happened;
+    AllocationSite site;
+    uint64_t frame;
+};
+
+// Everything the hooks touch is constant-initialized, so the allocations made before main are counted safely.
+constinit static std::mutex g_mutex;
+constinit static AllocationFrameStats g_current_frame{};
+constinit static AllocationFrameStats g_last_frame{};
+constinit static StrictViolation g_violation{};
+constinit static uint64_t g_frame = 0;
+constinit static uint32_t g_warmup_frames = 0;
+static std::vector<std::string> g_strict_phases;
+
+constinit thread_local AllocationScope g_scope{};
+
+/**
+* @brief Set while the tracker itself holds the lock, so that its own allocations aren't counted.
+*/
+constinit thread_local bool g_inside_tracker = false;
+
+static AllocationSite &find_site(AllocationFrameStats &frame, const AllocationScope &scope) {
+    auto hash = std::hash<const void *>{}(scope.name.data()) ^ (std::hash<const void *>{}(scope.detail.data()) << 1);
+    for (size_t probe = 0; probe < AllocationFrameStats::MAX_SITES; ++probe) {
+        auto &site = frame.site_storage[(hash + probe) % AllocationFrameStats::MAX_SITES];
+        if (site.count == 0) {
+            site.name = scope.name;
+            site.detail = scope.detail;
+            ++frame.site_count;
+            return site;
+        }
+        if (site.name.data() == scope.name.data() && site.name.size() == scope.name.size() &&
+            site.detail.data() == scope.detail.data() && site.detail.size() == scope.detail.size()) {
+            return site;
+        }
+    }
+    // The table is full, the allocation is attributed to whichever site the hash landed on.
+    return frame.site_storage[hash % AllocationFrameStats::MAX_SITES];
+}
+
+void AllocationTracker::configure(std::vector<std::string> strict_phases, uint32_t warmup_frames) {
+    g_strict_phases = std::move(strict_phases);
+    g_warmup_frames = warmup_frames;
+}
+
+void AllocationTracker::begin_frame() {
+    StrictViolation violation;
+    {
+        std::lock_guard lock(g_mutex);
+        g_inside_tracker = true;
+        g_last_frame = g_current_frame;
+        g_current_frame = AllocationFrameStats{};
+        // Compact the hash table, so that the sites are contiguous and sorted.
+        auto sites = std::span(g_last_frame.site_storage);
+        auto used = std::partition(sites.begin(), sites.end(), [](const AllocationSite &site) {
+            return site.count > 0;
+        });
+        std::sort(sites.begin(), used, [](const AllocationSite &a, const AllocationSite &b) {
+            return a.bytes > b.bytes;
+        });
+        g_last_frame.site_count = used - sites.begin();
+        violation = g_violation;
+        g_violation = StrictViolation{};
+        ++g_frame;
+        g_inside_tracker = false;
+    }
+    if (violation.happened) {
+        RG_ENGINE_ERROR(EngineError::Type::SteadyStateAllocation,
+                        "Frame {} allocated {} bytes on the heap inside the strict phase scope '{}' '{}'.",
+                        violation.frame, violation.site.bytes, violation.site.name, violation.site.detail);
+    }
+}
+
+const AllocationFrameStats &AllocationTracker::last_frame() {
+    return g_last_frame;
+}
+
+AllocationScope AllocationTracker::enter_scope(std::string_view name, std::string_view detail) {
+    AllocationScope previous = g_scope;
+    bool strict = previous.strict || std::ranges::any_of(g_strict_phases, [&](const std::string &phase) {
+        return phase == name || phase == detail;
+    });
+    g_scope = AllocationScope{name, detail, strict};
+    return previous;
+}
+
+void AllocationTracker::exit_scope(const AllocationScope &previous) {
+    g_scope = previous;
+}
+
+void AllocationTracker::_record_allocation(size_t bytes) {
+    if (g_inside_tracker) {
+        return;
+    }
+    std::lock_guard lock(g_mutex);
+    ++g_current_frame.count;
+    g_current_frame.bytes += bytes;
+    auto &site = find_site(g_current_frame, g_scope);
+    ++site.count;
+    site.bytes += bytes;
+    if (g_scope.strict && g_frame > g_warmup_frames && !g_violation.happened) {
+        g_violation = StrictViolation{true, AllocationSite{g_scope.name, g_scope.detail, 1, bytes}, g_frame};
+    }
+}
+
+void AllocationTracker::_record_free() {
+    if (g_inside_tracker) {
+        return;
+    }
+    std::lock_guard lock(g_mutex);
+    ++g_current_frame.frees;
+}
+
+#else
+
+void AllocationTracker::configure(std::vector<std::string> strict_phases, uint32_t warmup_frames) {
+}
+
+void AllocationTracker::begin_frame() {
+}
+
+const AllocationFrameStats &AllocationTracker::last_frame() {
+    static const AllocationFrameStats empty{};
+    return empty;
+}
+
+AllocationScope AllocationTracker::enter_scope(std::string_view name, std::string_view detail) {
+    return AllocationScope{};
+}
+
+void AllocationTracker::exit_scope(const AllocationScope &previous) {
+}
+
+void AllocationTracker::_record_allocation(size_t bytes) {
+}
+
+void AllocationTracker::_record_free() {
+}
+
+#endif
+
+} // namespace engine::util
+
+#ifdef RG_TRACK_ALLOCATIONS
+
+static void *tracked_allocate(size_t bytes, size_t alignment = 0) {
+    engine::util::AllocationTracker::_record_allocation(bytes);
+    size_t size = bytes == 0 ? 1 : bytes;
+    void *pointer;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        pointer = std::malloc(size);
+    } else {
+#ifdef _WIN32
+        pointer = _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment.
+        pointer = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+    return pointer;
+}
+
+static void tracked_free(void *pointer, size_t alignment = 0) {
+    if (!pointer) {
+        return;
+    }
+    engine::util::AllocationTracker::_record_free();
+#ifdef _WIN32
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        _aligned_free(pointer);
+        return;
+    }
+#endif
+    std::free(pointer);
+}
+
+void *operator new(size_t bytes) {
+    if (void *pointer = tracked_allocate(bytes)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t bytes) {
+    return operator new(bytes);
+}
+
+void *operator new(size_t bytes, std::align_val_t alignment) {
+    if (void *pointer = tracked_allocate(bytes, static_cast<size_t>(alignment))) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t bytes, std::align_val_t alignment) {
+    return operator new(bytes, alignment);
+}
+
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes);
+}
+
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes);
+}
+
+void *operator new(size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t alignment) noexcept {
+    tracked_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment) noexcept {
+    tracked_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t alignment) noexcept {
+    tracked_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void *pointer, size_t, std::align_val_t alignment) noexcept {
+    tracked_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    tracked_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    tracked_free(pointer, static_cast<size_t>(alignment));
+}
+
+#endif
@@ -2,11 +2,17 @@
 #include <engine/core/App.hpp>
 #include <engine/platform/PlatformController.hpp>
 #include <engine/resources/ResourcesController.hpp>
+#include <engine/resources/HotReloadController.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
 #include <engine/util/Errors.hpp>
 
 #include <engine/util/ArgParser.hpp>
 #include <engine/util/Configuration.hpp>
 #include <engine/graphics/GraphicsController.hpp>
+#include <engine/util/AllocationTracker.hpp>
+#include <engine/util/FrameArena.hpp>
+#include <engine/util/Log.hpp>
+#include <engine/util/Profiler.hpp>
 #include <engine/util/Utils.hpp>
 
 namespace engine::core {
@@ -16,7 +22,11 @@ int App::run(int argc, char **argv) {
         app_setup();
         initialize();
         while (loop()) {
+            RG_PROFILE_SCOPE("Frame");
+            util::FrameArena::instance()->begin_frame();
+            util::AllocationTracker::begin_frame();
             poll_events();
+            fixed_update();
             update();
             draw();
         }
@@ -25,23 +35,49 @@ int App::run(int argc, char **argv) {
         handle_error(e);
         terminate();
     }
+    if (!m_profile_output.empty()) {
+        util::Profiler::export_chrome_trace(m_profile_output);
+    }
+    util::shutdown_logging();
     return on_exit();
 }
 
 void App::engine_setup(int argc, char **argv) {
     util::ArgParser::instance()->initialize(argc, argv);
     util::Configuration::instance()->initialize();
+    util::initialize_logging(util::Configuration::config().value("logging", util::Configuration::json::object()));
+    m_profile_output = util::ArgParser::instance()->arg<std::string>("--profile").value();
+    if (!m_profile_output.empty()) {
+        util::Profiler::set_thread_name("Main");
+        util::Profiler::set_enabled(true);
+    }
+    const auto &config = util::Configuration::config();
+    const auto engine_config = config.value("engine", util::Configuration::json::object());
+    util::FrameArena::instance()->initialize(
+            engine_config.value("frame_arena_size", util::FrameArena::DEFAULT_CAPACITY));
+    const auto allocation_config = engine_config.value("allocation_tracking", util::Configuration::json::object());
+    util::AllocationTracker::configure(allocation_config.value("strict_phases", std::vector<std::string>{}),
+                                       allocation_config.value("warmup_frames", 120u));
+    mount_resource_packs();
 
     // register engine controllers
+    auto jobs = register_controller<JobSystem>();
     auto begin = register_controller<EngineControllersBegin>();
     auto platform = register_controller<platform::PlatformController>();
     auto graphics = register_controller<graphics::GraphicsController>();
     auto resources = register_controller<resources::ResourcesController>();
     auto end = register_controller<EngineControllersEnd>();
+    jobs->before(begin);
     begin->before(platform);
     platform->before(graphics);
     graphics->before(resources);
     resources->before(end);
+
+    if (config.contains("resources") && config["resources"].value("hot_reload", false)) {
+        auto hot_reload = register_controller<resources::HotReloadController>();
+        resources->before(hot_reload);
+        hot_reload->before(end);
+    }
 }
 
 void App::initialize() {
@@ -56,8 +92,15 @@ void App::initialize() {
     }
     for (auto controller: m_controllers) {
         spdlog::info("{}::initialize", controller->name());
+        RG_PROFILE_SCOPE(controller->name(), "initialize");
         controller->initialize();
     }
+
+    const auto &config = util::Configuration::config();
+    if (config.contains("engine") && config["engine"].value("parallel_update", false)) {
+        m_scheduler = std::make_unique<ControllerScheduler>();
+        m_scheduler->initialize(m_controllers);
+    }
 }
 
 bool App::loop() {
@@ -70,46 +113,114 @@ bool App::loop() {
 }
 
 void App::poll_events() {
+    RG_PROFILE_SCOPE("App::poll_events");
     for (auto controller: m_controllers) {
         // We don't check if the controller is enabled for poll_events because the controller may enable itself in the poll_events if it needs to.
         // For example, a GUIController may enable itself in the poll_events method if a button to enable/disable the GUI was pressed.
+        RG_PROFILE_SCOPE(controller->name(), "poll_events");
         controller->poll_events();
     }
 }
 
+void App::fixed_update() {
+    RG_PROFILE_SCOPE("App::fixed_update");
+    uint32_t steps = Controller::get<platform::PlatformController>()->frame_time().fixed_steps;
+    for (uint32_t step = 0; step < steps; ++step) {
+        for (auto controller: m_controllers) {
+            if (controller->is_enabled()) {
+                RG_PROFILE_SCOPE(controller->name(), "fixed_update");
+                controller->fixed_update();
+            }
+        }
+    }
+}
+
 void App::update() {
+    RG_PROFILE_SCOPE("App::update");
+    if (m_scheduler) {
+        m_scheduler->update();
+        return;
+    }
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "update");
             controller->update();
         }
     }
 }
 
 void App::draw() {
+    RG_PROFILE_SCOPE("App::draw");
+    auto platform = Controller::get<platform::PlatformController>();
+    auto graphics = Controller::get<graphics::GraphicsController>();
+    if (!platform->is_redraw_needed()) {
+        // Nothing changed since the last drawn frame, which the window still shows.
+        if (platform->is_present_needed()) {
+            graphics->present_last_frame();
+        }
+        graphics->submit_frame();
+        return;
+    }
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "begin_draw");
             controller->begin_draw();
         }
     }
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "draw");
             controller->draw();
         }
     }
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "end_draw");
             controller->end_draw();
         }
     }
+    graphics->submit_frame();
+}
+
+void App::mount_resource_packs() {
+    const auto resources_config = util::Configuration::config()
+            .value("resources", util::Configuration::json::object());
+    const auto packs = resources_config.value("packs", std::vector<std::string>{});
+    if (packs.empty()) {
+        return;
+    }
+    // The hot reload watches the files on the disk, the packs would hide the edits.
+    if (resources_config.value("hot_reload", false)) {
+        spdlog::info("[App]: hot reload is enabled, the resource packs aren't mounted");
+        return;
+    }
+    auto file_system = resources::VirtualFileSystem::instance();
+    for (const auto &pack: packs) {
+        if (!std::filesystem::exists(pack)) {
+            spdlog::info("[App]: resource pack {} not found, the resources are read from the disk", pack);
+            continue;
+        }
+        file_system->mount(pack);
+    }
 }
 
 void App::terminate() {
+    m_scheduler.reset();
+    // Controllers release their OpenGL objects in terminate, so the render thread has to give the context back first.
+    auto graphics = Controller::create_if_absent<graphics::GraphicsController>();
+    if (graphics->is_registered()) {
+        graphics->stop_render_thread();
+    }
     // We terminate controllers in reverse order of their registration to ensure that controllers that depend on other controllers are terminated last.
     for (auto it = m_controllers.rbegin(); it != m_controllers.rend(); ++it) {
         auto controller = *it;
+        RG_PROFILE_SCOPE(controller->name(), "terminate");
         controller->terminate();
         spdlog::info("{}::terminate", controller->name());
     }
+    auto arena = util::FrameArena::instance()->stats();
+    spdlog::info("FrameArena: peak {} bytes per frame, {} bytes per frame buffer, {} frames overflowed.",
+                 arena.peak_frame_bytes, arena.capacity_bytes, arena.overflow_frames);
 }
 
 void App::app_setup() {
@@ -0,0 +1,202 @@
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/scene.h>
+#include <engine/resources/AssimpSceneProcessor.hpp>
+#include <engine/resources/ResourcesController.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
+#include <engine/util/Errors.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace engine::resources {
+
+/**
+ * @class VfsIOStream
+ * @brief Read-only Assimp stream over the @ref FileContents of a file.
+ */
+class VfsIOStream final : public Assimp::IOStream {
+public:
+    explicit VfsIOStream(FileContents contents) : m_contents(std::move(contents)) {
+    }
+
+    size_t Read(void *buffer, size_t size, size_t count) override {
+        if (size == 0) {
+            return 0;
+        }
+        count = std::min(count, (m_contents.size() - m_position) / size);
+        std::memcpy(buffer, m_contents.bytes()
+                                      .data() + m_position, size * count);
+        m_position += size * count;
+        return count;
+    }
+
+    size_t Write(const void *, size_t, size_t) override {
+        return 0;
+    }
+
+    aiReturn Seek(size_t offset, aiOrigin origin) override {
+        size_t base = origin == aiOrigin_SET ? 0 : origin == aiOrigin_CUR ? m_position : m_contents.size();
+        if (offset > m_contents.size() - base) {
+            return aiReturn_FAILURE;
+        }
+        m_position = base + offset;
+        return aiReturn_SUCCESS;
+    }
+
+    size_t Tell() const override {
+        return m_position;
+    }
+
+    size_t FileSize() const override {
+        return m_contents.size();
+    }
+
+    void Flush() override {
+    }
+
+private:
+    FileContents m_contents;
+    size_t m_position{0};
+};
+
+/**
+ * @class VfsIOSystem
+ * @brief Opens the files Assimp asks for through the @ref VirtualFileSystem.
+ */
+class VfsIOSystem final : public Assimp::IOSystem {
+public:
+    bool Exists(const char *file) const override {
+        auto file_system = VirtualFileSystem::instance();
+        return file_system->exists(file) && !file_system->is_directory(file);
+    }
+
+    char getOsSeparator() const override {
+        return '/';
+    }
+
+    Assimp::IOStream *Open(const char *file, const char *mode) override {
+        // Models are only read, a write would go around the packs.
+        if (std::strchr(mode, 'w') || std::strchr(mode, 'a') || !Exists(file)) {
+            return nullptr;
+        }
+        return new VfsIOStream(VirtualFileSystem::instance()->read(file));
+    }
+
+    void Close(Assimp::IOStream *stream) override {
+        delete stream;
+    }
+};
+
+Assimp::IOSystem *create_assimp_io_system() {
+    return new VfsIOSystem();
+}
+
+static TextureType assimp_texture_type_to_engine(aiTextureType type) {
+    switch (type) {
+        case aiTextureType_DIFFUSE: return TextureType::Diffuse;
+        case aiTextureType_SPECULAR: return TextureType::Specular;
+        case aiTextureType_HEIGHT: return TextureType::Height;
+        case aiTextureType_NORMALS: return TextureType::Normal;
+        default: RG_SHOULD_NOT_REACH_HERE("Engine currently doesn't support the aiTextureType: {}",
+                                          static_cast<int>(type));
+    }
+}
+
+std::vector<Mesh> AssimpSceneProcessor::process_meshes() {
+    m_meshes.clear();
+    process_node(m_scene->mRootNode);
+    return std::move(m_meshes);
+}
+
+void AssimpSceneProcessor::process_node(const aiNode *node) {
+    for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
+        auto mesh = m_scene->mMeshes[node->mMeshes[i]];
+        process_mesh(mesh);
+    }
+    for (uint32_t i = 0; i < node->mNumChildren; ++i) {
+        process_node(node->mChildren[i]);
+    }
+}
+
+void AssimpSceneProcessor::process_mesh(aiMesh *mesh) {
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        Vertex vertex{};
+        vertex.Position
+              .x = mesh->mVertices[i].x;
+        vertex.Position
+              .y = mesh->mVertices[i].y;
+        vertex.Position
+              .z = mesh->mVertices[i].z;
+
+        if (mesh->HasNormals()) {
+            vertex.Normal
+                  .x = mesh->mNormals[i].x;
+            vertex.Normal
+                  .y = mesh->mNormals[i].y;
+            vertex.Normal
+                  .z = mesh->mNormals[i].z;
+        }
+
+        if (mesh->mTextureCoords[0]) {
+            vertex.TexCoords
+                  .x = mesh->mTextureCoords[0][i].x;
+            vertex.TexCoords
+                  .y = mesh->mTextureCoords[0][i].y;
+
+            vertex.Tangent
+                  .x = mesh->mTangents[i].x;
+            vertex.Tangent
+                  .y = mesh->mTangents[i].y;
+            vertex.Tangent
+                  .z = mesh->mTangents[i].z;
+
+            vertex.Bitangent
+                  .x = mesh->mBitangents[i].x;
+            vertex.Bitangent
+                  .y = mesh->mBitangents[i].y;
+            vertex.Bitangent
+                  .z = mesh->mBitangents[i].z;
+        }
+        vertices.push_back(vertex);
+    }
+
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
+        aiFace face = mesh->mFaces[i];
+
+        for (uint32_t j = 0; j < face.mNumIndices; ++j) {
+            indices.push_back(face.mIndices[j]);
+        }
+    }
+
+    auto material = m_scene->mMaterials[mesh->mMaterialIndex];
+    std::vector<Texture *> textures = process_materials(material);
+    m_meshes.emplace_back(Mesh(vertices, indices, std::move(textures)));
+}
+
+std::vector<Texture *> AssimpSceneProcessor::process_materials(const aiMaterial *material) {
+    std::vector<Texture *> textures;
+    auto ai_texture_types = {
+            aiTextureType_DIFFUSE,
+            aiTextureType_SPECULAR,
+            aiTextureType_NORMALS,
+            aiTextureType_HEIGHT,
+    };
+
+    for (auto ai_texture_type: ai_texture_types) {
+        auto material_count = material->GetTextureCount(ai_texture_type);
+        for (uint32_t i = 0; i < material_count; ++i) {
+            aiString ai_texture_path_string;
+            material->GetTexture(ai_texture_type, i, &ai_texture_path_string);
+            std::filesystem::path texture_path = m_model_path.parent_path() / ai_texture_path_string.C_Str();
+            Texture *texture = m_resources_controller->texture(texture_path.string(), texture_path,
+                                                               assimp_texture_type_to_engine(ai_texture_type));
+            textures.emplace_back(texture);
+        }
+    }
+    return textures;
+}
+
+} // namespace engine::resources
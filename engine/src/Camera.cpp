@@ -13,8 +13,30 @@ Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch) :
 }
 
 // returns the view matrix calculated using Euler Angles and the LookAt Matrix
-glm::mat4 Camera::view_matrix() const {
-    return glm::lookAt(Position, Position + Front, Up);
+const glm::mat4 &Camera::view_matrix() const {
+    update_view();
+    return m_view;
+}
+
+const glm::mat4 &Camera::inverse_view_matrix() const {
+    update_view();
+    return m_inverse_view;
+}
+
+void Camera::update_view() const {
+    if (m_view_version != 0 && Position == m_view_position && Front == m_view_front && Up == m_view_up) {
+        return;
+    }
+    m_view_position = Position;
+    m_view_front = Front;
+    m_view_up = Up;
+    m_view = glm::lookAt(Position, Position + Front, Up);
+    // The view is a rotation and a translation, so the inverse is built from the axes of the lookAt directly.
+    glm::vec3 f = glm::normalize(Front);
+    glm::vec3 s = glm::normalize(glm::cross(f, Up));
+    glm::vec3 u = glm::cross(s, f);
+    m_inverse_view = glm::mat4(glm::vec4(s, 0.0f), glm::vec4(u, 0.0f), glm::vec4(-f, 0.0f), glm::vec4(Position, 1.0f));
+    ++m_view_version;
 }
 
 // processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
@@ -0,0 +1,247 @@
+#include <glad/glad.h>
+#include <engine/graphics/CommandList.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/Shader.hpp>
+#include <engine/util/Errors.hpp>
+#include <array>
+
+namespace engine::graphics {
+
+struct BindProgramCommand {
+    const resources::Shader *shader;
+};
+
+struct BindMeshCommand {
+    uint32_t vertex_array;
+    uint32_t index_count;
+};
+
+struct BindTextureCommand {
+    uint32_t unit;
+    uint32_t target;
+    uint32_t texture;
+};
+
+/**
+* @brief Followed by the value, and the null-terminated uniform name.
+*/
+struct SetUniformCommand {
+    UniformType type;
+    uint8_t value_size;
+    uint8_t name_length;
+    uint8_t reserved;
+};
+
+struct BindUniformBufferRangeCommand {
+    uint32_t binding;
+    uint32_t buffer;
+    int64_t offset;
+    int64_t size;
+};
+
+struct DrawCommand {
+    uint32_t index_count;
+    uint32_t first_index;
+    uint32_t instance_count;
+};
+
+void CommandList::bind_program(const resources::Shader *shader) {
+    if (shader == m_shader) {
+        return;
+    }
+    m_shader = shader;
+    push(CommandType::BindProgram, BindProgramCommand{shader});
+}
+
+void CommandList::bind_mesh(uint32_t vertex_array, uint32_t index_count) {
+    push(CommandType::BindMesh, BindMeshCommand{vertex_array, index_count});
+}
+
+void CommandList::bind_texture(uint32_t unit, uint32_t target, uint32_t texture) {
+    push(CommandType::BindTexture, BindTextureCommand{unit, target, texture});
+}
+
+void CommandList::push_uniform(std::string_view name, UniformType type, const void *value, size_t value_size) {
+    RG_GUARANTEE(name.size() <= UINT8_MAX, "Uniform name {} is longer than {} characters.", name, UINT8_MAX);
+    std::array<char, sizeof(glm::mat4) + UINT8_MAX + 1> extra;
+    std::memcpy(extra.data(), value, value_size);
+    std::memcpy(extra.data() + value_size, name.data(), name.size());
+    extra[value_size + name.size()] = '\0';
+    push(CommandType::SetUniform, SetUniformCommand{type, static_cast<uint8_t>(value_size),
+                                                    static_cast<uint8_t>(name.size()), 0},
+         std::span<const char>(extra.data(), value_size + name.size() + 1));
+}
+
+void CommandList::set_uniform(std::string_view name, int value) {
+    push_uniform(name, UniformType::Int, &value, sizeof(value));
+}
+
+void CommandList::set_uniform(std::string_view name, float value) {
+    push_uniform(name, UniformType::Float, &value, sizeof(value));
+}
+
+void CommandList::set_uniform(std::string_view name, const glm::vec2 &value) {
+    push_uniform(name, UniformType::Vec2, &value, sizeof(value));
+}
+
+void CommandList::set_uniform(std::string_view name, const glm::vec3 &value) {
+    push_uniform(name, UniformType::Vec3, &value, sizeof(value));
+}
+
+void CommandList::set_uniform(std::string_view name, const glm::vec4 &value) {
+    push_uniform(name, UniformType::Vec4, &value, sizeof(value));
+}
+
+void CommandList::set_uniform(std::string_view name, const glm::mat3 &value) {
+    push_uniform(name, UniformType::Mat3, &value, sizeof(value));
+}
+
+void CommandList::set_uniform(std::string_view name, const glm::mat4 &value) {
+    push_uniform(name, UniformType::Mat4, &value, sizeof(value));
+}
+
+void CommandList::bind_uniform_buffer_range(uint32_t binding, uint32_t buffer, int64_t offset, int64_t size) {
+    push(CommandType::BindUniformBufferRange, BindUniformBufferRangeCommand{binding, buffer, offset, size});
+}
+
+void CommandList::draw(uint32_t index_count, uint32_t first_index) {
+    push(CommandType::Draw, DrawCommand{index_count, first_index, 1});
+}
+
+void CommandList::draw_instanced(uint32_t instance_count, uint32_t index_count, uint32_t first_index) {
+    push(CommandType::DrawInstanced, DrawCommand{index_count, first_index, instance_count});
+}
+
+void CommandList::append(const CommandList &other) {
+    m_data.insert(m_data.end(), other.m_data
+                                     .begin(), other.m_data
+                                                    .end());
+    m_command_count += other.m_command_count;
+    if (other.m_shader) {
+        m_shader = other.m_shader;
+    }
+}
+
+void CommandList::replay() const {
+    ReplayState state;
+    replay(*this, state);
+    finish_replay(state);
+}
+
+void CommandList::replay(std::span<const CommandList> lists) {
+    ReplayState state;
+    for (const auto &list: lists) {
+        replay(list, state);
+    }
+    finish_replay(state);
+}
+
+/**
+* @brief Reads the parameters of the command at the `data`, the header is skipped.
+*/
+template<typename Parameters>
+static Parameters read_parameters(const std::byte *data, size_t header_size) {
+    Parameters parameters;
+    std::memcpy(&parameters, data + header_size, sizeof(Parameters));
+    return parameters;
+}
+
+static void apply_uniform(uint32_t program, const SetUniformCommand &command, const std::byte *value, const char *name) {
+    int32_t location = CHECKED_GL_CALL(glGetUniformLocation, program, name);
+    std::array<float, 16> floats{};
+    std::memcpy(floats.data(), value, command.value_size);
+    switch (command.type) {
+        case UniformType::Int: {
+            int32_t integer;
+            std::memcpy(&integer, value, sizeof(integer));
+            CHECKED_GL_CALL(glUniform1i, location, integer);
+            break;
+        }
+        case UniformType::Float: CHECKED_GL_CALL(glUniform1f, location, floats[0]);
+            break;
+        case UniformType::Vec2: CHECKED_GL_CALL(glUniform2fv, location, 1, floats.data());
+            break;
+        case UniformType::Vec3: CHECKED_GL_CALL(glUniform3fv, location, 1, floats.data());
+            break;
+        case UniformType::Vec4: CHECKED_GL_CALL(glUniform4fv, location, 1, floats.data());
+            break;
+        case UniformType::Mat3: CHECKED_GL_CALL(glUniformMatrix3fv, location, 1, GL_FALSE, floats.data());
+            break;
+        case UniformType::Mat4: CHECKED_GL_CALL(glUniformMatrix4fv, location, 1, GL_FALSE, floats.data());
+            break;
+        default: RG_SHOULD_NOT_REACH_HERE("Unhandled uniform type {}.", static_cast<int>(command.type));
+    }
+}
+
+void CommandList::replay(const CommandList &list, ReplayState &state) {
+    const std::byte *data = list.m_data.data();
+    const std::byte *end = data + list.m_data.size();
+    while (data < end) {
+        CommandHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        switch (header.type) {
+            case CommandType::BindProgram: {
+                auto command = read_parameters<BindProgramCommand>(data, sizeof(header));
+                if (command.shader != state.shader) {
+                    // Waits for a batch-compiled shader and throws if it failed, instead of drawing with a broken program.
+                    command.shader->use();
+                    state.shader = command.shader;
+                    state.program = command.shader->id();
+                }
+                break;
+            }
+            case CommandType::BindMesh: {
+                auto command = read_parameters<BindMeshCommand>(data, sizeof(header));
+                if (command.vertex_array != state.vertex_array) {
+                    CHECKED_GL_CALL(glBindVertexArray, command.vertex_array);
+                    state.vertex_array = command.vertex_array;
+                }
+                state.index_count = command.index_count;
+                break;
+            }
+            case CommandType::BindTexture: {
+                auto command = read_parameters<BindTextureCommand>(data, sizeof(header));
+                CHECKED_GL_CALL(glActiveTexture, GL_TEXTURE0 + command.unit);
+                CHECKED_GL_CALL(glBindTexture, command.target, command.texture);
+                break;
+            }
+            case CommandType::SetUniform: {
+                auto command = read_parameters<SetUniformCommand>(data, sizeof(header));
+                const std::byte *value = data + sizeof(header) + sizeof(SetUniformCommand);
+                apply_uniform(state.program, command, value, reinterpret_cast<const char *>(value + command.value_size));
+                break;
+            }
+            case CommandType::BindUniformBufferRange: {
+                auto command = read_parameters<BindUniformBufferRangeCommand>(data, sizeof(header));
+                CHECKED_GL_CALL(glBindBufferRange, GL_UNIFORM_BUFFER, command.binding, command.buffer,
+                                static_cast<GLintptr>(command.offset), static_cast<GLsizeiptr>(command.size));
+                break;
+            }
+            case CommandType::Draw:
+            case CommandType::DrawInstanced: {
+                auto command = read_parameters<DrawCommand>(data, sizeof(header));
+                auto count = static_cast<GLsizei>(command.index_count ? command.index_count : state.index_count);
+                auto offset = reinterpret_cast<const void *>(static_cast<uintptr_t>(command.first_index) *
+                                                             sizeof(uint32_t));
+                if (header.type == CommandType::Draw) {
+                    CHECKED_GL_CALL(glDrawElements, GL_TRIANGLES, count, GL_UNSIGNED_INT, offset);
+                } else {
+                    CHECKED_GL_CALL(glDrawElementsInstanced, GL_TRIANGLES, count, GL_UNSIGNED_INT, offset,
+                                    static_cast<GLsizei>(command.instance_count));
+                }
+                break;
+            }
+            default: RG_SHOULD_NOT_REACH_HERE("Unhandled command type {}.", static_cast<int>(header.type));
+        }
+        data += header.size;
+    }
+}
+
+void CommandList::finish_replay(ReplayState &state) {
+    if (state.vertex_array != 0) {
+        // Leave no vertex array bound, like the Mesh::draw, so that later draws don't modify it by accident.
+        CHECKED_GL_CALL(glBindVertexArray, 0);
+    }
+}
+
+} // namespace engine::graphics
@@ -0,0 +1,84 @@
+#include <engine/core/ControllerScheduler.hpp>
+#include <engine/core/Controller.hpp>
+#include <engine/util/Profiler.hpp>
+#include <spdlog/spdlog.h>
+#include <unordered_map>
+
+namespace engine::core {
+
+void ControllerScheduler::initialize(std::span<Controller *const> controllers) {
+    m_jobs = Controller::get<JobSystem>();
+    std::unordered_map<Controller *, uint32_t> index;
+    for (auto controller: controllers) {
+        index.emplace(controller, static_cast<uint32_t>(m_tasks.size()));
+        m_tasks.push_back(Task{
+                .controller = controller,
+                .remaining_predecessors = std::make_unique<std::atomic<uint32_t> >(0),
+                .main_thread = !controller->is_thread_safe()});
+    }
+    for (auto &task: m_tasks) {
+        for (auto next: task.controller->next()) {
+            uint32_t next_index = index.at(next);
+            task.next.push_back(next_index);
+            ++m_tasks[next_index].predecessor_count;
+        }
+    }
+    spdlog::info("ControllerScheduler: updating {} controllers on {} worker threads", m_tasks.size(),
+                 m_jobs->worker_count());
+}
+
+void ControllerScheduler::update() {
+    m_error = nullptr;
+    for (auto &task: m_tasks) {
+        task.remaining_predecessors->store(task.predecessor_count, std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < m_tasks.size(); ++i) {
+        if (m_tasks[i].predecessor_count == 0) {
+            schedule(i);
+        }
+    }
+    // The main thread runs the controllers bound to it, and helps the workers in between.
+    m_jobs->wait(m_counter);
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void ControllerScheduler::run(uint32_t task) {
+    Controller *controller = m_tasks[task].controller;
+    bool failed;
+    {
+        std::lock_guard lock(m_error_mutex);
+        failed = m_error != nullptr;
+    }
+    if (!failed && controller->is_enabled()) {
+        try {
+            RG_PROFILE_SCOPE(controller->name(), "update");
+            controller->update();
+        } catch (...) {
+            std::lock_guard lock(m_error_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+    // Successors are scheduled before this job finishes, so the counter can't reach zero too early.
+    for (uint32_t next: m_tasks[task].next) {
+        if (m_tasks[next].remaining_predecessors->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(next);
+        }
+    }
+}
+
+void ControllerScheduler::schedule(uint32_t task) {
+    auto job = [this, task] {
+        run(task);
+    };
+    if (m_tasks[task].main_thread) {
+        m_jobs->run_on_main_thread(std::move(job), &m_counter);
+    } else {
+        m_jobs->run(std::move(job), &m_counter);
+    }
+}
+
+} // namespace engine::core
@@ -18,6 +18,7 @@ std::string_view EngineError::type_string(Type error) {
         case Type::ShaderCompilationError: return "ShaderCompilationError";
         case Type::OpenGLError: return "OpenGLError";
         case Type::AssetLoadingError: return "AssetLoadingError";
+        case Type::SteadyStateAllocation: return "SteadyStateAllocation";
         default: return "Unknown";
     }
 }
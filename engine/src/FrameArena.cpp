@@ -0,0 +1,85 @@
+#include <engine/util/FrameArena.hpp>
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <spdlog/spdlog.h>
+
+namespace engine::util {
+
+FrameArena *FrameArena::instance() {
+    static FrameArena arena;
+    return &arena;
+}
+
+void FrameArena::initialize(size_t capacity) {
+    for (auto &buffer: m_buffers) {
+        reset(buffer);
+        buffer.memory = std::make_unique<std::byte[]>(capacity);
+        buffer.capacity = capacity;
+    }
+    m_current = 0;
+}
+
+void FrameArena::begin_frame() {
+    Buffer &finished = m_buffers[m_current];
+    size_t frame_bytes = std::min(finished.offset.load(std::memory_order_relaxed), finished.capacity) +
+                         finished.overflow_bytes;
+    m_last_frame_bytes = frame_bytes;
+    m_peak_frame_bytes = std::max(m_peak_frame_bytes, frame_bytes);
+    if (finished.overflow_bytes > 0) {
+        ++m_overflow_frames;
+    }
+
+    m_current = (m_current + 1) % FRAMES_IN_FLIGHT;
+    reset(m_buffers[m_current]);
+}
+
+void FrameArena::reset(Buffer &buffer) {
+    for (auto [pointer, alignment]: buffer.overflow) {
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+    buffer.overflow.clear();
+    if (buffer.overflow_bytes > 0) {
+        // Grow to fit the whole frame, so the next frames like it don't fall back to the heap.
+        size_t capacity = std::bit_ceil(buffer.capacity + buffer.overflow_bytes);
+        spdlog::info("FrameArena: growing a frame buffer from {} to {} bytes.", buffer.capacity, capacity);
+        buffer.memory = std::make_unique<std::byte[]>(capacity);
+        buffer.capacity = capacity;
+        buffer.overflow_bytes = 0;
+    }
+    buffer.offset.store(0, std::memory_order_relaxed);
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    Buffer &buffer = m_buffers[m_current];
+    auto base = reinterpret_cast<uintptr_t>(buffer.memory.get());
+    size_t offset = buffer.offset.load(std::memory_order_relaxed);
+    size_t begin, end;
+    do {
+        begin = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+        end = begin + bytes;
+        if (end > buffer.capacity) {
+            return allocate_overflow(buffer, bytes, alignment);
+        }
+    } while (!buffer.offset.compare_exchange_weak(offset, end, std::memory_order_relaxed));
+    return buffer.memory.get() + begin;
+}
+
+void *FrameArena::allocate_overflow(Buffer &buffer, size_t bytes, size_t alignment) {
+    void *pointer = ::operator new(bytes, std::align_val_t(alignment));
+    std::lock_guard lock(m_overflow_mutex);
+    buffer.overflow.emplace_back(pointer, alignment);
+    buffer.overflow_bytes += bytes;
+    return pointer;
+}
+
+FrameArenaStats FrameArena::stats() const {
+    return FrameArenaStats{
+            .last_frame_bytes = m_last_frame_bytes,
+            .peak_frame_bytes = m_peak_frame_bytes,
+            .capacity_bytes = m_buffers[m_current].capacity,
+            .overflow_frames = m_overflow_frames,
+    };
+}
+
+} // namespace engine::util
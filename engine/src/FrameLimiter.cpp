@@ -0,0 +1,40 @@
+#include <engine/platform/FrameLimiter.hpp>
+#include <algorithm>
+#include <thread>
+
+namespace engine::platform {
+
+void FrameLimiter::set_target_fps(double fps) {
+    m_target_fps = std::max(fps, 0.0);
+    m_frame_duration = m_target_fps > 0.0
+                           ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_target_fps))
+                           : Clock::duration::zero();
+    m_next_frame = Clock::now();
+}
+
+void FrameLimiter::wait() {
+    if (m_target_fps <= 0.0) {
+        return;
+    }
+    auto now = Clock::now();
+    if (m_next_frame - now > m_sleep_margin) {
+        auto wake_up = m_next_frame - m_sleep_margin;
+        std::this_thread::sleep_until(wake_up);
+        // Track the worst recent oversleep, and slowly shrink the margin back when the OS wakes up on time.
+        auto oversleep = Clock::now() - wake_up;
+        m_sleep_margin = std::clamp<Clock::duration>(std::max(oversleep + oversleep / 4, m_sleep_margin * 31 / 32),
+                                                     std::chrono::microseconds(200), MAX_SLEEP_MARGIN);
+    }
+    while (Clock::now() < m_next_frame) {
+        std::this_thread::yield();
+    }
+
+    now = Clock::now();
+    m_next_frame += m_frame_duration;
+    // After a long frame start over instead of running several frames back to back to catch up.
+    if (m_next_frame < now) {
+        m_next_frame = now + m_frame_duration;
+    }
+}
+
+} // namespace engine::platform
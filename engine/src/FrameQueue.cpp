@@ -0,0 +1,102 @@
+#include <glad/glad.h>
+#include <engine/graphics/FrameQueue.hpp>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <span>
+
+namespace engine::graphics {
+
+static int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+                                                                        .time_since_epoch()).count();
+}
+
+void FrameQueue::initialize(uint32_t max_frames_in_flight) {
+    m_max_frames_in_flight = std::min(max_frames_in_flight, MAX_FRAMES_IN_FLIGHT);
+    for (auto &slot: m_slots) {
+        glGenQueries(1, &slot.query);
+    }
+}
+
+void FrameQueue::terminate() {
+    for (auto &slot: m_slots) {
+        if (slot.fence) {
+            glDeleteSync(static_cast<GLsync>(slot.fence));
+            slot.fence = nullptr;
+        }
+        if (slot.query) {
+            glDeleteQueries(1, &slot.query);
+            slot.query = 0;
+        }
+    }
+}
+
+void FrameQueue::begin_frame() {
+    // Timestamps are in GPU time, the offset converts them to the steady_clock the input is sampled with.
+    GLint64 gpu_now = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+    int64_t gpu_to_cpu_ns = steady_now_ns() - gpu_now;
+
+    m_stats.wait_ms = 0.0;
+    if (m_max_frames_in_flight > 0 && m_frame >= m_max_frames_in_flight) {
+        // The fence of the frame N back marks the end of the frame before it, so at most N frames stay unfinished.
+        uint64_t frame = m_frame - m_max_frames_in_flight;
+        Slot &slot = m_slots[frame % RING_SIZE];
+        if (frame >= m_oldest_pending && slot.fence) {
+            int64_t wait_begin = steady_now_ns();
+            auto fence = static_cast<GLsync>(slot.fence);
+            GLenum status;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100'000'000);
+            } while (status == GL_TIMEOUT_EXPIRED);
+            m_stats.wait_ms = static_cast<double>(steady_now_ns() - wait_begin) / 1e6;
+        }
+    }
+    collect_finished(gpu_to_cpu_ns);
+
+    if (m_frame - m_oldest_pending >= RING_SIZE) {
+        // Without a limit the GPU can fall behind by more frames than the ring holds, the oldest sample is dropped.
+        Slot &oldest = m_slots[m_oldest_pending % RING_SIZE];
+        glDeleteSync(static_cast<GLsync>(oldest.fence));
+        oldest.fence = nullptr;
+        ++m_oldest_pending;
+    }
+    Slot &slot = m_slots[m_frame % RING_SIZE];
+    // The query goes before the fence, so a signaled fence means the timestamp is available.
+    glQueryCounter(slot.query, GL_TIMESTAMP);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.input_sample_ns = m_input_sample_ns;
+    ++m_frame;
+    m_stats.frames_in_flight = static_cast<uint32_t>(m_frame - m_oldest_pending);
+}
+
+void FrameQueue::collect_finished(int64_t gpu_to_cpu_ns) {
+    while (m_oldest_pending < m_frame) {
+        Slot &slot = m_slots[m_oldest_pending % RING_SIZE];
+        auto fence = static_cast<GLsync>(slot.fence);
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        GLint64 gpu_finished = 0;
+        glGetQueryObjecti64v(slot.query, GL_QUERY_RESULT, &gpu_finished);
+        if (slot.input_sample_ns > 0) {
+            add_latency_sample(static_cast<double>(gpu_finished + gpu_to_cpu_ns - slot.input_sample_ns) / 1e6);
+        }
+        glDeleteSync(fence);
+        slot.fence = nullptr;
+        ++m_oldest_pending;
+    }
+}
+
+void FrameQueue::add_latency_sample(double latency_ms) {
+    m_latency_samples[m_latency_sample_count % LATENCY_WINDOW] = latency_ms;
+    ++m_latency_sample_count;
+    auto samples = std::span(m_latency_samples).first(std::min(m_latency_sample_count, LATENCY_WINDOW));
+    m_stats.last_ms = latency_ms;
+    m_stats.average_ms = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    m_stats.max_ms = *std::ranges::max_element(samples);
+}
+
+} // namespace engine::graphics
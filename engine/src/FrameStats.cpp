@@ -0,0 +1,72 @@
+#include <engine/platform/FrameStats.hpp>
+#include <cmath>
+#include <numeric>
+
+namespace engine::platform {
+
+void FrameStats::configure(double hitch_factor, double hitch_min_ms) {
+    m_hitch_factor = hitch_factor;
+    m_hitch_min_ns = static_cast<int64_t>(hitch_min_ms * 1e6);
+}
+
+void FrameStats::add_frame(int64_t duration_ns, int64_t time_ns) {
+    m_frames[m_frame_count % WINDOW] = duration_ns;
+    ++m_frame_count;
+
+    auto bucket = static_cast<uint64_t>(static_cast<double>(duration_ns) / (HISTOGRAM_BUCKET_MS * 1e6));
+    ++m_histogram[std::min<uint64_t>(bucket, HISTOGRAM_BUCKETS - 1)];
+
+    if (m_frame_count % MEDIAN_INTERVAL == 0 || m_median_ns == 0) {
+        auto sorted = sorted_window();
+        auto middle = sorted.begin() + sorted.size() / 2;
+        std::nth_element(sorted.begin(), middle, sorted.end());
+        m_median_ns = *middle;
+    }
+    // The first frames of the window are too few to tell what a normal frame is.
+    if (m_frame_count > MEDIAN_INTERVAL && duration_ns > m_hitch_min_ns &&
+        static_cast<double>(duration_ns) > m_hitch_factor * static_cast<double>(m_median_ns)) {
+        Hitch hitch{m_frame_count - 1, time_ns, duration_ns, m_median_ns};
+        if (m_hitch_count < MAX_HITCHES) {
+            m_hitches[m_hitch_count] = hitch;
+        } else {
+            std::shift_left(m_hitches.begin(), m_hitches.end(), 1);
+            m_hitches.back() = hitch;
+        }
+        ++m_hitch_count;
+    }
+}
+
+std::span<int64_t> FrameStats::sorted_window() const {
+    auto count = static_cast<size_t>(std::min<uint64_t>(m_frame_count, WINDOW));
+    std::copy_n(m_frames.begin(), count, m_sorted.begin());
+    return std::span(m_sorted).first(count);
+}
+
+FrameTimeSummary FrameStats::summary() const {
+    auto frames = sorted_window();
+    if (frames.empty()) {
+        return FrameTimeSummary{};
+    }
+    std::sort(frames.begin(), frames.end());
+    auto percentile = [&](double p) {
+        auto index = static_cast<size_t>(std::ceil(p * static_cast<double>(frames.size()))) - 1;
+        return static_cast<double>(frames[std::min(index, frames.size() - 1)]) / 1e6;
+    };
+    double count = static_cast<double>(frames.size());
+    double sum = std::accumulate(frames.begin(), frames.end(), 0.0);
+    double average = sum / count;
+    double variance = std::accumulate(frames.begin(), frames.end(), 0.0, [average](double total, int64_t frame) {
+        double difference = static_cast<double>(frame) - average;
+        return total + difference * difference;
+    }) / count;
+    return FrameTimeSummary{
+            .p50_ms = percentile(0.50),
+            .p95_ms = percentile(0.95),
+            .p99_ms = percentile(0.99),
+            .average_ms = average / 1e6,
+            .max_ms = static_cast<double>(frames.back()) / 1e6,
+            .jitter_ms = std::sqrt(variance) / 1e6,
+    };
+}
+
+} // namespace engine::platform
@@ -0,0 +1,54 @@
+#include <engine/graphics/Frustum.hpp>
+
+namespace engine::graphics {
+
+Frustum Frustum::from_matrix(const glm::mat4 &view_projection) {
+    // glm matrices are column-major, a row of the matrix is the i-th component of every column.
+    auto row = [&](int i) {
+        return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    };
+    glm::vec4 x = row(0);
+    glm::vec4 y = row(1);
+    glm::vec4 z = row(2);
+    glm::vec4 w = row(3);
+
+    Frustum frustum;
+    frustum.planes[Left] = w + x;
+    frustum.planes[Right] = w - x;
+    frustum.planes[Bottom] = w + y;
+    frustum.planes[Top] = w - y;
+    frustum.planes[Near] = w + z;
+    frustum.planes[Far] = w - z;
+    for (auto &plane: frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::contains(const glm::vec3 &point) const {
+    return intersects_sphere(point, 0.0f);
+}
+
+bool Frustum::intersects_sphere(const glm::vec3 &center, float radius) const {
+    for (const auto &plane: planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersects_box(const glm::vec3 &min, const glm::vec3 &max) const {
+    for (const auto &plane: planes) {
+        // The corner of the box furthest along the plane normal is the last one to leave the volume.
+        glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x,
+                         plane.y >= 0.0f ? max.y : min.y,
+                         plane.z >= 0.0f ? max.z : min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace engine::graphics
@@ -0,0 +1,41 @@
+#include <engine/resources/GpuResource.hpp>
+#include <atomic>
+
+namespace engine::resources {
+static std::atomic<uint64_t> g_frame{1};
+static std::atomic<bool> g_restore_requested{false};
+
+void GpuResource::mark_used() const {
+    // The meshes record their draws on the worker threads, so the resources are marked concurrently.
+    std::atomic_ref(m_last_used_frame).store(g_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    if (!is_resident()) {
+        std::atomic_ref(m_restore_requested).store(true, std::memory_order_relaxed);
+        g_restore_requested.store(true, std::memory_order_relaxed);
+    }
+}
+
+uint64_t GpuResource::current_frame() {
+    return g_frame.load(std::memory_order_relaxed);
+}
+
+void GpuResource::begin_frame() {
+    g_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool GpuResource::take_restore_requests() {
+    return g_restore_requested.exchange(false, std::memory_order_acq_rel);
+}
+
+uint64_t GpuResource::last_used_frame() const {
+    return std::atomic_ref(m_last_used_frame).load(std::memory_order_relaxed);
+}
+
+bool GpuResource::restore_requested() const {
+    return std::atomic_ref(m_restore_requested).load(std::memory_order_relaxed);
+}
+
+void GpuResource::set_resident(bool resident) {
+    std::atomic_ref(m_resident).store(resident, std::memory_order_release);
+}
+
+} // namespace engine::resources
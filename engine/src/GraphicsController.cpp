@@ -8,12 +8,16 @@
 #include <engine/graphics/OpenGL.hpp>
 #include <engine/platform/PlatformController.hpp>
 #include <engine/resources/Skybox.hpp>
+#include <engine/util/Configuration.hpp>
+#include <engine/util/FrameArena.hpp>
+#include <spdlog/spdlog.h>
 
 namespace engine::graphics {
 
 void GraphicsController::initialize() {
     const int opengl_initialized = gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
     RG_GUARANTEE(opengl_initialized, "OpenGL failed to init!");
+    OpenGL::load_extensions(reinterpret_cast<void *(*)(const char *)>(glfwGetProcAddress));
 
     auto platform = engine::core::Controller::get<platform::PlatformController>();
     auto handle = platform->window()
@@ -42,9 +46,169 @@ void GraphicsController::initialize() {
     (void) io;
     RG_GUARANTEE(ImGui_ImplGlfw_InitForOpenGL(handle, true), "ImGUI failed to initialize for OpenGL");
     RG_GUARANTEE(ImGui_ImplOpenGL3_Init("#version 330 core"), "ImGUI failed to initialize for OpenGL");
+
+    if (platform->is_headless()) {
+        resize_offscreen(platform->window()
+                                 ->width(), platform->window()
+                                                    ->height());
+    }
+
+    const auto graphics_config = util::Configuration::config().value("graphics", util::Configuration::json::object());
+    m_late_latch = graphics_config.value("late_latch", false);
+    m_frame_queue.initialize(graphics_config.value("max_frames_in_flight", 2u));
+    m_render_thread_enabled = graphics_config.value("render_thread", false);
+    if (m_render_thread_enabled && m_late_latch) {
+        spdlog::info("GraphicsController: the late latch is disabled, because the render thread waits for the GPU.");
+        m_late_latch = false;
+    }
+    if (m_render_thread_enabled) {
+        // ImGui::NewFrame on the main thread needs the font atlas, which the backend builds with its device objects.
+        RG_GUARANTEE(ImGui_ImplOpenGL3_CreateDeviceObjects(), "ImGUI failed to create the OpenGL device objects");
+    }
+}
+
+void GraphicsController::begin_draw() {
+    auto platform = core::Controller::get<platform::PlatformController>();
+    // Waiting for the GPU comes first, so that the late latch samples the input after the wait.
+    // The late latch is off with the render thread, where this wait is only queued, see set_late_latch.
+    submit([this] {
+        m_frame_queue.begin_frame();
+    });
+    if (m_late_latch) {
+        late_latch_camera();
+    }
+    submit([this, input_sample_ns = platform->input_sample_ns()] {
+        m_frame_queue.set_input_time(input_sample_ns);
+        if (m_offscreen.id != 0) {
+            OpenGL::bind_framebuffer(m_offscreen);
+        }
+    });
+}
+
+void GraphicsController::end_draw() {
+    auto platform = core::Controller::get<platform::PlatformController>();
+    if (!platform->is_render_on_demand() || platform->is_headless()) {
+        return;
+    }
+    submit([this, width = platform->window()->width(), height = platform->window()->height()] {
+        if (m_present_cache.width != width || m_present_cache.height != height) {
+            OpenGL::destroy_framebuffer(m_present_cache);
+            m_present_cache = OpenGL::create_framebuffer(width, height);
+        }
+        OpenGL::blit_framebuffer(0, m_present_cache.id, width, height);
+    });
+}
+
+void GraphicsController::present_last_frame() {
+    auto window = core::Controller::get<platform::PlatformController>()->window()->handle_();
+    submit([this, window] {
+        if (m_present_cache.id == 0) {
+            return;
+        }
+        OpenGL::blit_framebuffer(m_present_cache.id, 0, m_present_cache.width, m_present_cache.height);
+        glfwSwapBuffers(window);
+    });
+}
+
+void GraphicsController::submit(std::function<void()> command) {
+    if (m_render_thread_enabled) {
+        m_render_thread.packet()
+                       .commands
+                       .push_back(std::move(command));
+    } else {
+        command();
+    }
+}
+
+void GraphicsController::submit(std::vector<CommandList> lists) {
+    submit([lists = std::move(lists)] {
+        CommandList::replay(lists);
+    });
+}
+
+void GraphicsController::submit(std::span<const CommandList> lists) {
+    submit([lists] {
+        CommandList::replay(lists);
+    });
+}
+
+void GraphicsController::run_on_render_thread(const std::function<void()> &function) {
+    if (m_render_thread.is_running() && !m_render_thread.is_current_thread()) {
+        m_render_thread.run_sync(function);
+    } else {
+        function();
+    }
+}
+
+void GraphicsController::submit_frame() {
+    if (!m_render_thread_enabled) {
+        m_latency_stats = m_frame_queue.stats();
+        return;
+    }
+    if (!m_render_thread.is_running()) {
+        m_render_thread.start(core::Controller::get<platform::PlatformController>()->window()
+                                                                                  ->handle_());
+        spdlog::info("GraphicsController: OpenGL moved to the render thread.");
+    }
+    m_render_thread.submit_frame([this] {
+        m_latency_stats = m_frame_queue.stats();
+    });
+}
+
+void GraphicsController::stop_render_thread() {
+    m_render_thread.stop();
+}
+
+const CameraSnapshot &GraphicsController::camera_snapshot() const {
+    const glm::mat4 &projection = projection_matrix<Perspective>();
+    uint64_t view_version = m_camera.view_version();
+    if (view_version == m_snapshot_view_version && m_perspective_version == m_snapshot_projection_version) {
+        return m_camera_snapshot;
+    }
+    CameraSnapshot &snapshot = m_camera_snapshot;
+    snapshot.view = m_camera.view_matrix();
+    snapshot.inverse_view = m_camera.inverse_view_matrix();
+    snapshot.projection = projection;
+    snapshot.inverse_projection = glm::inverse(projection);
+    snapshot.view_projection = projection * snapshot.view;
+    snapshot.inverse_view_projection = snapshot.inverse_view * snapshot.inverse_projection;
+    snapshot.position = m_camera.Position;
+    snapshot.front = m_camera.Front;
+    snapshot.frustum = Frustum::from_matrix(snapshot.view_projection);
+    m_snapshot_view_version = view_version;
+    m_snapshot_projection_version = m_perspective_version;
+    return snapshot;
+}
+
+void GraphicsController::late_latch_camera() {
+    auto mouse = core::Controller::get<platform::PlatformController>()->late_latch_mouse();
+    if (mouse.dx != 0.0f || mouse.dy != 0.0f) {
+        m_camera.rotate_camera(mouse.dx, mouse.dy);
+    }
+}
+
+void GraphicsController::resize_offscreen(int width, int height) {
+    if (!core::Controller::get<platform::PlatformController>()->is_headless() || width <= 0 || height <= 0) {
+        return;
+    }
+    OpenGL::destroy_framebuffer(m_offscreen);
+    m_offscreen = OpenGL::create_framebuffer(width, height);
+}
+
+std::vector<uint8_t> GraphicsController::read_frame() {
+    std::vector<uint8_t> pixels;
+    run_on_render_thread([this, &pixels] {
+        RG_GUARANTEE(m_offscreen.id != 0, "GraphicsController::read_frame is available only in the headless mode.");
+        pixels = OpenGL::read_pixels(m_offscreen);
+    });
+    return pixels;
 }
 
 void GraphicsController::terminate() {
+    m_render_thread.stop();
+    m_frame_queue.terminate();
+    OpenGL::destroy_framebuffer(m_offscreen);
+    OpenGL::destroy_framebuffer(m_present_cache);
     if (ImGui::GetCurrentContext()) {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -62,6 +226,10 @@ void GraphicsPlatformEventObserver::on_window_resize(int width, int height) {
               .Right = static_cast<float>(width);
     m_graphics->orthographic_params()
               .Top = static_cast<float>(height);
+    m_graphics->submit([graphics = m_graphics, width, height] {
+        CHECKED_GL_CALL(glViewport, 0, 0, width, height);
+        graphics->resize_offscreen(width, height);
+    });
 }
 
 std::string_view GraphicsController::name() const {
@@ -69,28 +237,56 @@ std::string_view GraphicsController::name() const {
 }
 
 void GraphicsController::begin_gui() {
-    ImGui_ImplOpenGL3_NewFrame();
+    if (!m_render_thread_enabled) {
+        ImGui_ImplOpenGL3_NewFrame();
+    }
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 }
 
 void GraphicsController::end_gui() {
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    if (!m_render_thread_enabled) {
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        return;
+    }
+    GuiDrawData *gui = &m_render_thread.packet()
+                                       .gui;
+    gui->capture(ImGui::GetDrawData());
+    submit([gui] {
+        gui->render();
+    });
 }
 
 void GraphicsController::draw_skybox(const resources::Shader *shader, const resources::Skybox *skybox) {
-    glm::mat4 view = glm::mat4(glm::mat3(m_camera.view_matrix()));
-    shader->use();
-    shader->set_mat4("view", view);
-    shader->set_mat4("projection", projection_matrix<>());
-    CHECKED_GL_CALL(glDepthFunc, GL_LEQUAL);
-    CHECKED_GL_CALL(glBindVertexArray, skybox->vao());
-    CHECKED_GL_CALL(glActiveTexture, GL_TEXTURE0);
-    CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, skybox->texture());
-    CHECKED_GL_CALL(glDrawArrays, GL_TRIANGLES, 0, 36);
-    CHECKED_GL_CALL(glBindVertexArray, 0);
-    CHECKED_GL_CALL(glDepthFunc, GL_LESS); // set depth function back to default
-    CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, 0);
+    skybox->mark_used();
+    if (!skybox->is_resident()) {
+        return;
+    }
+    const CameraSnapshot &camera = camera_snapshot();
+    struct SkyboxDraw {
+        const resources::Shader *shader;
+        const resources::Skybox *skybox;
+        glm::mat4 view;
+        glm::mat4 projection;
+    };
+    // The skybox follows the camera, so only the rotation of the view is used. The matrices are kept in the frame
+    // arena, because a command capturing them by value is too large for the std::function to store without allocating.
+    const SkyboxDraw *draw = util::FrameArena::instance()->create<SkyboxDraw>(
+            shader, skybox, glm::mat4(glm::mat3(camera.view)), camera.projection);
+    submit([draw] {
+        const resources::Shader *shader = draw->shader;
+        shader->use();
+        shader->set_mat4("view", draw->view);
+        shader->set_mat4("projection", draw->projection);
+        CHECKED_GL_CALL(glDepthFunc, GL_LEQUAL);
+        CHECKED_GL_CALL(glBindVertexArray, draw->skybox->vao());
+        CHECKED_GL_CALL(glActiveTexture, GL_TEXTURE0);
+        CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, draw->skybox->texture());
+        CHECKED_GL_CALL(glDrawArrays, GL_TRIANGLES, 0, 36);
+        CHECKED_GL_CALL(glBindVertexArray, 0);
+        CHECKED_GL_CALL(glDepthFunc, GL_LESS); // set depth function back to default
+        CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, 0);
+    });
 }
 }
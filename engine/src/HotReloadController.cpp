@@ -0,0 +1,276 @@
+#include <glad/glad.h>
+#include <engine/graphics/GraphicsController.hpp>
+#include <engine/platform/PlatformController.hpp>
+#include <engine/resources/HotReloadController.hpp>
+#include <engine/resources/ResourcesController.hpp>
+#include <engine/util/Errors.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace engine::resources {
+
+/**
+ * @brief How long the watcher waits for more events after a file change, so that an editor saving a file in several
+ * steps triggers only one reload.
+ */
+static constexpr int DEBOUNCE_MILLISECONDS = 50;
+
+/**
+ * @brief How often the watcher thread checks whether it should stop.
+ */
+static constexpr int STOP_CHECK_MILLISECONDS = 200;
+
+static std::string watch_key(const std::filesystem::path &path) {
+    return std::filesystem::weakly_canonical(path)
+            .string();
+}
+
+void HotReloadController::initialize() {
+#ifdef __linux__
+    m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    RG_GUARANTEE(m_inotify_fd >= 0, "Failed to initialize inotify for resource hot reloading.");
+    update_dependency_map();
+    m_watcher = std::jthread([this](std::stop_token stop_token) {
+        watch_files(std::move(stop_token));
+    });
+#else
+    spdlog::warn("[HotReloadController]: resource hot reloading is supported only on Linux.");
+    set_enable(false);
+#endif
+}
+
+void HotReloadController::terminate() {
+    if (m_watcher.joinable()) {
+        m_watcher.request_stop();
+        m_watcher.join();
+    }
+#ifdef __linux__
+    if (m_inotify_fd >= 0) {
+        close(m_inotify_fd);
+        m_inotify_fd = -1;
+    }
+#endif
+}
+
+void HotReloadController::update_dependency_map() {
+    auto resources = core::Controller::get<ResourcesController>();
+    size_t variant_count = 0;
+    for (const auto &[key, variant]: resources->m_shader_variants) {
+        // The render thread writes the shader of a variant before it publishes the ready flag.
+        variant_count += variant.ready.load(std::memory_order_acquire);
+    }
+    if (resources->m_generation == m_watched_generation && variant_count == m_watched_variant_count) {
+        return;
+    }
+    m_watched_generation = resources->m_generation;
+    m_watched_variant_count = variant_count;
+
+    std::lock_guard lock(m_mutex);
+    m_shader_dependents.clear();
+    m_texture_dependents.clear();
+    auto add_shader = [this](Shader *shader) {
+        if (shader->source_path().empty()) {
+            return;
+        }
+        ShaderDependent dependent{shader, ShaderSourceFile{shader->name(), shader->source_path(), shader->defines()}};
+        m_shader_dependents[watch_key(shader->source_path())].push_back(dependent);
+        watch_directory_of(shader->source_path());
+        for (const auto &dependency: shader->dependencies()) {
+            m_shader_dependents[watch_key(dependency)].push_back(dependent);
+            watch_directory_of(dependency);
+        }
+    };
+    resources->m_shaders.slots.for_each([&](util::Handle<Shader>, Shader &shader) {
+        add_shader(&shader);
+    });
+    for (const auto &[key, variant]: resources->m_shader_variants) {
+        if (variant.ready.load(std::memory_order_acquire)) {
+            add_shader(variant.shader
+                              .get());
+        }
+    }
+    resources->m_textures.slots.for_each([&](util::Handle<Texture>, Texture &texture) {
+        if (!exists(texture.path())) {
+            return;
+        }
+        m_texture_dependents[watch_key(texture.path())].push_back(
+                TextureDependent{&texture, texture.path(), texture.flip_uvs()});
+        watch_directory_of(texture.path());
+    });
+}
+
+bool HotReloadController::is_watched(const ShaderDependent &dependent) const {
+    auto it = m_shader_dependents.find(watch_key(dependent.file.path));
+    return it != m_shader_dependents.end() && std::ranges::any_of(it->second, [&](const auto &watched) {
+        return watched.shader == dependent.shader && watched.file.name == dependent.file.name;
+    });
+}
+
+bool HotReloadController::is_watched(const TextureDependent &dependent) const {
+    auto it = m_texture_dependents.find(watch_key(dependent.path));
+    return it != m_texture_dependents.end() && std::ranges::any_of(it->second, [&](const auto &watched) {
+        return watched.texture == dependent.texture;
+    });
+}
+
+void HotReloadController::watch_directory_of(const std::filesystem::path &file) {
+#ifdef __linux__
+    auto directory = std::filesystem::weakly_canonical(file)
+            .parent_path();
+    // Watching the directory instead of the file catches editors that save by writing a new file and renaming it.
+    int watch_descriptor = inotify_add_watch(m_inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch_descriptor < 0) {
+        spdlog::warn("[HotReloadController]: failed to watch directory {}", directory.string());
+        return;
+    }
+    m_watched_directories[watch_descriptor] = directory;
+#endif
+}
+
+void HotReloadController::watch_files(std::stop_token stop_token) {
+#ifdef __linux__
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    std::unordered_set<std::string> changed_files;
+    pollfd poll_descriptor{m_inotify_fd, POLLIN, 0};
+    while (!stop_token.stop_requested()) {
+        int timeout = changed_files.empty() ? STOP_CHECK_MILLISECONDS : DEBOUNCE_MILLISECONDS;
+        if (poll(&poll_descriptor, 1, timeout) <= 0) {
+            if (!changed_files.empty()) {
+                reload(changed_files);
+                changed_files.clear();
+            }
+            continue;
+        }
+        ssize_t length = read(m_inotify_fd, buffer.data(), buffer.size());
+        std::lock_guard lock(m_mutex);
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+            auto directory = m_watched_directories.find(event->wd);
+            if (event->len > 0 && directory != m_watched_directories.end()) {
+                changed_files.emplace((directory->second / event->name).string());
+            }
+        }
+    }
+#endif
+}
+
+void HotReloadController::reload(const std::unordered_set<std::string> &changed_files) {
+    std::vector<ShaderDependent> shaders;
+    std::vector<TextureDependent> textures;
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto &file: changed_files) {
+            if (auto it = m_shader_dependents.find(file); it != m_shader_dependents.end()) {
+                for (const auto &dependent: it->second) {
+                    // A shader that includes several of the changed files is reloaded only once.
+                    if (std::ranges::none_of(shaders, [&](const auto &s) { return s.shader == dependent.shader; })) {
+                        shaders.push_back(dependent);
+                    }
+                }
+            }
+            if (auto it = m_texture_dependents.find(file); it != m_texture_dependents.end()) {
+                textures.insert(textures.end(), it->second
+                                                  .begin(), it->second
+                                                                .end());
+            }
+        }
+    }
+
+    for (auto &dependent: shaders) {
+        spdlog::info("[HotReloadController]: reloading shader {}", dependent.file
+                                                                            .path
+                                                                            .string());
+        try {
+            ParsedShader parsed = ShaderCompiler::parse_file(dependent.file);
+            std::lock_guard lock(m_mutex);
+            m_parsed_shaders.emplace_back(dependent, std::move(parsed));
+        } catch (const util::Error &e) {
+            spdlog::error("[HotReloadController]: {}", e.report());
+        } catch (const std::exception &e) {
+            // A file that is deleted or renamed during the reload must not terminate the watcher thread.
+            spdlog::error("[HotReloadController]: {}", e.what());
+        }
+    }
+    for (auto &dependent: textures) {
+        spdlog::info("[HotReloadController]: reloading texture {}", dependent.path
+                                                                             .string());
+        try {
+            graphics::DecodedImage image = graphics::OpenGL::decode_image(dependent.path, dependent.flip_uvs);
+            std::lock_guard lock(m_mutex);
+            m_decoded_textures.emplace_back(dependent, std::move(image));
+        } catch (const util::Error &e) {
+            spdlog::error("[HotReloadController]: {}", e.report());
+        } catch (const std::exception &e) {
+            spdlog::error("[HotReloadController]: {}", e.what());
+        }
+    }
+    if (!shaders.empty() || !textures.empty()) {
+        // The main loop may be waiting for events in the render on demand mode.
+        platform::PlatformController::wake_up();
+    }
+}
+
+void HotReloadController::poll_events() {
+    auto resources = core::Controller::get<ResourcesController>();
+    // Updated first, so that the resources unloaded since the last frame aren't reloaded.
+    update_dependency_map();
+    std::vector<std::pair<ShaderDependent, ParsedShader> > parsed_shaders;
+    std::vector<std::pair<TextureDependent, graphics::DecodedImage> > decoded_textures;
+    {
+        std::lock_guard lock(m_mutex);
+        std::swap(parsed_shaders, m_parsed_shaders);
+        std::swap(decoded_textures, m_decoded_textures);
+    }
+
+    if (!decoded_textures.empty() || !parsed_shaders.empty() || !m_compiling_shaders.empty()) {
+        // With the render thread this waits for the previous frame, but only while something is being reloaded.
+        core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+            for (auto &[dependent, image]: decoded_textures) {
+                Texture *texture = dependent.texture;
+                // An evicted texture is loaded from its file again when it's restored.
+                if (!is_watched(dependent) || !texture->is_resident()) {
+                    continue;
+                }
+                graphics::OpenGL::upload_texture(texture->id(), image);
+                resources->update_gpu_memory_size(texture, graphics::OpenGL::texture_memory_size(texture->id(), GL_TEXTURE_2D));
+            }
+            for (auto &[dependent, parsed]: parsed_shaders) {
+                if (is_watched(dependent)) {
+                    m_compiling_shaders.emplace_back(dependent, ShaderCompiler::submit(std::move(parsed)));
+                }
+            }
+
+            // Swap in the shaders only after the driver finished compiling them, so that the frame doesn't stall.
+            std::erase_if(m_compiling_shaders, [this, resources](auto &compiling) {
+                auto &[dependent, replacement] = compiling;
+                if (!is_watched(dependent)) {
+                    replacement.destroy();
+                    return true;
+                }
+                if (!replacement.is_ready()) {
+                    return false;
+                }
+                Shader *shader = dependent.shader;
+                try {
+                    resources->replace_shader(shader, std::move(replacement));
+                } catch (const util::Error &e) {
+                    spdlog::error("[HotReloadController]: keeping the previous version of the shader {}. {}",
+                                  shader->name(), e.report());
+                }
+                return true;
+            });
+        });
+        // Keeps drawing until the compiled shaders are swapped in, and shows the reloaded resources.
+        core::Controller::get<platform::PlatformController>()->request_redraw();
+    }
+}
+
+} // namespace engine::resources
@@ -0,0 +1,83 @@
+#include <engine/platform/InputRecording.hpp>
+#include <engine/util/Errors.hpp>
+#include <array>
+
+namespace engine::platform {
+
+static constexpr size_t KEY_WORDS = (KEY_COUNT + 63) / 64;
+
+template<typename T>
+static void write_value(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+static bool read_value(std::ifstream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+InputRecorder::InputRecorder(const std::filesystem::path &path, const InputRecordingHeader &header) : m_file(
+        path, std::ios::binary | std::ios::trunc), m_path(path) {
+    RG_GUARANTEE(m_file.is_open(), "Failed to create the input recording {}.", path.string());
+    write_value(m_file, header.magic);
+    write_value(m_file, header.version);
+    write_value(m_file, header.key_count);
+    write_value(m_file, header.replay_dt);
+    write_value(m_file, header.window_width);
+    write_value(m_file, header.window_height);
+}
+
+void InputRecorder::write(const InputFrame &frame) {
+    write_value(m_file, frame.dt);
+    write_value(m_file, frame.mouse.x);
+    write_value(m_file, frame.mouse.y);
+    write_value(m_file, frame.mouse.dx);
+    write_value(m_file, frame.mouse.dy);
+    write_value(m_file, frame.mouse.scroll);
+    std::array<uint64_t, KEY_WORDS> words{};
+    for (size_t key = 0; key < KEY_COUNT; ++key) {
+        words[key / 64] |= static_cast<uint64_t>(frame.keys_down[key]) << (key % 64);
+    }
+    write_value(m_file, words);
+    write_value(m_file, frame.resize_width);
+    write_value(m_file, frame.resize_height);
+    RG_GUARANTEE(m_file.good(), "Failed to write the input recording {}.", m_path.string());
+    ++m_frame_count;
+}
+
+InputReplay::InputReplay(const std::filesystem::path &path) : m_file(path, std::ios::binary), m_path(path) {
+    RG_GUARANTEE(m_file.is_open(), "Failed to open the input recording {}.", path.string());
+    bool read = read_value(m_file, m_header.magic) && read_value(m_file, m_header.version) &&
+                read_value(m_file, m_header.key_count) && read_value(m_file, m_header.replay_dt) &&
+                read_value(m_file, m_header.window_width) && read_value(m_file, m_header.window_height);
+    RG_GUARANTEE(read && m_header.magic == InputRecordingHeader::MAGIC, "{} is not an input recording.",
+                 path.string());
+    RG_GUARANTEE(m_header.version == InputRecordingHeader::VERSION,
+                 "Input recording {} has version {}, expected {}.", path.string(), m_header.version,
+                 InputRecordingHeader::VERSION);
+    RG_GUARANTEE(m_header.key_count == KEY_COUNT,
+                 "Input recording {} was made with {} keys, this build has {}.", path.string(), m_header.key_count,
+                 static_cast<uint32_t>(KEY_COUNT));
+    RG_GUARANTEE(m_header.replay_dt > 0.0f, "Input recording {} has an invalid frame time.", path.string());
+}
+
+bool InputReplay::next(InputFrame &frame) {
+    std::array<uint64_t, KEY_WORDS> words{};
+    bool read = read_value(m_file, frame.dt) && read_value(m_file, frame.mouse.x) &&
+                read_value(m_file, frame.mouse.y) && read_value(m_file, frame.mouse.dx) &&
+                read_value(m_file, frame.mouse.dy) && read_value(m_file, frame.mouse.scroll) &&
+                read_value(m_file, words) && read_value(m_file, frame.resize_width) &&
+                read_value(m_file, frame.resize_height);
+    if (!read) {
+        // A run that crashed while recording leaves a partial last frame, which is dropped.
+        return false;
+    }
+    for (size_t key = 0; key < KEY_COUNT; ++key) {
+        frame.keys_down[key] = (words[key / 64] >> (key % 64)) & 1;
+    }
+    ++m_frame_count;
+    m_recorded_time += frame.dt;
+    return true;
+}
+
+} // namespace engine::platform
@@ -0,0 +1,193 @@
+#include <engine/core/JobSystem.hpp>
+#include <engine/util/Configuration.hpp>
+#include <engine/util/Profiler.hpp>
+#include <spdlog/spdlog.h>
+
+namespace engine::core {
+
+/**
+* @brief Index of the worker that runs on the calling thread, -1 for the threads that aren't workers.
+*/
+static thread_local int32_t g_worker_index = -1;
+
+void JobSystem::initialize() {
+    m_main_thread = std::this_thread::get_id();
+    const auto &config = util::Configuration::config();
+    uint32_t worker_count = config.contains("engine") ? config["engine"].value("worker_threads", 0u) : 0u;
+    if (worker_count == 0) {
+        worker_count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+    // All the workers must exist before any of them starts stealing.
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        m_workers[i]->thread = std::jthread([this, i](std::stop_token stop_token) {
+            worker_loop(i, std::move(stop_token));
+        });
+    }
+    spdlog::info("JobSystem: started {} worker threads", worker_count);
+}
+
+void JobSystem::poll_events() {
+    Task task;
+    while (try_pop_main_thread(task)) {
+        execute(task);
+    }
+}
+
+void JobSystem::terminate() {
+    for (auto &worker: m_workers) {
+        worker->thread.request_stop();
+    }
+    m_wake.notify_all();
+    for (auto &worker: m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    m_workers.clear();
+}
+
+void JobSystem::run(Job job, JobCounter *counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(Task{std::move(job), counter});
+}
+
+void JobSystem::run_after(JobCounter &dependency, Job job, JobCounter *counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        // The lock orders this check with the continuations taken in finish, so the job can't be lost.
+        std::lock_guard lock(dependency.m_mutex);
+        if (dependency.m_pending.load(std::memory_order_acquire) != 0) {
+            dependency.m_continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+    push(Task{std::move(job), counter});
+}
+
+void JobSystem::run_on_main_thread(Job job, JobCounter *counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::lock_guard lock(m_main_thread_mutex);
+    m_main_thread_tasks.push_back(Task{std::move(job), counter});
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    bool main_thread = is_main_thread();
+    uint32_t idle_rounds = 0;
+    while (counter.m_pending.load(std::memory_order_acquire) != 0) {
+        Task task;
+        if ((main_thread && try_pop_main_thread(task)) || try_pop(task)) {
+            execute(task);
+            idle_rounds = 0;
+        } else if (++idle_rounds < 64) {
+            std::this_thread::yield();
+        } else {
+            // The remaining jobs are long-running; stop burning the core while they finish.
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    // Waits for the job that finished last to release the counter.
+    std::lock_guard lock(counter.m_mutex);
+}
+
+void JobSystem::push(Task task) {
+    RG_GUARANTEE(!m_workers.empty(), "JobSystem is used before it was initialized.");
+    uint32_t index = g_worker_index >= 0
+                         ? static_cast<uint32_t>(g_worker_index)
+                         : m_next_worker.fetch_add(1, std::memory_order_relaxed) % worker_count();
+    {
+        std::lock_guard lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        // Locking the sleep mutex prevents a lost wakeup between the worker's check and its wait.
+        std::lock_guard lock(m_sleep_mutex);
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::worker_loop(uint32_t index, std::stop_token stop_token) {
+    g_worker_index = static_cast<int32_t>(index);
+    util::Profiler::set_thread_name(std::format("Worker {}", index));
+    while (!stop_token.stop_requested()) {
+        Task task;
+        if (try_pop(task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock lock(m_sleep_mutex);
+        m_wake.wait(lock, stop_token, [this] {
+            return m_queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+bool JobSystem::try_pop(Task &task) {
+    if (m_queued.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    uint32_t count = worker_count();
+    uint32_t own = g_worker_index >= 0 ? static_cast<uint32_t>(g_worker_index) : 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        Worker &worker = *m_workers[(own + i) % count];
+        std::lock_guard lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            continue;
+        }
+        // The owner takes the newest job, which is likely still in its cache; thieves take the oldest one.
+        if (i == 0 && g_worker_index >= 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::try_pop_main_thread(Task &task) {
+    std::lock_guard lock(m_main_thread_mutex);
+    if (m_main_thread_tasks.empty()) {
+        return false;
+    }
+    task = std::move(m_main_thread_tasks.front());
+    m_main_thread_tasks.pop_front();
+    return true;
+}
+
+void JobSystem::execute(Task &task) {
+    task.job();
+    task.job = nullptr;
+    finish(task.counter);
+}
+
+void JobSystem::finish(JobCounter *counter) {
+    if (!counter) {
+        return;
+    }
+    std::vector<std::pair<Job, JobCounter *> > continuations;
+    {
+        std::lock_guard lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        std::swap(continuations, counter->m_continuations);
+    }
+    for (auto &[job, next_counter]: continuations) {
+        push(Task{std::move(job), next_counter});
+    }
+}
+
+} // namespace engine::core
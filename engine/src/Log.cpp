@@ -0,0 +1,177 @@
+#include <engine/util/Log.hpp>
+#include <engine/util/Errors.hpp>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace engine::util {
+
+AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, size_t capacity, OverflowPolicy policy) : m_sinks(
+        std::move(sinks)), m_policy(policy) {
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    m_slots = std::make_unique<Slot[]>(capacity);
+    m_mask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_thread = std::thread([this] {
+        run();
+    });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    m_running.store(false, std::memory_order_release);
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+    m_thread.join();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg &msg) {
+    // Bounded multi-producer queue by Dmitry Vyukov: a slot is free for the position p when its sequence equals p,
+    // and ready for the consumer when its sequence equals p + 1.
+    size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = &m_slots[position & m_mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            if (m_policy == OverflowPolicy::Drop) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+        } else {
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = msg.level;
+    slot->time = msg.time;
+    slot->thread_id = msg.thread_id;
+    slot->logger_name = msg.logger_name;
+    slot->size = msg.payload.size();
+    if (slot->size <= INLINE_MESSAGE_SIZE) {
+        std::memcpy(slot->message, msg.payload.data(), slot->size);
+    } else {
+        slot->long_message.assign(msg.payload.data(), msg.payload.size());
+    }
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+}
+
+bool AsyncLogSink::write_next() {
+    size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[position & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    spdlog::string_view_t payload = slot.size <= INLINE_MESSAGE_SIZE
+                                        ? spdlog::string_view_t(slot.message, slot.size)
+                                        : spdlog::string_view_t(slot.long_message);
+    spdlog::details::log_msg msg(slot.time, spdlog::source_loc{}, slot.logger_name, slot.level, payload);
+    msg.thread_id = slot.thread_id;
+    for (auto &sink: m_sinks) {
+        if (sink->should_log(msg.level)) {
+            sink->log(msg);
+        }
+    }
+    slot.long_message.clear();
+    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+    m_dequeue_position.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogSink::run() {
+    uint64_t reported_dropped = 0;
+    for (;;) {
+        uint32_t signal = m_signal.load(std::memory_order_acquire);
+        while (write_next()) {
+        }
+        if (uint64_t dropped = dropped_count(); dropped != reported_dropped) {
+            std::string report = std::format("AsyncLogSink: dropped {} messages, the log queue was full.",
+                                             dropped - reported_dropped);
+            spdlog::details::log_msg msg("", spdlog::level::warn, report);
+            for (auto &sink: m_sinks) {
+                sink->log(msg);
+            }
+            reported_dropped = dropped;
+        }
+        if (!m_running.load(std::memory_order_acquire)) {
+            break;
+        }
+        m_signal.wait(signal, std::memory_order_acquire);
+    }
+    // Producers still running at shutdown may have written more messages.
+    while (write_next()) {
+    }
+    for (auto &sink: m_sinks) {
+        sink->flush();
+    }
+}
+
+void AsyncLogSink::flush() {
+    size_t target = m_enqueue_position.load(std::memory_order_acquire);
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+    while (m_running.load(std::memory_order_acquire) &&
+           m_dequeue_position.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+    for (auto &sink: m_sinks) {
+        sink->flush();
+    }
+}
+
+void AsyncLogSink::set_pattern(const std::string &pattern) {
+    for (auto &sink: m_sinks) {
+        sink->set_pattern(pattern);
+    }
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+    for (auto &sink: m_sinks) {
+        sink->set_formatter(sink_formatter->clone());
+    }
+}
+
+void initialize_logging(const nlohmann::json &config) {
+    auto level = spdlog::level::from_str(config.value("level", std::string("info")));
+    auto console = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    std::shared_ptr<spdlog::logger> logger;
+    if (config.value("async", true)) {
+        std::string overflow = config.value("overflow", std::string("block"));
+        RG_GUARANTEE(overflow == "block" || overflow == "drop",
+                     "logging.overflow must be \"block\" or \"drop\", got \"{}\".", overflow);
+        auto sink = std::make_shared<AsyncLogSink>(std::vector<spdlog::sink_ptr>{console},
+                                                   config.value("queue_size", 8192u),
+                                                   overflow == "drop"
+                                                       ? AsyncLogSink::OverflowPolicy::Drop
+                                                       : AsyncLogSink::OverflowPolicy::Block);
+        logger = std::make_shared<spdlog::logger>("", sink);
+    } else {
+        logger = std::make_shared<spdlog::logger>("", console);
+    }
+    logger->set_level(level);
+    // Warnings and errors are written before the call returns, in case the app is about to crash.
+    logger->flush_on(spdlog::level::warn);
+    spdlog::set_default_logger(std::move(logger));
+}
+
+void shutdown_logging() {
+    auto logger = spdlog::default_logger();
+    logger->flush();
+    auto console = std::make_shared<spdlog::logger>("", std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+    console->set_level(logger->level());
+    spdlog::set_default_logger(std::move(console));
+}
+
+} // namespace engine::util
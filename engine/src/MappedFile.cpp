@@ -0,0 +1,123 @@
+#include <engine/util/MappedFile.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Utils.hpp>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine::util {
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path &path, Access access)
+        : m_path(path) {
+    DWORD flags = access == Access::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        RG_ENGINE_ERROR(EngineError::Type::FileNotFound, "Failed to open file {}, error {}.", path.string(),
+                        GetLastError());
+    }
+    defer {
+        CloseHandle(file);
+    };
+    LARGE_INTEGER size;
+    RG_GUARANTEE(GetFileSizeEx(file, &size), "Failed to get the size of {}, error {}.", path.string(), GetLastError());
+    if (size.QuadPart == 0) {
+        return;
+    }
+    // The view keeps the mapping object alive, so both handles can be closed right away.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    RG_GUARANTEE(mapping != nullptr, "Failed to map file {}, error {}.", path.string(), GetLastError());
+    defer {
+        CloseHandle(mapping);
+    };
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    RG_GUARANTEE(data != nullptr, "Failed to map file {}, error {}.", path.string(), GetLastError());
+    if (access == Access::WillNeed) {
+        WIN32_MEMORY_RANGE_ENTRY range{data, static_cast<SIZE_T>(size.QuadPart)};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+    m_data = static_cast<const std::byte *>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+}
+
+void MappedFile::unmap() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+}
+#else
+static int advice(MappedFile::Access access) {
+    switch (access) {
+    case MappedFile::Access::Sequential: return MADV_SEQUENTIAL;
+    case MappedFile::Access::Random: return MADV_RANDOM;
+    case MappedFile::Access::WillNeed: return MADV_WILLNEED;
+    }
+    RG_SHOULD_NOT_REACH_HERE("Unhandled access {}", static_cast<int>(access));
+}
+
+MappedFile::MappedFile(const std::filesystem::path &path, Access access)
+        : m_path(path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        RG_ENGINE_ERROR(EngineError::Type::FileNotFound, "Failed to open file {}: {}.", path.string(),
+                        std::strerror(errno));
+    }
+    // The mapping stays valid after the descriptor is closed.
+    defer {
+        close(fd);
+    };
+    struct stat status{};
+    RG_GUARANTEE(fstat(fd, &status) == 0, "Failed to stat file {}: {}.", path.string(), std::strerror(errno));
+    RG_GUARANTEE(S_ISREG(status.st_mode), "{} is not a regular file.", path.string());
+    if (status.st_size == 0) {
+        return;
+    }
+    size_t size = static_cast<size_t>(status.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    RG_GUARANTEE(data != MAP_FAILED, "Failed to map file {}: {}.", path.string(), std::strerror(errno));
+    // Only a hint, the mapping works the same if the OS ignores it.
+    madvise(data, size, advice(access));
+    m_data = static_cast<const std::byte *>(data);
+    m_size = size;
+}
+
+void MappedFile::unmap() {
+    if (m_data) {
+        munmap(const_cast<std::byte *>(m_data), m_size);
+    }
+}
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+        : m_path(std::move(other.m_path))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0)) {
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_path = std::move(other.m_path);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+} // namespace engine::util
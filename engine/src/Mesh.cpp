@@ -2,12 +2,26 @@
 #include <engine/util/Utils.hpp>
 #include <engine/resources/Mesh.hpp>
 #include <engine/resources/Shader.hpp>
+#include <format>
 #include <unordered_map>
 
 namespace engine::resources {
 
 Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
            std::vector<Texture *> textures) {
+    upload(vertices, indices);
+    m_textures = std::move(textures);
+
+    // Uniform names follow the texture_<type><N> convention, where N counts the textures of the same type.
+    std::unordered_map<std::string_view, uint32_t> counts;
+    m_texture_uniforms.reserve(m_textures.size());
+    for (const auto texture: m_textures) {
+        const auto texture_type = Texture::uniform_name_convention(texture->type());
+        m_texture_uniforms.push_back(std::format("{}{}", texture_type, ++counts[texture_type]));
+    }
+}
+
+void Mesh::upload(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) {
     // NOLINTBEGIN
     static_assert(std::is_trivial_v<Vertex>);
     uint32_t VAO, VBO, EBO;
@@ -40,31 +54,57 @@ Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &ind
     glBindVertexArray(0);
     // NOLINTEND
     m_vao = VAO;
+    m_vbo = VBO;
+    m_ebo = EBO;
+    m_num_vertices = vertices.size();
     m_num_indices = indices.size();
-    m_textures = std::move(textures);
+}
+
+void Mesh::evict() {
+    m_evicted.vertices.resize(m_num_vertices);
+    m_evicted.indices.resize(m_num_indices);
+    // The copy read buffer target doesn't change the element buffer binding of the bound vertex array.
+    glBindBuffer(GL_COPY_READ_BUFFER, m_vbo);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, m_evicted.vertices.size() * sizeof(Vertex), m_evicted.vertices.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, m_ebo);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, m_evicted.indices.size() * sizeof(uint32_t), m_evicted.indices.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    destroy();
+}
+
+void Mesh::restore() {
+    upload(m_evicted.vertices, m_evicted.indices);
+    m_evicted = {};
 }
 
 void Mesh::draw(const Shader *shader) {
-    std::unordered_map<std::string_view, uint32_t> counts;
-    std::string uniform_name;
-    uniform_name.reserve(32);
     for (int i = 0; i < m_textures.size(); i++) {
+        m_textures[i]->mark_used();
         glActiveTexture(GL_TEXTURE0 + i);
-        const auto &texture_type = Texture::uniform_name_convention(m_textures[i]->type());
-        uniform_name.append(texture_type);
-        const auto count = (counts[texture_type] += 1);
-        uniform_name.append(std::to_string(count));
-        shader->set_int(uniform_name, i);
+        shader->set_int(m_texture_uniforms[i], i);
         glBindTexture(GL_TEXTURE_2D, m_textures[i]->id());
-        uniform_name.clear();
     }
     glBindVertexArray(m_vao);
     glDrawElements(GL_TRIANGLES, m_num_indices, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
+void Mesh::record_draw(graphics::CommandList &list) const {
+    for (uint32_t i = 0; i < m_textures.size(); i++) {
+        m_textures[i]->mark_used();
+        list.set_uniform(m_texture_uniforms[i], static_cast<int>(i));
+        // The id of an evicted texture is written when it's restored, so it's read only once the texture is resident.
+        list.bind_texture(i, GL_TEXTURE_2D, m_textures[i]->is_resident() ? m_textures[i]->id() : 0);
+    }
+    list.bind_mesh(m_vao, m_num_indices);
+    list.draw();
+}
+
 void Mesh::destroy() {
     glDeleteVertexArrays(1, &m_vao);
+    glDeleteBuffers(1, &m_vbo);
+    glDeleteBuffers(1, &m_ebo);
+    m_vao = m_vbo = m_ebo = 0;
 }
 
 }
@@ -5,15 +5,42 @@
 namespace engine::resources {
 
 void Model::draw(const Shader *shader) {
+    mark_used();
+    if (!is_resident()) {
+        return;
+    }
     shader->use();
     for (auto &mesh: m_meshes) {
         mesh.draw(shader);
     }
 }
 
+void Model::record_draw(graphics::CommandList &list, const Shader *shader) const {
+    mark_used();
+    if (!is_resident()) {
+        return;
+    }
+    list.bind_program(shader);
+    for (const auto &mesh: m_meshes) {
+        mesh.record_draw(list);
+    }
+}
+
 void Model::destroy() {
     for (auto &mesh: m_meshes) {
         mesh.destroy();
     }
 }
+
+void Model::evict_gpu_objects() {
+    for (auto &mesh: m_meshes) {
+        mesh.evict();
+    }
+}
+
+void Model::restore_gpu_objects() {
+    for (auto &mesh: m_meshes) {
+        mesh.restore();
+    }
+}
 }
@@ -1,15 +1,22 @@
 #include <glad/glad.h>
 #include <filesystem>
 #include <array>
+#include <limits>
 #include <stb_image.h>
 #include <engine/graphics/OpenGL.hpp>
 #include <engine/resources/Shader.hpp>
 #include <engine/resources/ShaderCompiler.hpp>
 #include <engine/resources/Skybox.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
 #include <engine/util/Utils.hpp>
 
 namespace engine::graphics {
+// GL_KHR_parallel_shader_compile isn't part of the generated glad loader, so we load it ourselves.
+static constexpr GLenum COMPLETION_STATUS_KHR = 0x91B1;
+using PfnMaxShaderCompilerThreadsKhr = void (*)(GLuint count);
+static bool g_parallel_shader_compile = false;
+
 int32_t OpenGL::shader_type_to_opengl_type(resources::ShaderType type) {
     switch (type) {
         case resources::ShaderType::Vertex: return GL_VERTEX_SHADER;
@@ -20,31 +27,97 @@ int32_t OpenGL::shader_type_to_opengl_type(resources::ShaderType type) {
 }
 
 uint32_t OpenGL::generate_texture(const std::filesystem::path &path, bool flip_uvs) {
+    DecodedImage image = decode_image(path, flip_uvs);
     uint32_t texture_id = 0;
     CHECKED_GL_CALL(glGenTextures, 1, &texture_id);
+    upload_texture(texture_id, image);
+    return texture_id;
+}
 
-    int32_t width, height, nr_components;
-    stbi_set_flip_vertically_on_load(flip_uvs);
-    uint8_t *data = stbi_load(path.c_str(), &width, &height, &nr_components, 0);
-    defer {
-        stbi_image_free(data);
-    };
-    if (data) {
-        int32_t format = texture_format(nr_components);
+void DecodedImage::PixelsDeleter::operator()(uint8_t *pixels) const {
+    stbi_image_free(pixels);
+}
+
+/**
+ * @brief Flips the image rows in place. Used instead of `stbi_set_flip_vertically_on_load`, because that flag is a global
+ * shared by all the threads decoding images.
+ */
+static void flip_vertically(uint8_t *pixels, int32_t width, int32_t height, int32_t channels) {
+    const size_t row_size = static_cast<size_t>(width) * channels;
+    for (int32_t row = 0; row < height / 2; ++row) {
+        std::swap_ranges(pixels + row * row_size, pixels + (row + 1) * row_size,
+                         pixels + (height - row - 1) * row_size);
+    }
+}
 
-        CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_2D, texture_id);
-        CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        CHECKED_GL_CALL(glGenerateMipmap, GL_TEXTURE_2D);
+DecodedImage OpenGL::decode_image(const std::filesystem::path &path, bool flip_uvs) {
+    resources::FileContents file = resources::VirtualFileSystem::instance()->read(path);
+    return decode_image(file.bytes(), flip_uvs, path.string());
+}
 
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    } else {
+DecodedImage OpenGL::decode_image(std::span<const std::byte> bytes, bool flip_uvs, std::string_view name) {
+    if (bytes.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
         throw util::EngineError(util::EngineError::Type::AssetLoadingError,
-                                std::format("Failed to load texture {}", path.string()));
+                                std::format("Texture {} is too large to decode", name));
     }
-    return texture_id;
+    DecodedImage image;
+    image.pixels
+         .reset(stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(bytes.data()), static_cast<int>(bytes.size()),
+                                      &image.width, &image.height, &image.channels, 0));
+    if (!image.pixels) {
+        throw util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                std::format("Failed to load texture {}: {}", name, stbi_failure_reason()));
+    }
+    if (flip_uvs) {
+        flip_vertically(image.pixels
+                             .get(), image.width, image.height, image.channels);
+    }
+    return image;
+}
+
+void OpenGL::upload_texture(uint32_t texture_id, const DecodedImage &image) {
+    int32_t format = texture_format(image.channels);
+
+    CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_2D, texture_id);
+    CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE,
+                    image.pixels
+                         .get());
+    CHECKED_GL_CALL(glGenerateMipmap, GL_TEXTURE_2D);
+
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+uint64_t OpenGL::texture_memory_size(uint32_t texture_id, int32_t target) {
+    const bool cube_map = target == GL_TEXTURE_CUBE_MAP;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t internal_format = 0;
+    int32_t min_filter = 0;
+    CHECKED_GL_CALL(glBindTexture, target, texture_id);
+    const GLenum level_target = cube_map ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target;
+    CHECKED_GL_CALL(glGetTexLevelParameteriv, level_target, 0, GL_TEXTURE_WIDTH, &width);
+    CHECKED_GL_CALL(glGetTexLevelParameteriv, level_target, 0, GL_TEXTURE_HEIGHT, &height);
+    CHECKED_GL_CALL(glGetTexLevelParameteriv, level_target, 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+    CHECKED_GL_CALL(glGetTexParameteriv, target, GL_TEXTURE_MIN_FILTER, &min_filter);
+
+    uint64_t texel_size = 4; // The drivers pad the RGB textures to 4 bytes per texel.
+    switch (internal_format) {
+        case GL_RED:
+        case GL_R8: texel_size = 1;
+            break;
+        case GL_RG:
+        case GL_RG8: texel_size = 2;
+            break;
+        default: break;
+    }
+    uint64_t size = static_cast<uint64_t>(width) * height * texel_size * (cube_map ? 6 : 1);
+    if (min_filter != GL_NEAREST && min_filter != GL_LINEAR) {
+        size += size / 3;
+    }
+    return size;
 }
 
 int32_t OpenGL::texture_format(int32_t number_of_channels) {
@@ -92,6 +165,54 @@ uint32_t OpenGL::compile_shader(const std::string &shader_source,
     return shader_id;
 }
 
+void OpenGL::load_extensions(void *(*loader)(const char *name)) {
+    int32_t extension_count = 0;
+    CHECKED_GL_CALL(glGetIntegerv, GL_NUM_EXTENSIONS, &extension_count);
+    for (int32_t i = 0; i < extension_count; ++i) {
+        std::string_view extension(reinterpret_cast<const char *>(CHECKED_GL_CALL(glGetStringi, GL_EXTENSIONS, i)));
+        if (extension == "GL_KHR_parallel_shader_compile" || extension == "GL_ARB_parallel_shader_compile") {
+            g_parallel_shader_compile = true;
+        }
+    }
+    if (g_parallel_shader_compile) {
+        auto max_shader_compiler_threads = reinterpret_cast<PfnMaxShaderCompilerThreadsKhr>(
+                loader("glMaxShaderCompilerThreadsKHR"));
+        if (!max_shader_compiler_threads) {
+            max_shader_compiler_threads = reinterpret_cast<PfnMaxShaderCompilerThreadsKhr>(
+                    loader("glMaxShaderCompilerThreadsARB"));
+        }
+        if (max_shader_compiler_threads) {
+            // 0xFFFFFFFF lets the driver pick the number of compiler threads.
+            max_shader_compiler_threads(0xFFFFFFFF);
+        }
+    }
+}
+
+bool OpenGL::parallel_shader_compile_supported() {
+    return g_parallel_shader_compile;
+}
+
+bool OpenGL::shader_program_ready(uint32_t shader_program_id) {
+    if (!g_parallel_shader_compile) {
+        return true;
+    }
+    int completed = 0;
+    CHECKED_GL_CALL(glGetProgramiv, shader_program_id, COMPLETION_STATUS_KHR, &completed);
+    return completed;
+}
+
+bool OpenGL::shader_program_linked_successfully(uint32_t shader_program_id) {
+    int success;
+    CHECKED_GL_CALL(glGetProgramiv, shader_program_id, GL_LINK_STATUS, &success);
+    return success;
+}
+
+std::string OpenGL::get_link_error_message(uint32_t shader_program_id) {
+    char info_log[512];
+    CHECKED_GL_CALL(glGetProgramInfoLog, shader_program_id, 512, nullptr, info_log);
+    return info_log;
+}
+
 std::string OpenGL::get_compilation_error_message(uint32_t shader_id) {
     char infoLog[512];
     CHECKED_GL_CALL(glGetShaderInfoLog, shader_id, 512, nullptr, infoLog);
@@ -134,32 +255,24 @@ void OpenGL::assert_no_error(std::source_location location) {
 uint32_t face_index(std::string_view name);
 
 uint32_t OpenGL::load_skybox_textures(const std::filesystem::path &path, bool flip_uvs) {
-    RG_GUARANTEE(std::filesystem::is_directory(path),
+    auto file_system = resources::VirtualFileSystem::instance();
+    RG_GUARANTEE(file_system->is_directory(path),
                  "Directory '{}' doesn't exist. Please specify path to be a directory to where the cubemap textures are located. The cubemap textures should be named: right, left, top, bottom, front, back; by their respective faces in the cubemap.",
                  path.string());
     uint32_t texture_id;
     CHECKED_GL_CALL(glGenTextures, 1, &texture_id);
     CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, texture_id);
 
-    int width, height, nr_channels;
-    for (const auto &file: std::filesystem::directory_iterator(path)) {
-        stbi_set_flip_vertically_on_load(flip_uvs);
-        unsigned char *data = stbi_load(absolute(file).c_str(), &width, &height, &nr_channels, 0);
-        defer {
-            stbi_image_free(data);
-        };
-        if (data) {
-            uint32_t i = face_index(file.path()
-                                        .stem()
-                                        .c_str());
-            int32_t format = texture_format(nr_channels);
-            CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format,
-                            GL_UNSIGNED_BYTE,
-                            data);
-        } else {
-            throw util::EngineError(util::EngineError::Type::AssetLoadingError,
-                                    std::format("Failed to load skybox texture {}", path.string()));
-        }
+    for (const auto &file: file_system->list(path)) {
+        DecodedImage image = decode_image(file, flip_uvs);
+        uint32_t i = face_index(file.stem()
+                                    .c_str());
+        int32_t format = texture_format(image.channels);
+        CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, image.width, image.height, 0,
+                        format,
+                        GL_UNSIGNED_BYTE,
+                        image.pixels
+                             .get());
     }
     CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -182,6 +295,61 @@ void OpenGL::clear_buffers() {
     CHECKED_GL_CALL(glClear, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
+Framebuffer OpenGL::create_framebuffer(int32_t width, int32_t height) {
+    Framebuffer framebuffer{.width = width, .height = height};
+    CHECKED_GL_CALL(glGenFramebuffers, 1, &framebuffer.id);
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, framebuffer.id);
+
+    CHECKED_GL_CALL(glGenRenderbuffers, 1, &framebuffer.color);
+    CHECKED_GL_CALL(glBindRenderbuffer, GL_RENDERBUFFER, framebuffer.color);
+    CHECKED_GL_CALL(glRenderbufferStorage, GL_RENDERBUFFER, GL_RGBA8, width, height);
+    CHECKED_GL_CALL(glFramebufferRenderbuffer, GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, framebuffer.color);
+
+    CHECKED_GL_CALL(glGenRenderbuffers, 1, &framebuffer.depth_stencil);
+    CHECKED_GL_CALL(glBindRenderbuffer, GL_RENDERBUFFER, framebuffer.depth_stencil);
+    CHECKED_GL_CALL(glRenderbufferStorage, GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    CHECKED_GL_CALL(glFramebufferRenderbuffer, GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                    framebuffer.depth_stencil);
+
+    GLenum status = CHECKED_GL_CALL(glCheckFramebufferStatus, GL_FRAMEBUFFER);
+    CHECKED_GL_CALL(glBindRenderbuffer, GL_RENDERBUFFER, 0);
+    RG_GUARANTEE(status == GL_FRAMEBUFFER_COMPLETE, "Framebuffer {}x{} is incomplete, status: {:#x}.", width, height,
+                 status);
+    return framebuffer;
+}
+
+void OpenGL::destroy_framebuffer(Framebuffer &framebuffer) {
+    if (framebuffer.id == 0) {
+        return;
+    }
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+    CHECKED_GL_CALL(glDeleteFramebuffers, 1, &framebuffer.id);
+    CHECKED_GL_CALL(glDeleteRenderbuffers, 1, &framebuffer.color);
+    CHECKED_GL_CALL(glDeleteRenderbuffers, 1, &framebuffer.depth_stencil);
+    framebuffer = Framebuffer{};
+}
+
+void OpenGL::bind_framebuffer(const Framebuffer &framebuffer) {
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, framebuffer.id);
+    CHECKED_GL_CALL(glViewport, 0, 0, framebuffer.width, framebuffer.height);
+}
+
+void OpenGL::blit_framebuffer(uint32_t source, uint32_t destination, int32_t width, int32_t height) {
+    CHECKED_GL_CALL(glBindFramebuffer, GL_READ_FRAMEBUFFER, source);
+    CHECKED_GL_CALL(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, destination);
+    CHECKED_GL_CALL(glBlitFramebuffer, 0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+}
+
+std::vector<uint8_t> OpenGL::read_pixels(const Framebuffer &framebuffer) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(framebuffer.width) * framebuffer.height * 4);
+    CHECKED_GL_CALL(glBindFramebuffer, GL_READ_FRAMEBUFFER, framebuffer.id);
+    CHECKED_GL_CALL(glPixelStorei, GL_PACK_ALIGNMENT, 1);
+    CHECKED_GL_CALL(glReadPixels, 0, 0, framebuffer.width, framebuffer.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                    pixels.data());
+    return pixels;
+}
+
 uint32_t face_index(std::string_view name) {
     if (name == "right") {
         return 0;
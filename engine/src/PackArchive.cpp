@@ -0,0 +1,375 @@
+#include <engine/resources/PackArchive.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Utils.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+namespace engine::resources {
+// The pack structs are mapped straight from the file, which is little-endian.
+static_assert(std::endian::native == std::endian::little, "Packs are only supported on little-endian platforms.");
+
+/**
+* @brief LZ4 block format: sequences of a token, literals, a 2 byte match offset, and a match length.
+* Compression is done once by the pack tool, so it's a simple greedy parser, the decompression is what has to be fast.
+*/
+namespace lz4 {
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MATCH_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+/**
+* @brief Each compressed byte decodes to at most 255 bytes, when it extends the length of a match.
+*/
+constexpr uint64_t MAX_EXPANSION = 255;
+constexpr uint32_t HASH_BITS = 16;
+
+static uint32_t read32(const uint8_t *source) {
+    uint32_t value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static void write_length(std::vector<std::byte> &out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(std::byte{255});
+    }
+    out.push_back(static_cast<std::byte>(length));
+}
+
+static void write_sequence(std::vector<std::byte> &out, std::span<const std::byte> literals, size_t match_length,
+                           size_t offset) {
+    const size_t match_code = match_length ? match_length - MIN_MATCH : 0;
+    out.push_back(static_cast<std::byte>(std::min<size_t>(literals.size(), 15) << 4 | std::min<size_t>(match_code, 15)));
+    if (literals.size() >= 15) {
+        write_length(out, literals.size() - 15);
+    }
+    out.insert(out.end(), literals.begin(), literals.end());
+    if (match_length == 0) {
+        return;
+    }
+    out.push_back(static_cast<std::byte>(offset & 0xff));
+    out.push_back(static_cast<std::byte>(offset >> 8));
+    if (match_code >= 15) {
+        write_length(out, match_code - 15);
+    }
+}
+
+static std::vector<std::byte> compress(std::span<const std::byte> input) {
+    std::vector<std::byte> out;
+    out.reserve(input.size() + input.size() / 255 + 16);
+    const auto *source = reinterpret_cast<const uint8_t *>(input.data());
+    const size_t size = input.size();
+    size_t anchor = 0;
+    if (size > MATCH_LIMIT) {
+        // Positions + 1 of the last 4 bytes with the hash, 0 is empty.
+        std::vector<uint32_t> table(1u << HASH_BITS, 0);
+        const size_t match_start_limit = size - MATCH_LIMIT;
+        const size_t match_end_limit = size - LAST_LITERALS;
+        size_t position = 0;
+        while (position < match_start_limit) {
+            uint32_t sequence = read32(source + position);
+            uint32_t &slot = table[(sequence * 2654435761u) >> (32 - HASH_BITS)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(position + 1);
+            if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || read32(source + candidate - 1) != sequence) {
+                ++position;
+                continue;
+            }
+            size_t match = candidate - 1;
+            size_t length = MIN_MATCH;
+            while (position + length < match_end_limit && source[match + length] == source[position + length]) {
+                ++length;
+            }
+            write_sequence(out, input.subspan(anchor, position - anchor), length, position - match);
+            position += length;
+            anchor = position;
+        }
+    }
+    write_sequence(out, input.subspan(anchor), 0, 0);
+    return out;
+}
+
+/**
+* @brief Decompresses the `input` into exactly `output.size()` bytes. Every length is checked, so a corrupted payload
+* fails instead of reading or writing out of bounds.
+*/
+static bool decompress(std::span<const std::byte> input, std::span<std::byte> output) {
+    const auto *in = reinterpret_cast<const uint8_t *>(input.data());
+    auto *out = reinterpret_cast<uint8_t *>(output.data());
+    const size_t in_size = input.size();
+    const size_t out_size = output.size();
+    size_t ip = 0;
+    size_t op = 0;
+    auto read_length = [&](size_t &length) {
+        uint8_t byte;
+        do {
+            if (ip >= in_size) {
+                return false;
+            }
+            byte = in[ip++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+    while (ip < in_size) {
+        const uint8_t token = in[ip++];
+        size_t literals = token >> 4;
+        if (literals == 15 && !read_length(literals)) {
+            return false;
+        }
+        if (literals > in_size - ip || literals > out_size - op) {
+            return false;
+        }
+        std::memcpy(out + op, in + ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == in_size) {
+            break;
+        }
+        if (in_size - ip < 2) {
+            return false;
+        }
+        const size_t offset = in[ip] | in[ip + 1] << 8;
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15 && !read_length(length)) {
+            return false;
+        }
+        length += MIN_MATCH;
+        if (offset == 0 || offset > op || length > out_size - op) {
+            return false;
+        }
+        if (offset >= length) {
+            std::memcpy(out + op, out + op - offset, length);
+            op += length;
+        } else {
+            // The match overlaps the bytes it produces, like a run of a repeated pattern.
+            for (size_t end = op + length; op < end; ++op) {
+                out[op] = out[op - offset];
+            }
+        }
+    }
+    return op == out_size;
+}
+} // namespace lz4
+
+PackArchive::PackArchive(const std::filesystem::path &path)
+        : m_file(path, util::MappedFile::Access::Random) {
+    auto invalid = [&](std::string_view reason) {
+        return util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                 std::format("{} is not a valid pack: {}.", path.string(), reason));
+    };
+    std::span<const std::byte> bytes = m_file.bytes();
+    PackHeader header;
+    if (bytes.size() < sizeof(header)) {
+        throw invalid("the file is too small");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != PackHeader::MAGIC) {
+        throw invalid("wrong magic");
+    }
+    if (header.version != PackHeader::VERSION) {
+        throw invalid(std::format("version {}, expected {}", header.version, PackHeader::VERSION));
+    }
+    if (header.index_offset % alignof(PackEntry) != 0 || header.index_offset > bytes.size() ||
+        header.entry_count > (bytes.size() - header.index_offset) / sizeof(PackEntry)) {
+        throw invalid("the index is out of bounds");
+    }
+    if (header.names_offset > bytes.size() || header.names_size > bytes.size() - header.names_offset) {
+        throw invalid("the names are out of bounds");
+    }
+    m_entries = std::span(reinterpret_cast<const PackEntry *>(bytes.data() + header.index_offset), header.entry_count);
+    m_names = std::string_view(reinterpret_cast<const char *>(bytes.data() + header.names_offset), header.names_size);
+    for (const auto &entry: m_entries) {
+        if (entry.offset > bytes.size() || entry.size > bytes.size() - entry.offset ||
+            entry.path_offset > m_names.size() || entry.path_size > m_names.size() - entry.path_offset) {
+            throw invalid("an entry is out of bounds");
+        }
+        if (!entry.compressed() && entry.size != entry.original_size) {
+            throw invalid(std::format("the entry {} has a wrong size", this->path(entry)));
+        }
+        // Checked here, so that reading a corrupted entry doesn't allocate an arbitrary original size.
+        if (entry.compressed() && entry.original_size > entry.size * lz4::MAX_EXPANSION) {
+            throw invalid(std::format("the entry {} has a wrong original size", this->path(entry)));
+        }
+    }
+    if (!std::ranges::is_sorted(m_entries, {}, &PackEntry::path_hash)) {
+        throw invalid("the index is not sorted");
+    }
+    for (const auto &entry: m_entries) {
+        std::string_view directory = this->path(entry);
+        for (auto slash = directory.rfind('/'); slash != std::string_view::npos; slash = directory.rfind('/')) {
+            directory = directory.substr(0, slash);
+            m_directory_hashes.push_back(util::fnv1a(directory));
+        }
+    }
+    std::ranges::sort(m_directory_hashes);
+    auto duplicates = std::ranges::unique(m_directory_hashes);
+    m_directory_hashes.erase(duplicates.begin(), duplicates.end());
+    spdlog::info("[PackArchive]: mounted {} with {} files", path.string(), m_entries.size());
+}
+
+const PackEntry *PackArchive::find(std::string_view path) const {
+    const uint64_t hash = util::fnv1a(path);
+    auto it = std::ranges::lower_bound(m_entries, hash, {}, &PackEntry::path_hash);
+    for (; it != m_entries.end() && it->path_hash == hash; ++it) {
+        if (this->path(*it) == path) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+std::span<const std::byte> PackArchive::payload(const PackEntry &entry) const {
+    return m_file.bytes()
+                 .subspan(entry.offset, entry.size);
+}
+
+std::vector<std::byte> PackArchive::read(const PackEntry &entry) const {
+    std::span<const std::byte> stored = payload(entry);
+    if (!entry.compressed()) {
+        return {stored.begin(), stored.end()};
+    }
+    std::vector<std::byte> result(entry.original_size);
+    if (!lz4::decompress(stored, result)) {
+        throw util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                std::format("The entry {} in the pack {} is corrupted.", path(entry),
+                                            file_path().string()));
+    }
+    return result;
+}
+
+std::string_view PackArchive::path(const PackEntry &entry) const {
+    return m_names.substr(entry.path_offset, entry.path_size);
+}
+
+bool PackArchive::contains_directory(std::string_view directory) const {
+    return std::ranges::binary_search(m_directory_hashes, util::fnv1a(directory));
+}
+
+std::string PackArchive::normalize(const std::filesystem::path &path) {
+    std::filesystem::path relative = path.is_absolute() ? path.lexically_relative(std::filesystem::current_path())
+                                                        : path;
+    std::string result = relative.lexically_normal()
+                                 .generic_string();
+    if (result.ends_with('/')) {
+        result.pop_back();
+    }
+    if (result == ".") {
+        result.clear();
+    }
+    return result;
+}
+
+PackWriter::PackWriter(bool compress, uint32_t alignment)
+        : m_compress(compress)
+        , m_alignment(alignment) {
+    RG_GUARANTEE(std::has_single_bit(alignment) && alignment >= alignof(PackEntry),
+                 "Pack alignment {} must be a power of two of at least {}.", alignment, alignof(PackEntry));
+}
+
+void PackWriter::add_file(const std::filesystem::path &path) {
+    m_files.push_back(path);
+}
+
+void PackWriter::add_directory(const std::filesystem::path &directory) {
+    RG_GUARANTEE(std::filesystem::is_directory(directory), "{} is not a directory.", directory.string());
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry: std::filesystem::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+    // Sorted, so that packing the same directory twice produces the same pack.
+    std::ranges::sort(files);
+    m_files.insert(m_files.end(), files.begin(), files.end());
+}
+
+/**
+* @brief Formats that are already compressed, compressing them again only costs time when loading.
+*/
+static bool is_compressed_format(const std::filesystem::path &path) {
+    std::string extension = path.extension()
+                                .string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return util::alg::contains(std::array<std::string_view, 7>{".png", ".jpg", ".jpeg", ".gif", ".webp", ".ogg", ".mp3"},
+                               extension);
+}
+
+void PackWriter::write(const std::filesystem::path &output) const {
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    RG_GUARANTEE(out.good(), "Failed to open {} for writing.", output.string());
+    auto pad_to = [&](uint64_t alignment) {
+        static constexpr std::array<char, 64> zeros{};
+        uint64_t position = out.tellp();
+        for (uint64_t padding = (alignment - position % alignment) % alignment; padding > 0;) {
+            uint64_t count = std::min<uint64_t>(padding, zeros.size());
+            out.write(zeros.data(), count);
+            padding -= count;
+        }
+        return static_cast<uint64_t>(out.tellp());
+    };
+
+    PackHeader header{};
+    header.magic = PackHeader::MAGIC;
+    header.version = PackHeader::VERSION;
+    header.alignment = m_alignment;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<PackEntry> entries;
+    entries.reserve(m_files.size());
+    std::string names;
+    uint64_t original_bytes = 0;
+    for (const auto &file_path: m_files) {
+        std::string path = PackArchive::normalize(file_path);
+        util::MappedFile file(file_path);
+        std::span<const std::byte> payload = file.bytes();
+        std::vector<std::byte> compressed;
+        PackEntry entry{};
+        if (m_compress && !file.empty() && !is_compressed_format(file_path)) {
+            compressed = lz4::compress(file.bytes());
+            if (compressed.size() <= file.size() * (1.0 - MIN_COMPRESSION_SAVING)) {
+                payload = compressed;
+                entry.flags |= PackEntry::Compressed;
+            }
+        }
+        entry.path_hash = util::fnv1a(path);
+        entry.offset = pad_to(m_alignment);
+        entry.size = payload.size();
+        entry.original_size = file.size();
+        entry.path_offset = static_cast<uint32_t>(names.size());
+        entry.path_size = static_cast<uint32_t>(path.size());
+        out.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        names += path;
+        entries.push_back(entry);
+        original_bytes += file.size();
+    }
+
+    std::ranges::sort(entries, {}, &PackEntry::path_hash);
+    auto path_of = [&](const PackEntry &entry) {
+        return std::string_view(names).substr(entry.path_offset, entry.path_size);
+    };
+    auto duplicate = std::ranges::adjacent_find(entries, {}, &PackEntry::path_hash);
+    RG_GUARANTEE(duplicate == entries.end(), "Files {} and {} have the same path hash, rename one of them.",
+                 path_of(*duplicate), path_of(*std::next(duplicate)));
+
+    header.entry_count = static_cast<uint32_t>(entries.size());
+    header.index_offset = pad_to(alignof(PackEntry));
+    out.write(reinterpret_cast<const char *>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+    header.names_offset = out.tellp();
+    header.names_size = names.size();
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    const uint64_t pack_bytes = out.tellp();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    RG_GUARANTEE(out.good(), "Failed to write {}.", output.string());
+    spdlog::info("[PackWriter]: wrote {} files, {} bytes into {}, {} bytes", entries.size(), original_bytes,
+                 output.string(), pack_bytes);
+}
+
+} // namespace engine::resources
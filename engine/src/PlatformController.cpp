@@ -3,18 +3,29 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <engine/graphics/GraphicsController.hpp>
 #include <engine/platform/PlatformController.hpp>
 #include <engine/util/Utils.hpp>
 
 #include <spdlog/spdlog.h>
+#include <chrono>
 #include <utility>
+#include <engine/util/ArgParser.hpp>
 #include <engine/util/Configuration.hpp>
 
 namespace engine::platform {
 static std::array<std::string_view, KEY_COUNT> g_engine_key_to_string;
 static std::array<int, KEY_COUNT> g_engine_to_glfw_key;
 static std::array<KeyId, GLFW_KEY_LAST + 1> g_glfw_key_to_engine;
+/**
+* @brief The second engine key of the GLFW codes that have two, for example MOUSE_BUTTON_1 and MOUSE_BUTTON_LEFT.
+*/
+static std::array<KeyId, GLFW_KEY_LAST + 1> g_glfw_key_to_engine_alias;
 static MousePosition g_mouse_position;
+/**
+* @brief Mouse input received since the frame's mouse state was taken, moved into the `g_mouse_position` in the poll_events.
+*/
+static MousePosition g_pending_mouse_position;
 
 static void glfw_mouse_callback(GLFWwindow *window, double x, double y);
 
@@ -28,29 +39,43 @@ static void glfw_window_close_callback(GLFWwindow *window);
 
 static void glfw_mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
 
-static int glfw_platform_action(GLFWwindow *window, int glfw_key_code);
+static void glfw_window_focus_callback(GLFWwindow *window, int focused);
+
+static void glfw_window_iconify_callback(GLFWwindow *window, int iconified);
+
+static void glfw_window_refresh_callback(GLFWwindow *window);
+
+/**
+* @brief Frames drawn after an input event. ImGui needs another frame after the input to settle the hover state and the layout.
+*/
+static constexpr uint32_t INPUT_REDRAW_FRAMES = 2;
+
+static int64_t fps_to_interval_ns(double fps) {
+    return fps > 0.0 ? std::llround(1e9 / fps) : 0;
+}
 
 void initialize_key_maps();
 
 void PlatformController::initialize() {
-    if (glfwPlatformSupported(GLFW_PLATFORM_X11)) {
-        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
-    } else if (glfwPlatformSupported(GLFW_PLATFORM_WAYLAND)) {
-        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
-    } else if (glfwPlatformSupported(GLFW_PLATFORM_WIN32)) {
-        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WIN32);
-    }
+    util::Configuration::json &config = util::Configuration::config();
+    m_headless = util::ArgParser::instance()->has_flag("--headless") || config["window"].value("headless", false);
+    select_platform();
     bool glfw_initialized = glfwInit();
+    if (!glfw_initialized && m_headless) {
+        // GLFW never picks the null platform by itself, so it has to be requested when there is no display to connect to.
+        spdlog::info("No display available, using the GLFW null platform.");
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        glfw_initialized = glfwInit();
+    }
     RG_GUARANTEE(glfw_initialized, "GLFW platform failed to initialize_controllers.");
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    util::Configuration::json &config = util::Configuration::config();
     int window_width = config["window"]["width"];
     int window_height = config["window"]["height"];
     std::string window_title = config["window"]["title"];
-    GLFWwindow *handle = glfwCreateWindow(window_width, window_height, window_title.c_str(), nullptr, nullptr);
+    GLFWwindow *handle = create_window(window_width, window_height, window_title);
     RG_GUARANTEE(handle, "GLFW3 platform failed to create a Window.");
     m_window = Window(handle, window_width, window_height, window_title);
 
@@ -61,18 +86,118 @@ void PlatformController::initialize() {
     glfwSetFramebufferSizeCallback(m_window.handle_(), glfw_framebuffer_size_callback);
     glfwSetMouseButtonCallback(m_window.handle_(), glfw_mouse_button_callback);
     glfwSetWindowCloseCallback(m_window.handle_(), glfw_window_close_callback);
+    glfwSetWindowFocusCallback(m_window.handle_(), glfw_window_focus_callback);
+    glfwSetWindowIconifyCallback(m_window.handle_(), glfw_window_iconify_callback);
+    glfwSetWindowRefreshCallback(m_window.handle_(), glfw_window_refresh_callback);
+
+    const auto &window_config = config["window"];
+    std::string vsync = window_config.value("vsync", std::string("on"));
+    RG_GUARANTEE(vsync == "off" || vsync == "on" || vsync == "adaptive",
+                 "window.vsync must be \"off\", \"on\", or \"adaptive\", got \"{}\".", vsync);
+    VsyncMode vsync_mode = vsync == "off" ? VsyncMode::Off : vsync == "on" ? VsyncMode::On : VsyncMode::Adaptive;
+    if (m_headless) {
+        // Nobody sees the frames, so nothing should wait for a display refresh.
+        vsync_mode = VsyncMode::Off;
+    }
+    apply_swap_interval(vsync_mode, window_config.value("swap_interval", 1));
 
     int major, minor, revision;
     glfwGetVersion(&major, &minor, &revision);
-    spdlog::info("Platform[GLFW {}.{}.{}]", major, minor, revision);
+    spdlog::info("Platform[GLFW {}.{}.{}]{}", major, minor, revision, m_headless ? " headless" : "");
+    const auto engine_config = config.value("engine", util::Configuration::json::object());
+    double fixed_update_rate = engine_config.value("fixed_update_rate", 60.0);
+    RG_GUARANTEE(fixed_update_rate > 0.0, "engine.fixed_update_rate must be positive, got {}.", fixed_update_rate);
+    m_frame_time.fixed_dt = static_cast<float>(1.0 / fixed_update_rate);
+    // Converted from the float, so that a replayed dt equal to the fixed_dt is exactly one step.
+    m_fixed_dt_ns = std::llround(static_cast<double>(m_frame_time.fixed_dt) * 1e9);
+    m_max_fixed_steps = engine_config.value("max_fixed_steps", 8u);
+    m_frame_limiter.set_target_fps(engine_config.value("target_fps", 0.0));
+    m_render_on_demand = engine_config.value("render_on_demand", false);
+    m_idle_timeout = engine_config.value("idle_timeout_ms", 500.0) / 1000.0;
+    m_unfocused_interval_ns = fps_to_interval_ns(engine_config.value("unfocused_fps", 0.0));
+    m_minimized_interval_ns = fps_to_interval_ns(engine_config.value("minimized_fps", 5.0));
+    const auto frame_stats_config = engine_config.value("frame_stats", util::Configuration::json::object());
+    m_frame_stats.configure(frame_stats_config.value("hitch_factor", 2.0),
+                            frame_stats_config.value("hitch_min_ms", 4.0));
+    m_start_ns = sample_time_ns();
+    m_frame_wall_ns = -1;
+
     initialize_key_maps();
     m_keys.resize(KEY_COUNT);
     for (int key = 0; key < m_keys.size(); ++key) {
         m_keys[key].m_key = static_cast<KeyId>(key);
     }
+    m_events.reserve(64);
+    initialize_input_recording();
+}
+
+void PlatformController::initialize_input_recording() {
+    auto args = util::ArgParser::instance();
+    auto record_path = args->arg<std::string>("--record-input").value();
+    auto replay_path = args->arg<std::string>("--replay-input").value();
+    RG_GUARANTEE(record_path.empty() || replay_path.empty(),
+                 "--record-input and --replay-input can't be used together.");
+    if (!replay_path.empty()) {
+        m_input_replay = std::make_unique<InputReplay>(replay_path);
+        const auto &header = m_input_replay->header();
+        if (header.window_width != m_window.width() || header.window_height != m_window.height()) {
+            spdlog::warn("Input recording {} was made in a {}x{} window, replaying it in {}x{}.", replay_path,
+                         header.window_width, header.window_height, m_window.width(), m_window.height());
+        }
+        spdlog::info("Replaying input from {} with dt={}s.", replay_path, header.replay_dt);
+    }
+    if (!record_path.empty()) {
+        m_input_recorder = std::make_unique<InputRecorder>(record_path, InputRecordingHeader{
+                                                                   .replay_dt = m_frame_time.fixed_dt,
+                                                                   .window_width = m_window.width(),
+                                                                   .window_height = m_window.height()});
+        spdlog::info("Recording input to {}.", record_path);
+    }
+}
+
+void PlatformController::select_platform() {
+    if (glfwPlatformSupported(GLFW_PLATFORM_X11)) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
+    } else if (glfwPlatformSupported(GLFW_PLATFORM_WAYLAND)) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
+    } else if (glfwPlatformSupported(GLFW_PLATFORM_WIN32)) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WIN32);
+    }
+}
+
+GLFWwindow *PlatformController::create_window(int width, int height, const std::string &title) {
+    if (!m_headless) {
+        return glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+    }
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (glfwGetPlatform() != GLFW_PLATFORM_NULL) {
+        return glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+    }
+    // Without a display server the context has to come from EGL (surfaceless on Mesa), or from the software OSMesa.
+    for (int context_api: {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API}) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, context_api);
+        if (GLFWwindow *handle = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr)) {
+            return handle;
+        }
+        spdlog::warn("Headless platform failed to create an OpenGL context with the {} API.",
+                     context_api == GLFW_EGL_CONTEXT_API ? "EGL" : "OSMesa");
+    }
+    return nullptr;
 }
 
 void PlatformController::terminate() {
+    if (m_frame_stats.frame_count() > 0) {
+        auto summary = m_frame_stats.summary();
+        spdlog::info("Frame times of the last {} frames: p50 {:.2f} ms, p95 {:.2f} ms, p99 {:.2f} ms, "
+                     "jitter {:.2f} ms. {} hitches in {} frames.",
+                     std::min<uint64_t>(m_frame_stats.frame_count(), FrameStats::WINDOW), summary.p50_ms,
+                     summary.p95_ms, summary.p99_ms, summary.jitter_ms, m_frame_stats.hitch_count(),
+                     m_frame_stats.frame_count());
+    }
+    if (m_input_recorder) {
+        spdlog::info("Recorded {} frames of input.", m_input_recorder->frame_count());
+        m_input_recorder.reset();
+    }
     m_platform_event_observers.clear();
     if (m_window.handle_()) {
         glfwDestroyWindow(m_window.handle_());
@@ -81,31 +206,254 @@ void PlatformController::terminate() {
 }
 
 bool PlatformController::loop() {
-    m_frame_time.previous = m_frame_time.current;
-    m_frame_time.current = glfwGetTime();
-    m_frame_time.dt = m_frame_time.current - m_frame_time.previous;
+    m_frame_limiter.wait();
+    int64_t now_ns = sample_time_ns() - m_start_ns;
+    // The first frame would include the initialization of the controllers after the platform,
+    // and a throttled frame is long on purpose.
+    if (m_frame_wall_ns >= 0 && !m_throttled) {
+        m_frame_stats.add_frame(now_ns - m_frame_wall_ns, now_ns);
+    }
+    m_frame_wall_ns = now_ns;
+
+    m_frame_time.previous_ns = m_frame_time.current_ns;
+    if (m_input_replay) {
+        if (!m_input_replay->next(m_input_frame)) {
+            spdlog::info("Input replay finished after {} frames, the recorded run took {:.3f}s.",
+                         m_input_replay->frame_count(), m_input_replay->recorded_time());
+            return false;
+        }
+        m_frame_time.dt = m_input_replay->header().replay_dt;
+        m_frame_time.dt_ns = std::llround(static_cast<double>(m_frame_time.dt) * 1e9);
+        m_frame_time.current_ns = m_frame_time.previous_ns + m_frame_time.dt_ns;
+    } else {
+        m_frame_time.current_ns = now_ns;
+        m_frame_time.dt_ns = m_frame_time.current_ns - m_frame_time.previous_ns;
+        m_frame_time.dt = static_cast<float>(static_cast<double>(m_frame_time.dt_ns) / 1e9);
+    }
+    m_frame_time.previous = static_cast<double>(m_frame_time.previous_ns) / 1e9;
+    m_frame_time.current = static_cast<double>(m_frame_time.current_ns) / 1e9;
+    advance_fixed_steps();
 
     return !glfwWindowShouldClose(m_window.handle_());
 }
 
+void PlatformController::advance_fixed_steps() {
+    // Integer nanoseconds, so the accumulator doesn't drift however long the app runs.
+    m_fixed_accumulator_ns += m_frame_time.dt_ns;
+    auto steps = static_cast<uint32_t>(m_fixed_accumulator_ns / m_fixed_dt_ns);
+    if (steps > m_max_fixed_steps) {
+        // The simulation can't keep up, so it slows down instead of taking more and more steps every frame.
+        steps = m_max_fixed_steps;
+        m_fixed_accumulator_ns = m_fixed_dt_ns * steps;
+    }
+    m_fixed_accumulator_ns -= m_fixed_dt_ns * steps;
+    m_frame_time.fixed_steps = steps;
+    m_frame_time.alpha = static_cast<float>(static_cast<double>(m_fixed_accumulator_ns) /
+                                            static_cast<double>(m_fixed_dt_ns));
+}
+
 void PlatformController::poll_events() {
-    g_mouse_position.dx = g_mouse_position.dy = 0.0f;
-    g_mouse_position.scroll = 0.0f;
+    // The GLFW callbacks queue the events and update the key bitset, nothing is dispatched while polling.
+    // Events received by a late latch in the previous frame are already in the queue.
+    m_present_needed = false;
+    wait_events();
+    m_input_sample_ns = sample_time_ns();
+    g_mouse_position = g_pending_mouse_position;
+    g_pending_mouse_position.dx = g_pending_mouse_position.dy = 0.0f;
+    g_pending_mouse_position.scroll = 0.0f;
+    if (m_input_replay) {
+        replay_input_frame();
+    }
+    update_keys();
+    if (m_input_recorder) {
+        record_input_frame();
+    }
+    if (!m_events.empty() || m_keys_down.any() || m_keys_transitioning.any()) {
+        request_redraw(INPUT_REDRAW_FRAMES);
+    }
+    if (!m_events.empty()) {
+        for (auto &observer: m_platform_event_observers) {
+            observer->on_events(m_events);
+        }
+    }
+    m_events.clear();
+    m_key_events.reset();
+}
+
+void PlatformController::wait_events() {
+    m_throttled = false;
+    if (m_input_replay) {
+        // The replay runs as fast as it can.
+        glfwPollEvents();
+        return;
+    }
+    if (m_render_on_demand && !is_redraw_needed()) {
+        glfwWaitEventsTimeout(m_idle_timeout);
+        // The frame begins when the wait ends, so that the time spent idle doesn't show up in the next frame's dt.
+        int64_t now_ns = sample_time_ns() - m_start_ns;
+        m_frame_time.current_ns = now_ns;
+        m_frame_time.current = static_cast<double>(now_ns) / 1e9;
+        m_frame_wall_ns = now_ns;
+        return;
+    }
+    int64_t interval_ns = throttle_interval_ns();
+    if (interval_ns > 0 && m_frame_wall_ns >= 0) {
+        // The callbacks only queue the events, so waiting until the end of the throttled frame delays their handling,
+        // but doesn't lose them. The wait stops early if the window gets the focus back.
+        int64_t deadline_ns = m_start_ns + m_frame_wall_ns + interval_ns;
+        for (int64_t now_ns = sample_time_ns(); now_ns < deadline_ns && throttle_interval_ns() > 0;
+             now_ns = sample_time_ns()) {
+            glfwWaitEventsTimeout(static_cast<double>(deadline_ns - now_ns) / 1e9);
+            m_throttled = true;
+        }
+        if (m_throttled) {
+            return;
+        }
+    }
     glfwPollEvents();
+}
+
+int64_t PlatformController::throttle_interval_ns() const {
+    if (m_headless) {
+        return 0;
+    }
+    if (m_minimized) {
+        return m_minimized_interval_ns;
+    }
+    return m_focused ? 0 : m_unfocused_interval_ns;
+}
+
+void PlatformController::end_draw() {
+    if (m_redraw_frames > 0) {
+        --m_redraw_frames;
+    }
+}
+
+void PlatformController::set_render_on_demand(bool enabled) {
+    m_render_on_demand = enabled;
+    request_redraw();
+}
+
+void PlatformController::wake_up() {
+    glfwPostEmptyEvent();
+}
+
+MousePosition PlatformController::late_latch_mouse() {
+    if (m_input_replay || m_input_recorder) {
+        // The recording holds the mouse state of poll_events, so a late latch would make the replay diverge.
+        return MousePosition{g_mouse_position.x, g_mouse_position.y, 0.0f, 0.0f, 0.0f};
+    }
+    glfwPollEvents();
+    m_input_sample_ns = sample_time_ns();
+    MousePosition latched = g_pending_mouse_position;
+    latched.scroll = 0.0f;
+    // The latched movement is consumed, the next frame's mouse state has only the movement after this point.
+    g_pending_mouse_position.dx = g_pending_mouse_position.dy = 0.0f;
+    return latched;
+}
+
+int64_t PlatformController::sample_time_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+                                                                        .time_since_epoch()).count();
+}
+
+void PlatformController::update_keys() {
+    auto dirty = m_key_events | m_keys_transitioning;
+    m_keys_transitioning.reset();
+    if (dirty.none()) {
+        return;
+    }
     for (int i = 0; i < KEY_COUNT; ++i) {
-        update_key(key_ref(static_cast<KeyId>(i)));
+        if (!dirty[i]) {
+            continue;
+        }
+        Key &key = m_keys[i];
+        update_key(key, m_keys_down[i]);
+        if (key.state() == Key::State::JustPressed || key.state() == Key::State::JustReleased) {
+            m_keys_transitioning.set(i);
+        }
     }
 }
 
-void PlatformController::swap_buffers() {
-    glfwSwapBuffers(m_window.handle_());
+void PlatformController::set_key_down(KeyId key, bool down) {
+    m_keys_down[key] = down;
+    m_key_events.set(key);
+    m_events.push_back(PlatformEvent{
+            .type = down ? PlatformEvent::Type::KeyPress : PlatformEvent::Type::KeyRelease,
+            .key = key});
+}
+
+void PlatformController::record_input_frame() {
+    m_input_frame.dt = m_frame_time.dt;
+    m_input_frame.mouse = g_mouse_position;
+    m_input_frame.keys_down = m_keys_down;
+    m_input_recorder->write(m_input_frame);
+    m_input_frame.resize_width = m_input_frame.resize_height = 0;
+}
+
+void PlatformController::replay_input_frame() {
+    const InputFrame &frame = m_input_frame;
+    if (frame.resize_width > 0 && frame.resize_height > 0) {
+        _platform_on_framebuffer_resize(frame.resize_width, frame.resize_height);
+    }
+    if (frame.mouse.x != g_mouse_position.x || frame.mouse.y != g_mouse_position.y) {
+        m_events.push_back(PlatformEvent{
+                .type = PlatformEvent::Type::MouseMove,
+                .x = frame.mouse.x, .y = frame.mouse.y,
+                .dx = frame.mouse.dx, .dy = frame.mouse.dy});
+    }
+    if (frame.mouse.scroll != 0.0f) {
+        m_events.push_back(PlatformEvent{.type = PlatformEvent::Type::Scroll, .y = frame.mouse.scroll});
+    }
+    g_mouse_position = frame.mouse;
+    g_pending_mouse_position.x = frame.mouse.x;
+    g_pending_mouse_position.y = frame.mouse.y;
+    auto changed = frame.keys_down ^ m_keys_down;
+    if (changed.any()) {
+        for (int i = 0; i < KEY_COUNT; ++i) {
+            if (changed[i]) {
+                set_key_down(static_cast<KeyId>(i), frame.keys_down[i]);
+            }
+        }
+    }
+}
+
+void PlatformController::set_vsync(VsyncMode mode, int interval) {
+    if (m_headless) {
+        return;
+    }
+    core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+        apply_swap_interval(mode, interval);
+    });
+}
+
+void PlatformController::apply_swap_interval(VsyncMode mode, int interval) {
+    interval = std::max(interval, 1);
+    if (mode == VsyncMode::Adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        spdlog::warn("Adaptive vsync isn't supported by the driver, using vsync on.");
+        mode = VsyncMode::On;
+    }
+    switch (mode) {
+        case VsyncMode::Off: glfwSwapInterval(0);
+            break;
+        case VsyncMode::On: glfwSwapInterval(interval);
+            break;
+        // A negative interval lets the driver swap a late frame without waiting for the next refresh.
+        case VsyncMode::Adaptive: glfwSwapInterval(-interval);
+            break;
+    }
+    m_vsync = mode;
 }
 
-int glfw_platform_action(GLFWwindow *window, int glfw_key_code) {
-    if (glfw_key_code >= GLFW_MOUSE_BUTTON_1 && glfw_key_code <= GLFW_MOUSE_BUTTON_LAST) {
-        return glfwGetMouseButton(window, glfw_key_code);
+void PlatformController::swap_buffers() {
+    if (m_headless) {
+        return;
     }
-    return glfwGetKey(window, glfw_key_code);
+    // With the render thread the swap is queued after the frame's draw calls.
+    core::Controller::get<graphics::GraphicsController>()->submit([window = m_window.handle_()] {
+        glfwSwapBuffers(window);
+    });
 }
 
 /**
@@ -117,11 +465,10 @@ int glfw_platform_action(GLFWwindow *window, int glfw_key_code) {
  * - Pressed -> JustReleased if the key is released.
  * - JustReleased -> Released if the key is released.
  * @param key_data The key to update.
+ * @param down Whether the key is down in the current frame.
  */
-void PlatformController::update_key(Key &key_data) const {
-    int engine_key_code = key_data.id();
-    int glfw_key_code = g_engine_to_glfw_key.at(engine_key_code);
-    int action = glfw_platform_action(m_window.handle_(), glfw_key_code);
+void PlatformController::update_key(Key &key_data, bool down) const {
+    int action = down ? GLFW_PRESS : GLFW_RELEASE;
     switch (key_data.state()) {
         case Key::State::Released: {
             if (action == GLFW_PRESS) {
@@ -191,37 +538,49 @@ void PlatformController::register_platform_event_observer(std::unique_ptr<Platfo
 }
 
 void PlatformController::_platform_on_mouse(double x, double y) {
-    double last_x = g_mouse_position.x;
-    double last_y = g_mouse_position.y;
-    g_mouse_position.dx = x - last_x;
-    g_mouse_position.dy = last_y - y; // because in glfw the top left corner is the (0,0)
-    g_mouse_position.x = x;
-    g_mouse_position.y = y;
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_mouse_move(g_mouse_position);
-    }
+    auto &mouse = g_pending_mouse_position;
+    auto dx = static_cast<float>(x - mouse.x);
+    auto dy = static_cast<float>(mouse.y - y); // because in glfw the top left corner is the (0,0)
+    // A frame can have several mouse events, the frame's movement is their sum.
+    mouse.dx += dx;
+    mouse.dy += dy;
+    mouse.x = x;
+    mouse.y = y;
+    m_events.push_back(PlatformEvent{
+            .type = PlatformEvent::Type::MouseMove,
+            .x = mouse.x, .y = mouse.y,
+            .dx = dx, .dy = dy});
 }
 
 void PlatformController::_platform_on_keyboard(int key_code, int action) {
-    const Key result = key(g_glfw_key_to_engine[key_code]);
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_key(result);
+    if (key_code < 0 || key_code > GLFW_KEY_LAST || action == GLFW_REPEAT) {
+        return;
+    }
+    bool down = action == GLFW_PRESS;
+    if (KeyId key = g_glfw_key_to_engine[key_code]; key != KEY_COUNT) {
+        set_key_down(key, down);
+    }
+    if (KeyId alias = g_glfw_key_to_engine_alias[key_code]; alias != KEY_COUNT) {
+        m_keys_down[alias] = down;
+        m_key_events.set(alias);
     }
 }
 
 void PlatformController::_platform_on_scroll(double x, double y) {
-    g_mouse_position.scroll = y;
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_scroll(g_mouse_position);
-    }
+    g_pending_mouse_position.scroll += y;
+    m_events.push_back(PlatformEvent{
+            .type = PlatformEvent::Type::Scroll,
+            .x = static_cast<float>(x), .y = static_cast<float>(y)});
 }
 
 void PlatformController::_platform_on_framebuffer_resize(int width, int height) {
+    m_input_frame.resize_width = width;
+    m_input_frame.resize_height = height;
     m_window.m_width = width;
     m_window.m_height = height;
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_window_resize(width, height);
-    }
+    m_events.push_back(PlatformEvent{
+            .type = PlatformEvent::Type::WindowResize,
+            .x = static_cast<float>(width), .y = static_cast<float>(height)});
 }
 
 void PlatformController::_platform_on_window_close(GLFWwindow *window) {
@@ -231,10 +590,22 @@ void PlatformController::_platform_on_window_close(GLFWwindow *window) {
 }
 
 void PlatformController::_platform_on_mouse_button(int button, int action) {
-    for (auto &observer: m_platform_event_observers) {
-        auto result = key(g_glfw_key_to_engine[button]);
-        observer->on_key(result);
-    }
+    // Mouse buttons and keys share the code space of the key maps.
+    _platform_on_keyboard(button, action);
+}
+
+void PlatformController::_platform_on_window_focus(bool focused) {
+    m_focused = focused;
+    request_redraw();
+}
+
+void PlatformController::_platform_on_window_minimize(bool minimized) {
+    m_minimized = minimized;
+    request_redraw();
+}
+
+void PlatformController::_platform_on_window_refresh() {
+    m_present_needed = true;
 }
 
 void PlatformController::set_enable_cursor(bool enabled) {
@@ -246,36 +617,106 @@ void PlatformController::set_enable_cursor(bool enabled) {
 }
 
 void initialize_key_maps() {
+    g_glfw_key_to_engine.fill(KEY_COUNT);
+    g_glfw_key_to_engine_alias.fill(KEY_COUNT);
     // @formatter:off
     #include "glfw_key_mapping.include"
     #include "engine_key_to_string.include"
     // @formatter:on
+    for (int key = 0; key < KEY_COUNT; ++key) {
+        int glfw_key_code = g_engine_to_glfw_key[key];
+        if (g_glfw_key_to_engine[glfw_key_code] != key) {
+            g_glfw_key_to_engine_alias[glfw_key_code] = static_cast<KeyId>(key);
+        }
+    }
+}
+
+void PlatformEventObserver::on_events(std::span<const PlatformEvent> events) {
+    auto platform = core::Controller::get<PlatformController>();
+    for (const auto &event: events) {
+        switch (event.type) {
+            case PlatformEvent::Type::KeyPress:
+            case PlatformEvent::Type::KeyRelease: {
+                // The state comes from the event, the key state of the frame would lose a press released in the same frame.
+                Key key;
+                key.m_key = event.key;
+                key.m_state = event.type == PlatformEvent::Type::KeyPress
+                                      ? Key::State::JustPressed
+                                      : Key::State::JustReleased;
+                on_key(key);
+                break;
+            }
+            case PlatformEvent::Type::MouseMove: {
+                MousePosition position = platform->mouse();
+                position.x = event.x;
+                position.y = event.y;
+                position.dx = event.dx;
+                position.dy = event.dy;
+                on_mouse_move(position);
+                break;
+            }
+            case PlatformEvent::Type::Scroll: {
+                MousePosition position = platform->mouse();
+                position.scroll = event.y;
+                on_scroll(position);
+                break;
+            }
+            case PlatformEvent::Type::WindowResize: on_window_resize(static_cast<int>(event.x), static_cast<int>(event.y));
+                break;
+        }
+    }
 }
 
+// During an input replay the window input is ignored, the recorded events are applied in the poll_events instead.
 static void glfw_mouse_callback(GLFWwindow *window, double x, double y) {
-    core::Controller::get<PlatformController>()->_platform_on_mouse(x, y);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_replaying_input()) {
+        platform->_platform_on_mouse(x, y);
+    }
 }
 
 void glfw_mouse_button_callback(GLFWwindow *window, int button, int action, int mods) {
-    core::Controller::get<PlatformController>()->_platform_on_mouse_button(button, action);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_replaying_input()) {
+        platform->_platform_on_mouse_button(button, action);
+    }
 }
 
 static void glfw_scroll_callback(GLFWwindow *window, double x_offset, double y_offset) {
-    g_mouse_position.scroll = y_offset;
-    core::Controller::get<PlatformController>()->_platform_on_scroll(x_offset, y_offset);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_replaying_input()) {
+        platform->_platform_on_scroll(x_offset, y_offset);
+    }
 }
 
 static void glfw_key_callback(GLFWwindow *window, int key, int scancode, int action, int mods) {
-    core::Controller::get<PlatformController>()->_platform_on_keyboard(key, action);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_replaying_input()) {
+        platform->_platform_on_keyboard(key, action);
+    }
 }
 
 static void glfw_framebuffer_size_callback(GLFWwindow *window, int width, int height) {
-    glViewport(0, 0, width, height);
-    core::Controller::get<PlatformController>()->_platform_on_framebuffer_resize(width, height);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_replaying_input()) {
+        platform->_platform_on_framebuffer_resize(width, height);
+    }
 }
 
 void glfw_window_close_callback(GLFWwindow *window) {
     core::Controller::get<PlatformController>()->_platform_on_window_close(window);
 }
 
+static void glfw_window_focus_callback(GLFWwindow *window, int focused) {
+    core::Controller::get<PlatformController>()->_platform_on_window_focus(focused == GLFW_TRUE);
+}
+
+static void glfw_window_iconify_callback(GLFWwindow *window, int iconified) {
+    core::Controller::get<PlatformController>()->_platform_on_window_minimize(iconified == GLFW_TRUE);
+}
+
+static void glfw_window_refresh_callback(GLFWwindow *window) {
+    core::Controller::get<PlatformController>()->_platform_on_window_refresh();
+}
+
 } // namespace engine
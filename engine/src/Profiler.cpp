@@ -0,0 +1,144 @@
+#include <engine/util/Profiler.hpp>
+#include <engine/util/Errors.hpp>
+#include <spdlog/spdlog.h>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace engine::util {
+
+struct Profiler::ThreadEvents {
+    std::array<ProfileEvent, EVENTS_PER_THREAD> events;
+    /**
+    * @brief Number of events ever recorded. Written only by the owner thread.
+    */
+    std::atomic<uint64_t> count{0};
+    uint32_t thread_id;
+    std::string thread_name;
+};
+
+/**
+* @brief Guards the registry of the thread buffers. Taken only when a thread records its first event.
+*/
+static std::mutex g_threads_mutex;
+static std::vector<std::unique_ptr<Profiler::ThreadEvents> > g_threads;
+static thread_local Profiler::ThreadEvents *g_thread_events = nullptr;
+static thread_local uint32_t g_thread_depth = 0;
+/**
+* @brief The name given by Profiler::set_thread_name, kept until the thread records its first event and gets a buffer.
+*/
+static thread_local std::string g_thread_name;
+
+void Profiler::set_enabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::set_thread_name(std::string name) {
+    // The buffer is created by the first recorded event, so that the threads don't allocate it while profiling is off.
+    if (g_thread_events) {
+        std::lock_guard lock(g_threads_mutex);
+        g_thread_events->thread_name = std::move(name);
+    } else {
+        g_thread_name = std::move(name);
+    }
+}
+
+int64_t Profiler::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t &Profiler::thread_depth() {
+    return g_thread_depth;
+}
+
+void Profiler::record(const ProfileEvent &event) {
+    ThreadEvents &thread = thread_events();
+    uint64_t count = thread.count.load(std::memory_order_relaxed);
+    thread.events[count % EVENTS_PER_THREAD] = event;
+    thread.count.store(count + 1, std::memory_order_release);
+}
+
+Profiler::ThreadEvents &Profiler::thread_events() {
+    if (!g_thread_events) {
+        std::lock_guard lock(g_threads_mutex);
+        thread_events_locked();
+    }
+    return *g_thread_events;
+}
+
+Profiler::ThreadEvents &Profiler::thread_events_locked() {
+    if (!g_thread_events) {
+        // The buffer outlives the thread, so the events of finished threads are still exported.
+        auto thread = std::make_unique<ThreadEvents>();
+        thread->thread_id = static_cast<uint32_t>(g_threads.size());
+        if (!g_thread_name.empty()) {
+            thread->thread_name = std::move(g_thread_name);
+        } else {
+            thread->thread_name = thread->thread_id == 0 ? "Main" : std::format("Thread {}", thread->thread_id);
+        }
+        g_thread_events = thread.get();
+        g_threads.push_back(std::move(thread));
+    }
+    return *g_thread_events;
+}
+
+static void write_json_string(std::ofstream &out, std::string_view text) {
+    out << '"';
+    for (char c: text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+void Profiler::export_chrome_trace(const std::filesystem::path &path) {
+    std::ofstream out(path);
+    RG_GUARANTEE(out.is_open(), "Failed to open the profiler output file {}.", path.string());
+
+    std::lock_guard lock(g_threads_mutex);
+    int64_t origin_ns = INT64_MAX;
+    for (const auto &thread: g_threads) {
+        uint64_t count = thread->count.load(std::memory_order_acquire);
+        for (uint64_t i = count - std::min<uint64_t>(count, EVENTS_PER_THREAD); i < count; ++i) {
+            origin_ns = std::min(origin_ns, thread->events[i % EVENTS_PER_THREAD].begin_ns);
+        }
+    }
+
+    size_t event_count = 0;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto &thread: g_threads) {
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":" << thread->thread_id
+            << ",\"args\":{\"name\":";
+        write_json_string(out, thread->thread_name);
+        out << "}}";
+        first = false;
+
+        uint64_t count = thread->count.load(std::memory_order_acquire);
+        for (uint64_t i = count - std::min<uint64_t>(count, EVENTS_PER_THREAD); i < count; ++i) {
+            const ProfileEvent &event = thread->events[i % EVENTS_PER_THREAD];
+            std::string name(event.name);
+            if (!event.detail.empty()) {
+                name.append("::");
+                name.append(event.detail);
+            }
+            // Timestamps are in microseconds; the fractional part keeps the nanosecond precision.
+            out << ",\n{\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->thread_id << ",\"name\":";
+            write_json_string(out, name);
+            out << std::format(",\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"depth\":{}}}}}",
+                               (event.begin_ns - origin_ns) / 1000.0, (event.end_ns - event.begin_ns) / 1000.0,
+                               event.depth);
+            ++event_count;
+        }
+    }
+    out << "\n]}\n";
+    spdlog::info("Profiler: wrote {} events to {}", event_count, path.string());
+}
+
+} // namespace engine::util
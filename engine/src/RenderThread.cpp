@@ -0,0 +1,160 @@
+#include <imgui_impl_opengl3.h>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <engine/graphics/RenderThread.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Profiler.hpp>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace engine::graphics {
+
+GuiDrawData::~GuiDrawData() {
+    for (auto list: m_lists) {
+        IM_DELETE(list);
+    }
+}
+
+void GuiDrawData::capture(const ImDrawData *draw_data) {
+    auto count = static_cast<size_t>(draw_data->CmdListsCount);
+    while (m_lists.size() < count) {
+        m_lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const ImDrawList *source = draw_data->CmdLists[i];
+        ImDrawList *copy = m_lists[i];
+        // ImVector reuses its buffer when it's large enough.
+        copy->CmdBuffer = source->CmdBuffer;
+        copy->IdxBuffer = source->IdxBuffer;
+        copy->VtxBuffer = source->VtxBuffer;
+        copy->Flags = source->Flags;
+    }
+    m_draw_data = *draw_data;
+    m_draw_data.CmdLists = m_lists.data();
+}
+
+void GuiDrawData::render() {
+    if (m_draw_data.Valid) {
+        ImGui_ImplOpenGL3_RenderDrawData(&m_draw_data);
+    }
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::start(GLFWwindow *window) {
+    m_window = window;
+    m_running = true;
+    // A context can be current on only one thread at a time.
+    glfwMakeContextCurrent(nullptr);
+    m_thread = std::thread([this] {
+        run();
+    });
+}
+
+void RenderThread::stop() {
+    if (!is_running()) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+    glfwMakeContextCurrent(m_window);
+    for (auto &packet: m_packets) {
+        packet.commands.clear();
+    }
+    m_pending = nullptr;
+    if (m_error) {
+        // Called while terminating, and from the destructor, so the error of the last frame is logged instead of rethrown.
+        try {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        } catch (const util::Error &e) {
+            spdlog::error("RenderThread: the last frame failed: {}", e.report());
+        } catch (const std::exception &e) {
+            spdlog::error("RenderThread: the last frame failed: {}", e.what());
+        } catch (...) {
+            spdlog::error("RenderThread: the last frame failed with an unknown error.");
+        }
+    }
+}
+
+void RenderThread::wait_idle(std::unique_lock<std::mutex> &lock) {
+    m_condition.wait(lock, [this] {
+        return !m_pending && !m_sync_function && !m_busy;
+    });
+    if (m_error) {
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+}
+
+void RenderThread::submit_frame(const std::function<void()> &on_idle) {
+    {
+        std::unique_lock lock(m_mutex);
+        wait_idle(lock);
+        on_idle();
+        FramePacket &recorded = m_packets[m_recording];
+        recorded.frame = m_frame++;
+        m_pending = &recorded;
+        m_recording ^= 1;
+    }
+    m_condition.notify_all();
+}
+
+void RenderThread::run_sync(const std::function<void()> &function) {
+    std::unique_lock lock(m_mutex);
+    wait_idle(lock);
+    m_sync_function = &function;
+    m_condition.notify_all();
+    wait_idle(lock);
+}
+
+void RenderThread::run() {
+    util::Profiler::set_thread_name("Render");
+    glfwMakeContextCurrent(m_window);
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_condition.wait(lock, [this] {
+            return m_pending || m_sync_function || !m_running;
+        });
+        FramePacket *packet = std::exchange(m_pending, nullptr);
+        const std::function<void()> *function = m_sync_function;
+        if (!packet && !function) {
+            break;
+        }
+        m_busy = true;
+        lock.unlock();
+        try {
+            if (packet) {
+                RG_PROFILE_SCOPE("RenderThread::frame");
+                for (auto &command: packet->commands) {
+                    command();
+                }
+            } else {
+                (*function)();
+            }
+        } catch (...) {
+            std::lock_guard error_lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+        if (packet) {
+            // The closures are destroyed here, so that the main thread doesn't pay for it.
+            packet->commands.clear();
+        }
+        lock.lock();
+        if (function) {
+            m_sync_function = nullptr;
+        }
+        m_busy = false;
+        m_condition.notify_all();
+    }
+    lock.unlock();
+    glfwMakeContextCurrent(nullptr);
+}
+
+} // namespace engine::graphics
@@ -1,39 +1,249 @@
+#include <glad/glad.h>
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <engine/graphics/GraphicsController.hpp>
 #include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/AssimpSceneProcessor.hpp>
 #include <engine/resources/ResourcesController.hpp>
 #include <engine/resources/ShaderCompiler.hpp>
+#include <engine/resources/ShaderPreprocessor.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
 #include <engine/util/Configuration.hpp>
 #include <engine/util/Errors.hpp>
 #include <spdlog/spdlog.h>
 
 namespace engine::resources {
 
+template<typename T>
+T *ResourcesController::find_by_name(const std::string &name) {
+    auto &resources = storage<T>();
+    auto it = resources.ids.find(util::fnv1a(name));
+    if (it == resources.ids.end()) {
+        return nullptr;
+    }
+    RG_GUARANTEE(it->second.name == name, "Resource names {} and {} have the same hash, please rename one of them.",
+                 it->second.name, name);
+    return use(resources.slots.get(it->second.handle));
+}
+
+template<typename T>
+T *ResourcesController::find_loaded(ResourceId id, std::string_view type) {
+    T *result = get(handle<T>(id));
+    RG_GUARANTEE(result != nullptr, "No {} with the id {:#x} is loaded.", type, id.hash);
+    return result;
+}
+
+template<typename T>
+T *ResourcesController::insert(const std::string &name, T resource) {
+    auto &resources = storage<T>();
+    util::Handle<T> handle = resources.slots.emplace(std::move(resource));
+    resources.ids[util::fnv1a(name)] = {handle, name};
+    ++m_generation;
+    T *result = resources.slots.get(handle);
+    if constexpr (std::is_base_of_v<GpuResource, T>) {
+        m_gpu_memory_used += result->gpu_memory_size();
+        result->mark_used();
+    }
+    return result;
+}
+
+template<typename T>
+void ResourcesController::unload(util::Handle<T> handle) {
+    auto &resources = storage<T>();
+    T *resource = resources.slots.get(handle);
+    if (!resource) {
+        return;
+    }
+    core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+        resource->destroy();
+    });
+    if constexpr (std::is_base_of_v<GpuResource, T>) {
+        if (resource->is_resident()) {
+            m_gpu_memory_used -= resource->gpu_memory_size();
+        }
+    }
+    std::erase_if(resources.ids, [&](const auto &entry) {
+        return entry.second.handle == handle;
+    });
+    resources.slots.erase(handle);
+    ++m_generation;
+}
+
+template void ResourcesController::unload(util::Handle<Model>);
+template void ResourcesController::unload(util::Handle<Texture>);
+template void ResourcesController::unload(util::Handle<Skybox>);
+template void ResourcesController::unload(util::Handle<Shader>);
+
 void ResourcesController::initialize() {
+    m_main_thread = std::this_thread::get_id();
+    const auto resources_config = util::Configuration::config()
+            .value("resources", util::Configuration::json::object());
+    m_gpu_memory_budget = resources_config.value("gpu_memory_budget_mb", uint64_t{0}) * 1024 * 1024;
     load_shaders();
     load_models();
     load_textures();
     load_skyboxes();
 }
 
+void ResourcesController::begin_draw() {
+    GpuResource::begin_frame();
+    if (!GpuResource::take_restore_requests()) {
+        return;
+    }
+    std::vector<GpuResource *> requested;
+    for_each_gpu_resource([&](GpuResource &resource) {
+        if (!resource.is_resident() && resource.restore_requested()) {
+            requested.push_back(&resource);
+        }
+    });
+    restore(requested);
+}
+
+void ResourcesController::end_draw() {
+    enforce_gpu_memory_budget();
+}
+
+void ResourcesController::terminate() {
+    if (m_gpu_memory_budget != 0) {
+        spdlog::info("[ResourcesController]: GPU memory {:.1f}/{:.1f} MiB, {} evictions, {} restores",
+                     m_gpu_memory_used / (1024.0 * 1024.0), m_gpu_memory_budget / (1024.0 * 1024.0),
+                     m_eviction_count, m_restore_count);
+    }
+}
+
+void ResourcesController::use_gpu_resource(GpuResource *resource) {
+    resource->mark_used();
+    if (!resource->is_resident() && std::this_thread::get_id() == m_main_thread) {
+        restore({resource});
+    }
+}
+
+void ResourcesController::use_gpu_resource(Model *model) {
+    std::vector<GpuResource *> evicted;
+    auto use = [&](GpuResource *resource) {
+        resource->mark_used();
+        if (!resource->is_resident() && std::ranges::find(evicted, resource) == evicted.end()) {
+            evicted.push_back(resource);
+        }
+    };
+    use(model);
+    for (const auto &mesh: model->meshes()) {
+        for (Texture *texture: mesh.textures()) {
+            use(texture);
+        }
+    }
+    if (!evicted.empty() && std::this_thread::get_id() == m_main_thread) {
+        restore(evicted);
+    }
+}
+
+void ResourcesController::restore(const std::vector<GpuResource *> &resources) {
+    if (resources.empty()) {
+        return;
+    }
+    core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+        for (GpuResource *resource: resources) {
+            resource->restore_gpu_objects();
+        }
+    });
+    for (GpuResource *resource: resources) {
+        resource->set_resident(true);
+        std::atomic_ref(resource->m_restore_requested).store(false, std::memory_order_relaxed);
+        m_gpu_memory_used += resource->gpu_memory_size();
+    }
+    m_restore_count += resources.size();
+    spdlog::debug("[ResourcesController]: restored {} resources, GPU memory {} bytes", resources.size(),
+                  m_gpu_memory_used);
+}
+
+void ResourcesController::enforce_gpu_memory_budget() {
+    if (m_gpu_memory_budget == 0 || m_gpu_memory_used <= m_gpu_memory_budget) {
+        m_over_budget_reported = false;
+        return;
+    }
+    const uint64_t frame = GpuResource::current_frame();
+    std::vector<GpuResource *> candidates;
+    for_each_gpu_resource([&](GpuResource &resource) {
+        if (resource.is_resident() && resource.last_used_frame() + EVICTION_MIN_AGE_FRAMES <= frame) {
+            candidates.push_back(&resource);
+        }
+    });
+    std::ranges::sort(candidates, {}, &GpuResource::last_used_frame);
+
+    uint64_t used = m_gpu_memory_used;
+    std::vector<GpuResource *> evicted;
+    for (GpuResource *candidate: candidates) {
+        if (used <= m_gpu_memory_budget) {
+            break;
+        }
+        used -= candidate->gpu_memory_size();
+        evicted.push_back(candidate);
+    }
+    if (!evicted.empty()) {
+        // Marked first, so that no thread reads the OpenGL ids while they are deleted. A restore requested by
+        // a draw that raced with the previous restore is dropped, the resource wasn't used since.
+        for (GpuResource *resource: evicted) {
+            resource->set_resident(false);
+            std::atomic_ref(resource->m_restore_requested).store(false, std::memory_order_relaxed);
+        }
+        core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+            for (GpuResource *resource: evicted) {
+                resource->evict_gpu_objects();
+            }
+        });
+        m_gpu_memory_used = used;
+        m_eviction_count += evicted.size();
+        spdlog::debug("[ResourcesController]: evicted {} resources, GPU memory {} bytes", evicted.size(),
+                      m_gpu_memory_used);
+    }
+    if (m_gpu_memory_used > m_gpu_memory_budget && !m_over_budget_reported) {
+        spdlog::warn("[ResourcesController]: the resources used in the last {} frames take {:.1f} MiB, over the GPU memory budget of {:.1f} MiB",
+                     EVICTION_MIN_AGE_FRAMES, m_gpu_memory_used / (1024.0 * 1024.0),
+                     m_gpu_memory_budget / (1024.0 * 1024.0));
+        m_over_budget_reported = true;
+    }
+}
+
+void ResourcesController::update_gpu_memory_size(GpuResource *resource, uint64_t size) {
+    if (resource->is_resident()) {
+        m_gpu_memory_used = m_gpu_memory_used - resource->m_gpu_memory_size + size;
+    }
+    resource->m_gpu_memory_size = size;
+}
+
 void ResourcesController::load_shaders() {
-    if (!exists(m_shaders_path)) {
+    auto file_system = VirtualFileSystem::instance();
+    if (!file_system->exists(m_shaders_path)) {
         spdlog::info("[ResourcesController]: no {} found to load the shaders from", m_shaders_path.string());
         return;
     }
-    for (const auto &shader_path: std::filesystem::directory_iterator(m_shaders_path)) {
-        const auto name = shader_path.path()
-                                     .stem()
-                                     .string();
-        shader(name, shader_path);
+    // Submit all the shaders before loading other resources, so that the driver compiles them
+    // while the models and textures are being read from the disk.
+    std::vector<ShaderSourceFile> shader_files;
+    for (const auto &shader_path: file_system->list(m_shaders_path)) {
+        // Subdirectories hold files for the #include directive, see ShaderPreprocessor.
+        if (file_system->is_directory(shader_path)) {
+            continue;
+        }
+        auto name = shader_path.stem()
+                               .string();
+        if (!find_by_name<Shader>(name)) {
+            shader_files.emplace_back(std::move(name), shader_path);
+        }
+    }
+    std::vector<Shader> shaders = ShaderCompiler::submit_batch(shader_files);
+    for (size_t i = 0; i < shader_files.size(); ++i) {
+        spdlog::info("load_shader(path={})", shader_files[i].path.string());
+        insert(shader_files[i].name, std::move(shaders[i]));
     }
 }
 
 void ResourcesController::load_models() {
-    if (!exists(m_models_path)) {
+    if (!VirtualFileSystem::instance()->exists(m_models_path)) {
         spdlog::info("[ResourcesController]: no {} found to load the models from", m_models_path.string());
         return;
     }
@@ -48,66 +258,48 @@ void ResourcesController::load_models() {
 }
 
 void ResourcesController::load_textures() {
-    if (!exists(m_textures_path)) {
+    auto file_system = VirtualFileSystem::instance();
+    if (!file_system->exists(m_textures_path)) {
         spdlog::info("[ResourcesController]: no {} found to load the textures from", m_textures_path.string());
         return;
     }
-    for (const auto &texture_entry: std::filesystem::directory_iterator(m_textures_path)) {
-        texture(texture_entry.path()
-                             .stem()
-                             .string(), texture_entry.path());
+    for (const auto &texture_path: file_system->list(m_textures_path)) {
+        texture(texture_path.stem()
+                            .string(), texture_path);
     }
 }
 
 void ResourcesController::load_skyboxes() {
-    if (!exists(m_skyboxes_path)) {
+    auto file_system = VirtualFileSystem::instance();
+    if (!file_system->exists(m_skyboxes_path)) {
         spdlog::info("[ResourcesController]: no {} found to load the skyboxes from", m_skyboxes_path.string());
         return;
     }
-    for (const auto &sky_boxes_entry: std::filesystem::directory_iterator(m_skyboxes_path)) {
-        skybox(sky_boxes_entry.path()
-                              .stem()
-                              .string(), sky_boxes_entry.path());
+    for (const auto &skybox_path: file_system->list(m_skyboxes_path)) {
+        skybox(skybox_path.stem()
+                          .string(), skybox_path);
     }
 }
 
-/**
- * @class AssimpSceneProcessor
- * @brief Processes the meshes in an Assimp scene.
- */
-class AssimpSceneProcessor {
-public:
-    /**
-     * @brief Processes the meshes in the scene.
-     * @returns The meshes in the scene.
-     */
-    std::vector<Mesh> process_meshes();
-
-    explicit AssimpSceneProcessor(ResourcesController *resources_controller, const aiScene *scene,
-                                  std::filesystem::path model_path) :
-            m_scene(scene), m_model_path(std::move(model_path)), m_resources_controller(resources_controller) {
-    }
-
-private:
-    void process_node(const aiNode *node);
-
-    void process_mesh(aiMesh *mesh);
-
-    std::vector<Texture *> process_materials(const aiMaterial *material);
+Model *ResourcesController::model(ResourceId id) {
+    return find_loaded<Model>(id, "model");
+}
 
-    void process_material_type(std::vector<Texture *> &textures, const aiMaterial *material, aiTextureType type);
+Texture *ResourcesController::texture(ResourceId id) {
+    return find_loaded<Texture>(id, "texture");
+}
 
-    static TextureType assimp_texture_type_to_engine(aiTextureType type);
+Skybox *ResourcesController::skybox(ResourceId id) {
+    return find_loaded<Skybox>(id, "skybox");
+}
 
-    std::vector<Mesh> m_meshes;
-    const aiScene *m_scene;
-    std::filesystem::path m_model_path;
-    ResourcesController *m_resources_controller;
-};
+Shader *ResourcesController::shader(ResourceId id) {
+    return find_loaded<Shader>(id, "shader");
+}
 
 Model *ResourcesController::model(
         const std::string &name) {
-    auto &result = m_models[name];
+    Model *result = find_by_name<Model>(name);
     if (!result) {
         auto &config = util::Configuration::config();
         if (!config["resources"]["models"].contains(name)) {
@@ -120,6 +312,8 @@ Model *ResourcesController::model(
                                                    config["resources"]["models"][name]["path"].get<
                                                            std::string>());
         Assimp::Importer importer;
+        // The importer owns the IOSystem. It reads the model and the files it references, like .mtl, through the VirtualFileSystem.
+        importer.SetIOHandler(create_assimp_io_system());
         int flags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
                     aiProcess_CalcTangentSpace;
         if (config["resources"]["models"][name].value<bool>("flip_uvs", false)) {
@@ -128,166 +322,139 @@ Model *ResourcesController::model(
 
         spdlog::info("load_model(name={}, path={})", name, model_path.string());
         const aiScene *scene =
-                importer.ReadFile(model_path, flags);
+                importer.ReadFile(model_path.string(), flags);
 
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
             throw util::EngineError(util::EngineError::Type::AssetLoadingError,
-                                    std::format("Assimp error while reading model: {} from path {}.",
-                                                model_path.string(), name));
+                                    std::format("Assimp error while reading model: {} from path {}: {}",
+                                                name, model_path.string(), importer.GetErrorString()));
         }
         AssimpSceneProcessor scene_processor(this, scene, model_path);
-        std::vector<Mesh> meshes = scene_processor.process_meshes();
-        result = std::make_unique<Model>(Model(std::move(meshes), model_path,
-                                               name));
+        std::vector<Mesh> meshes;
+        // Models loaded after the initialization are uploaded by the render thread, if there is one.
+        core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+            meshes = scene_processor.process_meshes();
+        });
+        result = insert(name, Model(std::move(meshes), model_path, name));
     }
-    return result.get();
+    return result;
 }
 
 Texture *ResourcesController::texture(const std::string &name,
                                       const std::filesystem::path &path,
                                       TextureType type, bool flip_uvs) {
-    auto &result = m_textures[name];
+    Texture *result = find_by_name<Texture>(name);
     if (!result) {
         spdlog::info("load_texture(path={})", path.string());
-        result = std::make_unique<Texture>(Texture(graphics::OpenGL::generate_texture(path, flip_uvs), type, path,
-                                                   path.stem()));
+        Texture texture;
+        core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+            uint32_t texture_id = graphics::OpenGL::generate_texture(path, flip_uvs);
+            texture = Texture(texture_id, type, path, path.stem());
+            texture.m_gpu_memory_size = graphics::OpenGL::texture_memory_size(texture_id, GL_TEXTURE_2D);
+        });
+        texture.m_flip_uvs = flip_uvs;
+        result = insert(name, std::move(texture));
     }
-    return result.get();
+    return result;
 }
 
 Skybox *ResourcesController::skybox(const std::string &name,
                                     const std::filesystem::path &path,
                                     bool flip_uvs) {
-    auto &result = m_sky_boxes[name];
+    Skybox *result = find_by_name<Skybox>(name);
     if (!result) {
         spdlog::info("load_skybox(path={})", path.string());
-        result = std::make_unique<Skybox>(Skybox(graphics::OpenGL::init_skybox_cube(),
-                                                 graphics::OpenGL::load_skybox_textures(path, flip_uvs),
-                                                 path, name));
+        core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+            Skybox skybox(graphics::OpenGL::init_skybox_cube(),
+                          graphics::OpenGL::load_skybox_textures(path, flip_uvs),
+                          path, name, flip_uvs);
+            skybox.m_gpu_memory_size = graphics::OpenGL::texture_memory_size(skybox.m_texture_id, GL_TEXTURE_CUBE_MAP);
+            result = insert(name, std::move(skybox));
+        });
     }
-    return result.get();
+    return result;
 }
 
 Shader *ResourcesController::shader(const std::string &name, const std::filesystem::path &path) {
-    auto &result = m_shaders[name];
+    Shader *result = find_by_name<Shader>(name);
     if (!result) {
         spdlog::info("load_shader(path={})", path.string());
-        result = std::make_unique<Shader>(ShaderCompiler::compile_from_file(name, path));
+        core::Controller::get<graphics::GraphicsController>()->run_on_render_thread([&] {
+            result = insert(name, ShaderCompiler::compile_from_file(name, path));
+        });
     }
-    return result.get();
+    return result;
 }
 
-std::vector<Mesh> AssimpSceneProcessor::process_meshes() {
-    m_meshes.clear();
-    process_node(m_scene->mRootNode);
-    return std::move(m_meshes);
-}
-
-void AssimpSceneProcessor::process_node(const aiNode *node) {
-    for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
-        auto mesh = m_scene->mMeshes[node->mMeshes[i]];
-        process_mesh(mesh);
+Shader *ResourcesController::shader_variant(const std::string &name, std::initializer_list<std::string_view> defines,
+                                            Shader *fallback) {
+    Shader *base = shader(name);
+    if (defines.size() == 0) {
+        return base;
     }
-    for (uint32_t i = 0; i < node->mNumChildren; ++i) {
-        process_node(node->mChildren[i]);
+    if (!fallback) {
+        fallback = base;
     }
-}
 
-void AssimpSceneProcessor::process_mesh(aiMesh *mesh) {
-    std::vector<Vertex> vertices;
-    vertices.reserve(mesh->mNumVertices);
-    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-        Vertex vertex{};
-        vertex.Position
-              .x = mesh->mVertices[i].x;
-        vertex.Position
-              .y = mesh->mVertices[i].y;
-        vertex.Position
-              .z = mesh->mVertices[i].z;
-
-        if (mesh->HasNormals()) {
-            vertex.Normal
-                  .x = mesh->mNormals[i].x;
-            vertex.Normal
-                  .y = mesh->mNormals[i].y;
-            vertex.Normal
-                  .z = mesh->mNormals[i].z;
-        }
-
-        if (mesh->mTextureCoords[0]) {
-            vertex.TexCoords
-                  .x = mesh->mTextureCoords[0][i].x;
-            vertex.TexCoords
-                  .y = mesh->mTextureCoords[0][i].y;
-
-            vertex.Tangent
-                  .x = mesh->mTangents[i].x;
-            vertex.Tangent
-                  .y = mesh->mTangents[i].y;
-            vertex.Tangent
-                  .z = mesh->mTangents[i].z;
-
-            vertex.Bitangent
-                  .x = mesh->mBitangents[i].x;
-            vertex.Bitangent
-                  .y = mesh->mBitangents[i].y;
-            vertex.Bitangent
-                  .z = mesh->mBitangents[i].z;
-        }
-        vertices.push_back(vertex);
+    const uint64_t key = util::fnv1a(name) ^ ShaderPreprocessor::defines_hash(defines);
+    auto [it, inserted] = m_shader_variants.try_emplace(key);
+    auto &variant = it->second;
+    if (inserted) {
+        variant.name = name;
+        variant.defines.assign(defines.begin(), defines.end());
+        std::ranges::sort(variant.defines);
+    } else {
+        RG_GUARANTEE(variant.name == name && variant.defines.size() == defines.size() &&
+                     std::ranges::is_permutation(variant.defines, defines),
+                     "Shader variants {} and {} have the same hash, please rename one of the defines.",
+                     variant.name, name);
     }
-
-    std::vector<uint32_t> indices;
-    for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
-        aiFace face = mesh->mFaces[i];
-
-        for (uint32_t j = 0; j < face.mNumIndices; ++j) {
-            indices.push_back(face.mIndices[j]);
-        }
+    if (variant.ready.load(std::memory_order_acquire)) {
+        return variant.shader.get();
     }
-
-    auto material = m_scene->mMaterials[mesh->mMaterialIndex];
-    std::vector<Texture *> textures = process_materials(material);
-    m_meshes.emplace_back(Mesh(vertices, indices, std::move(textures)));
-}
-
-std::vector<Texture *> AssimpSceneProcessor::process_materials(const aiMaterial *material) {
-    std::vector<Texture *> textures;
-    auto ai_texture_types = {
-            aiTextureType_DIFFUSE,
-            aiTextureType_SPECULAR,
-            aiTextureType_NORMALS,
-            aiTextureType_HEIGHT,
-    };
-
-    for (auto ai_texture_type: ai_texture_types) {
-        process_material_type(textures, material, ai_texture_type);
+    auto graphics = core::Controller::get<graphics::GraphicsController>();
+    if (variant.submitted) {
+        if (variant.polled_frame != GpuResource::current_frame()) {
+            variant.polled_frame = GpuResource::current_frame();
+            graphics->submit([&variant] {
+                if (variant.shader && variant.shader->is_ready()) {
+                    variant.ready.store(true, std::memory_order_release);
+                }
+            });
+        }
+        return fallback;
     }
-    return textures;
-}
-
-void AssimpSceneProcessor::process_material_type(std::vector<Texture *> &textures, const aiMaterial *material,
-                                                 aiTextureType type) {
-    auto material_count = material->GetTextureCount(type);
-    for (uint32_t i = 0; i < material_count; ++i) {
-        aiString ai_texture_path_string;
-        material->GetTexture(type, i, &ai_texture_path_string);
-        std::filesystem::path texture_path = m_model_path.parent_path() / ai_texture_path_string.C_Str();
-        Texture *texture = m_resources_controller->texture(texture_path.string(), texture_path,
-                                                           assimp_texture_type_to_engine(type));
-        textures.emplace_back(texture);
+    if (!variant.parsing.valid()) {
+        RG_GUARANTEE(!base->source_path().empty(),
+                     "Shader {} wasn't loaded from a file, variants can only be built from shader files.", name);
+        std::vector<std::string> variant_defines = variant.defines;
+        std::string defines_list;
+        for (const auto &define: variant_defines) {
+            defines_list.append(defines_list.empty() ? "" : ", ").append(define);
+        }
+        spdlog::info("load_shader_variant(name={}, defines=[{}])", name, defines_list);
+        variant.parsing = ShaderCompiler::parse_async(ShaderSourceFile{
+                name, base->source_path(), std::move(variant_defines)
+        });
+    } else if (variant.parsing.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        // The unordered_map never moves its values, so the commands can keep the reference to the variant.
+        graphics->submit([&variant, parsed = variant.parsing.get()]() mutable {
+            variant.shader = std::make_unique<Shader>(ShaderCompiler::submit(std::move(parsed)));
+        });
+        variant.submitted = true;
     }
+    return fallback;
 }
 
-TextureType AssimpSceneProcessor::assimp_texture_type_to_engine(aiTextureType type) {
-    switch (type) {
-        case aiTextureType_DIFFUSE: return TextureType::Diffuse;
-        case aiTextureType_SPECULAR: return TextureType::Specular;
-        case aiTextureType_HEIGHT: return TextureType::Height;
-        case aiTextureType_NORMALS: return TextureType::Normal;
-        default: RG_SHOULD_NOT_REACH_HERE("Engine currently doesn't support the aiTextureType: {}",
-                                          static_cast<int>(type));
+void ResourcesController::replace_shader(Shader *shader, Shader replacement) {
+    try {
+        ShaderCompiler::finish_compilation(replacement);
+    } catch (const util::Error &) {
+        replacement.destroy();
+        throw;
     }
+    shader->destroy();
+    *shader = std::move(replacement);
 }
 
 } // namespace engine
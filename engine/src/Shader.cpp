@@ -1,14 +1,21 @@
 #include <glad/glad.h>
 #include <engine/resources/Shader.hpp>
 #include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/ShaderCompiler.hpp>
 
 namespace engine::resources {
 
 void Shader::use() const {
+    if (m_pending) {
+        ShaderCompiler::finish_compilation(*this);
+    }
     glUseProgram(m_shader_id);
 }
 
 void Shader::destroy() const {
+    for (uint32_t stage_id: m_pending_stages) {
+        glDeleteShader(stage_id);
+    }
     glDeleteProgram(m_shader_id);
 }
 
@@ -16,6 +23,30 @@ unsigned Shader::id() const {
     return m_shader_id;
 }
 
+const std::string &Shader::name() const {
+    return m_name;
+}
+
+const std::string &Shader::source() const {
+    return m_source;
+}
+
+const std::filesystem::path &Shader::source_path() const {
+    return m_source_path;
+}
+
+const std::vector<std::string> &Shader::defines() const {
+    return m_defines;
+}
+
+const std::vector<std::filesystem::path> &Shader::dependencies() const {
+    return m_dependencies;
+}
+
+bool Shader::is_ready() const {
+    return !m_pending || graphics::OpenGL::shader_program_ready(m_shader_id);
+}
+
 void Shader::set_bool(const std::string &name, bool value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
     CHECKED_GL_CALL(glUniform1i, location, static_cast<int>(value));
@@ -1,7 +1,11 @@
 #include <glad/glad.h>
 #include <engine/resources/ShaderCompiler.hpp>
+#include <engine/resources/ShaderPreprocessor.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
 #include <format>
+#include <engine/core/JobSystem.hpp>
+#include <future>
 #include <spdlog/spdlog.h>
 #include <engine/graphics/OpenGL.hpp>
 
@@ -12,55 +16,120 @@ int to_opengl_type(ShaderType type);
 
 Shader ShaderCompiler::compile_from_source(std::string shader_name, std::string shader_source) {
     spdlog::info("ShaderCompiler::Compiling: {}", shader_name);
-    ShaderCompiler compiler(std::move(shader_name), std::move(shader_source));
-    ShaderParsingResult parsing_result = compiler.parse_source();
-    OpenGL::ShaderProgramId shader_program = compiler.compile(parsing_result);
-    Shader result(shader_program, shader_name, shader_source, "");
+    Shader result = submit(parse(ShaderSourceFile{std::move(shader_name), ""}, shader_source));
+    finish_compilation(result);
     return result;
 }
 
-OpenGL::ShaderProgramId ShaderCompiler::compile(const ShaderParsingResult &shader_sources) {
-    uint32_t shader_program_id = glCreateProgram();
-    uint32_t vertex_shader_id = 0;
-    uint32_t fragment_shader_id = 0;
-    uint32_t geometry_shader_id = 0;
-    defer {
-        glDeleteShader(vertex_shader_id);
-        glDeleteShader(fragment_shader_id);
-        glDeleteShader(geometry_shader_id);
+std::vector<Shader> ShaderCompiler::submit_batch(std::span<const ShaderSourceFile> files) {
+    // Reading and parsing the sources doesn't touch the OpenGL context, so it can run on worker threads.
+    // Only the submission to the driver has to happen on the thread that owns the context.
+    std::vector<std::future<ParsedShader> > parsed_files;
+    parsed_files.reserve(files.size());
+    for (const auto &file: files) {
+        parsed_files.emplace_back(parse_async(file));
+    }
+
+    std::vector<Shader> result;
+    result.reserve(files.size());
+    for (auto &parsed_file: parsed_files) {
+        result.emplace_back(submit(parsed_file.get()));
+    }
+    return result;
+}
+
+std::future<ParsedShader> ShaderCompiler::parse_async(ShaderSourceFile file) {
+    return core::Controller::get<core::JobSystem>()->async([file = std::move(file)]() mutable {
+        return parse_file(std::move(file));
+    });
+}
+
+ParsedShader ShaderCompiler::parse_file(ShaderSourceFile file) {
+    auto file_system = VirtualFileSystem::instance();
+    if (!file_system->exists(file.path)) {
+        throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                std::format("Shader source file {} for shader {} not found.",
+                                            file.path.string(),
+                                            file.name));
+    }
+    FileContents source = file_system->read(file.path);
+    return parse(std::move(file), source.text());
+}
+
+ParsedShader ShaderCompiler::parse(ShaderSourceFile file, std::string_view source) {
+    PreprocessedSource preprocessed = ShaderPreprocessor::expand_includes(source, file.path);
+    ShaderCompiler compiler(file.name, std::move(preprocessed.source));
+    ShaderParsingResult stages = compiler.parse_source();
+    for (auto *stage: {&stages.vertex_shader, &stages.fragment_shader, &stages.geometry_shader}) {
+        if (!stage->empty()) {
+            ShaderPreprocessor::inject_defines(*stage, file.defines);
+        }
+    }
+    return ParsedShader{
+            .file = std::move(file),
+            .source = std::move(compiler.m_sources),
+            .stages = std::move(stages),
+            .dependencies = std::move(preprocessed.dependencies),
     };
+}
 
-    vertex_shader_id = compile(shader_sources.vertex_shader, ShaderType::Vertex);
-    glAttachShader(shader_program_id, vertex_shader_id);
-    fragment_shader_id = compile(shader_sources.fragment_shader, ShaderType::Fragment);
-    glAttachShader(shader_program_id, fragment_shader_id);
+Shader ShaderCompiler::submit(ParsedShader parsed_shader) {
+    uint32_t shader_program_id = glCreateProgram();
+    std::array<uint32_t, 3> stages{};
+    auto submit_stage = [&](const std::string &stage_source, ShaderType type) {
+        uint32_t shader_id = OpenGL::compile_shader(stage_source, type);
+        glAttachShader(shader_program_id, shader_id);
+        stages[static_cast<size_t>(type)] = shader_id;
+    };
 
+    const ShaderParsingResult &shader_sources = parsed_shader.stages;
+    submit_stage(shader_sources.vertex_shader, ShaderType::Vertex);
+    submit_stage(shader_sources.fragment_shader, ShaderType::Fragment);
     if (!shader_sources.geometry_shader
                        .empty()) {
-        geometry_shader_id = compile(shader_sources.geometry_shader, ShaderType::Geometry);
-        glAttachShader(shader_program_id, geometry_shader_id);
+        submit_stage(shader_sources.geometry_shader, ShaderType::Geometry);
     }
     glLinkProgram(shader_program_id);
-    return shader_program_id;
+
+    Shader result(shader_program_id, std::move(parsed_shader.file.name), std::move(parsed_shader.source),
+                  std::move(parsed_shader.file.path));
+    result.m_defines = std::move(parsed_shader.file.defines);
+    result.m_dependencies = std::move(parsed_shader.dependencies);
+    result.m_pending_stages = stages;
+    result.m_pending = true;
+    return result;
 }
 
-uint32_t ShaderCompiler::compile(const std::string &shader_source, ShaderType type) {
-    uint32_t shader_id = OpenGL::compile_shader(shader_source, type);
-    if (!OpenGL::shader_compiled_successfully(shader_id)) {
+void ShaderCompiler::finish_compilation(const Shader &shader) {
+    defer {
+        for (uint32_t &stage_id: shader.m_pending_stages) {
+            glDeleteShader(stage_id);
+            stage_id = 0;
+        }
+        shader.m_pending = false;
+    };
+    for (auto type: {ShaderType::Vertex, ShaderType::Fragment, ShaderType::Geometry}) {
+        uint32_t stage_id = shader.m_pending_stages[static_cast<size_t>(type)];
+        if (stage_id != 0 && !OpenGL::shader_compiled_successfully(stage_id)) {
+            throw util::EngineError(util::EngineError::Type::ShaderCompilationError, std::format(
+                    "{} shader compilation {} failed:\n{}", to_string(type),
+                    shader.name(),
+                    OpenGL::get_compilation_error_message(stage_id)));
+        }
+    }
+    if (!OpenGL::shader_program_linked_successfully(shader.m_shader_id)) {
         throw util::EngineError(util::EngineError::Type::ShaderCompilationError, std::format(
-                "{} shader compilation {} failed:\n{}", to_string(type),
-                m_shader_name,
-                OpenGL::get_compilation_error_message(shader_id)));
+                "Shader program {} linking failed:\n{}", shader.name(),
+                OpenGL::get_link_error_message(shader.m_shader_id)));
     }
-    return shader_id;
 }
 
 ShaderParsingResult ShaderCompiler::parse_source() {
     ShaderParsingResult parsing_result;
-    std::istringstream ss(m_sources);
-    std::string line;
+    std::string_view remaining = m_sources;
     std::string *current_shader = nullptr;
-    while (std::getline(ss, line)) {
+    while (!remaining.empty()) {
+        std::string_view line = ShaderPreprocessor::next_line(remaining);
         if (line.starts_with("//#shader") || line.starts_with("// #shader")) {
             current_shader = now_parsing(parsing_result, line);
         } else if (current_shader) {
@@ -80,21 +149,12 @@ ShaderParsingResult ShaderCompiler::parse_source() {
 
 Shader ShaderCompiler::compile_from_file(std::string shader_name,
                                          const std::filesystem::path &shader_path) {
-    if (!exists(shader_path)) {
-        throw util::EngineError(util::EngineError::Type::FileNotFound,
-                                std::format("Shader source file {} for shader {} not found.",
-                                            shader_path.string(),
-                                            shader_name));
-    }
-    std::string shader_source = util::read_text_file(shader_path);
-    ShaderCompiler compiler(std::move(shader_name), std::move(shader_source));
-    ShaderParsingResult parsing_result = compiler.parse_source();
-    OpenGL::ShaderProgramId shader_program = compiler.compile(parsing_result);
-    Shader result(shader_program, shader_name, shader_source, shader_path);
+    Shader result = submit(parse_file(ShaderSourceFile{std::move(shader_name), shader_path}));
+    finish_compilation(result);
     return result;
 }
 
-std::string *ShaderCompiler::now_parsing(ShaderParsingResult &result, const std::string &line) {
+std::string *ShaderCompiler::now_parsing(ShaderParsingResult &result, std::string_view line) {
     if (line.ends_with(to_string(ShaderType::Vertex))) {
         return &result.vertex_shader;
     }
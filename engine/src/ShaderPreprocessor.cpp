@@ -0,0 +1,117 @@
+#include <engine/resources/ShaderPreprocessor.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/resources/VirtualFileSystem.hpp>
+#include <engine/util/Utils.hpp>
+#include <algorithm>
+
+namespace engine::resources {
+
+static std::string_view trim(std::string_view text) {
+    auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+std::string_view ShaderPreprocessor::next_line(std::string_view &text) {
+    auto end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return line;
+}
+
+PreprocessedSource ShaderPreprocessor::expand_includes(std::string_view source,
+                                                       const std::filesystem::path &source_path) {
+    PreprocessedSource result;
+    result.source
+          .reserve(source.size());
+    auto root_path = source_path.empty() ? source_path : std::filesystem::weakly_canonical(source_path);
+    expand(source, source_path, root_path, result);
+    return result;
+}
+
+void ShaderPreprocessor::expand(std::string_view source, const std::filesystem::path &source_path,
+                                const std::filesystem::path &root_path, PreprocessedSource &result) {
+    while (!source.empty()) {
+        std::string_view line = next_line(source);
+        std::string_view directive = trim(line);
+        if (!directive.starts_with("#include")) {
+            result.source
+                  .append(line);
+            result.source
+                  .push_back('\n');
+            continue;
+        }
+
+        auto open_quote = directive.find('"');
+        auto close_quote = directive.rfind('"');
+        RG_GUARANTEE(open_quote != std::string_view::npos && close_quote > open_quote,
+                     "Invalid include directive '{}' in {}. Please use: #include \"path/to/file.glsl\"", directive,
+                     source_path.string());
+        std::filesystem::path include_path = resolve_include(
+                directive.substr(open_quote + 1, close_quote - open_quote - 1), source_path);
+        if (include_path == root_path || util::alg::contains(result.dependencies, include_path)) {
+            continue;
+        }
+        result.dependencies
+              .push_back(include_path);
+        FileContents include_source = VirtualFileSystem::instance()->read(include_path);
+        expand(include_source.text(), include_path, root_path, result);
+    }
+}
+
+std::filesystem::path ShaderPreprocessor::resolve_include(std::string_view include,
+                                                          const std::filesystem::path &source_path) {
+    std::filesystem::path relative_to_source = source_path.parent_path() / include;
+    auto file_system = VirtualFileSystem::instance();
+    if (file_system->exists(relative_to_source)) {
+        return std::filesystem::weakly_canonical(relative_to_source);
+    }
+    std::filesystem::path relative_to_include_directory = std::filesystem::path(INCLUDE_DIRECTORY) / include;
+    if (file_system->exists(relative_to_include_directory)) {
+        return std::filesystem::weakly_canonical(relative_to_include_directory);
+    }
+    throw util::EngineError(util::EngineError::Type::FileNotFound,
+                            std::format("Shader include file '{}' included from {} not found. Include files are searched relative to the including file and in {}.",
+                                        include, source_path.string(), INCLUDE_DIRECTORY));
+}
+
+void ShaderPreprocessor::inject_defines(std::string &stage_source, std::span<const std::string> defines) {
+    if (defines.empty()) {
+        return;
+    }
+    std::string define_lines;
+    for (const auto &define: defines) {
+        define_lines.append("#define ");
+        define_lines.append(define);
+        define_lines.push_back('\n');
+    }
+
+    size_t insert_position = 0;
+    std::string_view remaining = stage_source;
+    while (!remaining.empty()) {
+        std::string_view line = next_line(remaining);
+        if (trim(line).starts_with("#version")) {
+            insert_position = stage_source.size() - remaining.size();
+            if (insert_position == stage_source.size() && !stage_source.ends_with('\n')) {
+                stage_source.push_back('\n');
+                insert_position = stage_source.size();
+            }
+            break;
+        }
+    }
+    stage_source.insert(insert_position, define_lines);
+}
+
+uint64_t ShaderPreprocessor::defines_hash(std::initializer_list<std::string_view> defines) {
+    // FNV-1a for each define, combined with a sum so that the order of the defines doesn't matter.
+    uint64_t result = 0;
+    for (std::string_view define: defines) {
+        result += util::fnv1a(define);
+    }
+    return result;
+}
+
+} // namespace engine::resources
@@ -0,0 +1,383 @@
+#include <engine/util/SimdMath.hpp>
+#include <engine/util/Errors.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RG_SIMD_USE_SSE2
+#include <immintrin.h>
+#endif
+
+#if defined(RG_SIMD_USE_SSE2) && defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define RG_SIMD_USE_AVX2
+#endif
+
+namespace engine::util::simd {
+
+std::string_view instruction_set() {
+#if defined(RG_SIMD_USE_AVX2)
+    return "AVX2";
+#elif defined(RG_SIMD_USE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void TransformArrays::resize(size_t count) {
+    for (auto array: {&position_x, &position_y, &position_z, &rotation_x, &rotation_y, &rotation_z, &rotation_w,
+                      &scale_x, &scale_y, &scale_z}) {
+        array->resize(count);
+    }
+}
+
+void TransformArrays::set(size_t index, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+    position_x[index] = position.x;
+    position_y[index] = position.y;
+    position_z[index] = position.z;
+    rotation_x[index] = rotation.x;
+    rotation_y[index] = rotation.y;
+    rotation_z[index] = rotation.z;
+    rotation_w[index] = rotation.w;
+    scale_x[index] = scale.x;
+    scale_y[index] = scale.y;
+    scale_z[index] = scale.z;
+}
+
+void PointArrays::resize(size_t count) {
+    for (auto array: {&x, &y, &z, &radius}) {
+        array->resize(count);
+    }
+}
+
+void ClipArrays::resize(size_t count) {
+    for (auto array: {&x, &y, &z, &w}) {
+        array->resize(count);
+    }
+}
+
+/*
+ * The kernels over the structure of arrays are written once against the lane operations below, and run with
+ * the widest lanes first. The elements left over at the end run with the Scalar lanes.
+ */
+
+struct Scalar {
+    using V = float;
+    static constexpr size_t WIDTH = 1;
+
+    static V load(const float *p) { return *p; }
+    static void store(float *p, V v) { *p = v; }
+    static V set1(float f) { return f; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V madd(V a, V b, V c) { return a * b + c; }
+    static V less(V a, V b) { return a < b ? 1.0f : 0.0f; }
+    static V bit_or(V a, V b) { return a != 0.0f || b != 0.0f ? 1.0f : 0.0f; }
+
+    static size_t store_inside(uint8_t *out, V outside) {
+        *out = outside == 0.0f;
+        return *out;
+    }
+
+    static void store_column(glm::mat4 *out, int column, V x, V y, V z, V w) {
+        out[0][column] = glm::vec4(x, y, z, w);
+    }
+};
+
+#ifdef RG_SIMD_USE_SSE2
+struct Sse {
+    using V = __m128;
+    static constexpr size_t WIDTH = 4;
+
+    static V load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, V v) { _mm_storeu_ps(p, v); }
+    static V set1(float f) { return _mm_set1_ps(f); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V madd(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static V less(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static V bit_or(V a, V b) { return _mm_or_ps(a, b); }
+
+    static size_t store_inside(uint8_t *out, V outside) {
+        auto bits = static_cast<unsigned>(_mm_movemask_ps(outside));
+        for (size_t k = 0; k < WIDTH; ++k) {
+            out[k] = ((bits >> k) & 1u) == 0;
+        }
+        return WIDTH - std::popcount(bits);
+    }
+
+    /**
+    * @brief Writes the `column` of the 4 matrices, lane k of the registers is the matrix k.
+    */
+    static void store_column(glm::mat4 *out, int column, V x, V y, V z, V w) {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(glm::value_ptr(out[0][column]), x);
+        _mm_storeu_ps(glm::value_ptr(out[1][column]), y);
+        _mm_storeu_ps(glm::value_ptr(out[2][column]), z);
+        _mm_storeu_ps(glm::value_ptr(out[3][column]), w);
+    }
+};
+#endif
+
+#ifdef RG_SIMD_USE_AVX2
+struct Avx {
+    using V = __m256;
+    static constexpr size_t WIDTH = 8;
+
+    static V load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(float f) { return _mm256_set1_ps(f); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V madd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static V bit_or(V a, V b) { return _mm256_or_ps(a, b); }
+
+    static size_t store_inside(uint8_t *out, V outside) {
+        auto bits = static_cast<unsigned>(_mm256_movemask_ps(outside));
+        for (size_t k = 0; k < WIDTH; ++k) {
+            out[k] = ((bits >> k) & 1u) == 0;
+        }
+        return WIDTH - std::popcount(bits);
+    }
+
+    static void store_column(glm::mat4 *out, int column, V x, V y, V z, V w) {
+        Sse::store_column(out, column, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+                          _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+        Sse::store_column(out + 4, column, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+                          _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+    }
+};
+#endif
+
+/**
+* @brief Runs the `kernel(begin, end)` with the widest lanes available, and the narrower ones for the rest.
+* The kernel processes whole groups of lanes and returns the index after the last element it processed.
+*/
+template<typename Kernel>
+static void run_lanes(size_t count, Kernel &&kernel) {
+    size_t i = 0;
+#ifdef RG_SIMD_USE_AVX2
+    i = kernel.template operator()<Avx>(i, count);
+#endif
+#ifdef RG_SIMD_USE_SSE2
+    i = kernel.template operator()<Sse>(i, count);
+#endif
+    kernel.template operator()<Scalar>(i, count);
+}
+
+#if defined(RG_SIMD_USE_AVX2)
+/**
+* @brief Computes two columns of `a * b`. The columns of `a` are repeated in both halves of the registers,
+* and `b` holds two columns of the right-hand matrix.
+*/
+static __m256 combine_columns(const __m256 a[4], __m256 b) {
+    __m256 result = _mm256_mul_ps(a[0], _mm256_permute_ps(b, 0x00));
+    result = _mm256_fmadd_ps(a[1], _mm256_permute_ps(b, 0x55), result);
+    result = _mm256_fmadd_ps(a[2], _mm256_permute_ps(b, 0xAA), result);
+    return _mm256_fmadd_ps(a[3], _mm256_permute_ps(b, 0xFF), result);
+}
+
+/**
+* @brief Computes `out[i] = a[i] * b[i]` for the `count` matrices. The `a` advances by `a_stride` floats,
+* 0 multiplies every `b` by the same matrix. The inputs of a matrix are loaded before its result is stored,
+* so the `out` can alias the `a` or the `b`.
+*/
+static void multiply_matrices(const float *a, size_t a_stride, const float *b, float *out, size_t count) {
+    for (size_t i = 0; i < count; ++i, a += a_stride, b += 16, out += 16) {
+        __m256 a_columns[4];
+        for (int k = 0; k < 4; ++k) {
+            a_columns[k] = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4 * k));
+        }
+        __m256 b01 = _mm256_loadu_ps(b);
+        __m256 b23 = _mm256_loadu_ps(b + 8);
+        _mm256_storeu_ps(out, combine_columns(a_columns, b01));
+        _mm256_storeu_ps(out + 8, combine_columns(a_columns, b23));
+    }
+}
+#elif defined(RG_SIMD_USE_SSE2)
+static __m128 combine_column(const __m128 a[4], __m128 b) {
+    __m128 result = _mm_mul_ps(a[0], _mm_shuffle_ps(b, b, 0x00));
+    result = _mm_add_ps(result, _mm_mul_ps(a[1], _mm_shuffle_ps(b, b, 0x55)));
+    result = _mm_add_ps(result, _mm_mul_ps(a[2], _mm_shuffle_ps(b, b, 0xAA)));
+    return _mm_add_ps(result, _mm_mul_ps(a[3], _mm_shuffle_ps(b, b, 0xFF)));
+}
+
+static void multiply_matrices(const float *a, size_t a_stride, const float *b, float *out, size_t count) {
+    for (size_t i = 0; i < count; ++i, a += a_stride, b += 16, out += 16) {
+        __m128 a_columns[4];
+        __m128 b_columns[4];
+        for (int k = 0; k < 4; ++k) {
+            a_columns[k] = _mm_loadu_ps(a + 4 * k);
+            b_columns[k] = _mm_loadu_ps(b + 4 * k);
+        }
+        for (int k = 0; k < 4; ++k) {
+            _mm_storeu_ps(out + 4 * k, combine_column(a_columns, b_columns[k]));
+        }
+    }
+}
+#else
+static void multiply_matrices(const float *a, size_t a_stride, const float *b, float *out, size_t count) {
+    for (size_t i = 0; i < count; ++i, a += a_stride, b += 16, out += 16) {
+        glm::mat4 result = glm::make_mat4(a) * glm::make_mat4(b);
+        std::copy_n(glm::value_ptr(result), 16, out);
+    }
+}
+#endif
+
+void multiply(std::span<const glm::mat4> a, std::span<const glm::mat4> b, std::span<glm::mat4> out) {
+    RG_GUARANTEE(a.size() == b.size() && out.size() == a.size(),
+                 "simd::multiply got {}, {}, and {} matrices, the arrays must have the same size.", a.size(),
+                 b.size(), out.size());
+    if (!a.empty()) {
+        multiply_matrices(glm::value_ptr(a[0]), 16, glm::value_ptr(b[0]), glm::value_ptr(out[0]), a.size());
+    }
+}
+
+void multiply(const glm::mat4 &a, std::span<const glm::mat4> b, std::span<glm::mat4> out) {
+    RG_GUARANTEE(out.size() == b.size(), "simd::multiply got {} and {} matrices, the arrays must have the same size.",
+                 b.size(), out.size());
+    if (!b.empty()) {
+        multiply_matrices(glm::value_ptr(a), 0, glm::value_ptr(b[0]), glm::value_ptr(out[0]), b.size());
+    }
+}
+
+void compose_trs(const TransformArrays &transforms, std::span<glm::mat4> out) {
+    RG_GUARANTEE(out.size() == transforms.size(), "simd::compose_trs got {} transforms and {} matrices.",
+                 transforms.size(), out.size());
+    const TransformArrays &t = transforms;
+    run_lanes(out.size(), [&]<typename L>(size_t begin, size_t end) {
+        using V = typename L::V;
+        const V one = L::set1(1.0f);
+        const V two = L::set1(2.0f);
+        const V zero = L::set1(0.0f);
+        size_t i = begin;
+        for (; i + L::WIDTH <= end; i += L::WIDTH) {
+            V x = L::load(&t.rotation_x[i]);
+            V y = L::load(&t.rotation_y[i]);
+            V z = L::load(&t.rotation_z[i]);
+            V w = L::load(&t.rotation_w[i]);
+            // The same terms as glm::mat3_cast.
+            V x2 = L::mul(x, two);
+            V y2 = L::mul(y, two);
+            V z2 = L::mul(z, two);
+            V xx = L::mul(x, x2), yy = L::mul(y, y2), zz = L::mul(z, z2);
+            V xy = L::mul(x, y2), xz = L::mul(x, z2), yz = L::mul(y, z2);
+            V wx = L::mul(w, x2), wy = L::mul(w, y2), wz = L::mul(w, z2);
+
+            V sx = L::load(&t.scale_x[i]);
+            V sy = L::load(&t.scale_y[i]);
+            V sz = L::load(&t.scale_z[i]);
+            L::store_column(&out[i], 0, L::mul(L::sub(one, L::add(yy, zz)), sx), L::mul(L::add(xy, wz), sx),
+                            L::mul(L::sub(xz, wy), sx), zero);
+            L::store_column(&out[i], 1, L::mul(L::sub(xy, wz), sy), L::mul(L::sub(one, L::add(xx, zz)), sy),
+                            L::mul(L::add(yz, wx), sy), zero);
+            L::store_column(&out[i], 2, L::mul(L::add(xz, wy), sz), L::mul(L::sub(yz, wx), sz),
+                            L::mul(L::sub(one, L::add(xx, yy)), sz), zero);
+            L::store_column(&out[i], 3, L::load(&t.position_x[i]), L::load(&t.position_y[i]),
+                            L::load(&t.position_z[i]), one);
+        }
+        return i;
+    });
+}
+
+void transform_aabbs(std::span<const glm::mat4> transforms, std::span<const Aabb> local, std::span<Aabb> out) {
+    RG_GUARANTEE(transforms.size() == local.size() && out.size() == local.size(),
+                 "simd::transform_aabbs got {} transforms, {} boxes, and {} outputs.", transforms.size(),
+                 local.size(), out.size());
+    // The center is transformed as a point, and the half extent by the absolute value of the rotation and scale,
+    // which gives the smallest box that encloses the transformed box.
+    for (size_t i = 0; i < local.size(); ++i) {
+        const Aabb &box = local[i];
+        glm::vec3 center = (box.min + box.max) * 0.5f;
+        glm::vec3 extent = (box.max - box.min) * 0.5f;
+#ifdef RG_SIMD_USE_SSE2
+        const float *m = glm::value_ptr(transforms[i]);
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        __m128 c0 = _mm_loadu_ps(m), c1 = _mm_loadu_ps(m + 4), c2 = _mm_loadu_ps(m + 8), c3 = _mm_loadu_ps(m + 12);
+        __m128 world_center = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(center.x)), _mm_mul_ps(c1, _mm_set1_ps(center.y))),
+                _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(center.z)), c3));
+        __m128 world_extent = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign, c0), _mm_set1_ps(extent.x)),
+                           _mm_mul_ps(_mm_andnot_ps(sign, c1), _mm_set1_ps(extent.y))),
+                _mm_mul_ps(_mm_andnot_ps(sign, c2), _mm_set1_ps(extent.z)));
+        alignas(16) float lower[4];
+        alignas(16) float upper[4];
+        _mm_store_ps(lower, _mm_sub_ps(world_center, world_extent));
+        _mm_store_ps(upper, _mm_add_ps(world_center, world_extent));
+        out[i] = Aabb{glm::vec3(lower[0], lower[1], lower[2]), glm::vec3(upper[0], upper[1], upper[2])};
+#else
+        const glm::mat4 &m = transforms[i];
+        glm::vec3 world_center = glm::vec3(m * glm::vec4(center, 1.0f));
+        glm::vec3 world_extent = glm::abs(glm::vec3(m[0])) * extent.x + glm::abs(glm::vec3(m[1])) * extent.y +
+                                 glm::abs(glm::vec3(m[2])) * extent.z;
+        out[i] = Aabb{world_center - world_extent, world_center + world_extent};
+#endif
+    }
+}
+
+void to_clip_space(const glm::mat4 &view_projection, const PointArrays &points, ClipArrays &out) {
+    out.resize(points.size());
+    const glm::mat4 &m = view_projection;
+    run_lanes(points.size(), [&]<typename L>(size_t begin, size_t end) {
+        using V = typename L::V;
+        // Every row of the matrix is broadcast, so that each lane transforms a different point.
+        V rows[4][4];
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                rows[row][column] = L::set1(m[column][row]);
+            }
+        }
+        float *outputs[4] = {out.x.data(), out.y.data(), out.z.data(), out.w.data()};
+        size_t i = begin;
+        for (; i + L::WIDTH <= end; i += L::WIDTH) {
+            V x = L::load(&points.x[i]);
+            V y = L::load(&points.y[i]);
+            V z = L::load(&points.z[i]);
+            for (int row = 0; row < 4; ++row) {
+                V result = L::madd(rows[row][0], x, L::madd(rows[row][1], y, L::madd(rows[row][2], z, rows[row][3])));
+                L::store(outputs[row] + i, result);
+            }
+        }
+        return i;
+    });
+}
+
+size_t cull_spheres(const std::array<glm::vec4, 6> &planes, const PointArrays &spheres, std::span<uint8_t> visible) {
+    RG_GUARANTEE(visible.size() == spheres.size(), "simd::cull_spheres got {} spheres and {} outputs.",
+                 spheres.size(), visible.size());
+    size_t visible_count = 0;
+    run_lanes(spheres.size(), [&]<typename L>(size_t begin, size_t end) {
+        using V = typename L::V;
+        V plane_components[6][4];
+        for (int p = 0; p < 6; ++p) {
+            for (int c = 0; c < 4; ++c) {
+                plane_components[p][c] = L::set1(planes[p][c]);
+            }
+        }
+        const V zero = L::set1(0.0f);
+        size_t i = begin;
+        for (; i + L::WIDTH <= end; i += L::WIDTH) {
+            V x = L::load(&spheres.x[i]);
+            V y = L::load(&spheres.y[i]);
+            V z = L::load(&spheres.z[i]);
+            V negative_radius = L::sub(zero, L::load(&spheres.radius[i]));
+            V outside = L::less(zero, zero);
+            for (const auto &plane: plane_components) {
+                V distance = L::madd(plane[0], x, L::madd(plane[1], y, L::madd(plane[2], z, plane[3])));
+                outside = L::bit_or(outside, L::less(distance, negative_radius));
+            }
+            visible_count += L::store_inside(&visible[i], outside);
+        }
+        return i;
+    });
+    return visible_count;
+}
+
+} // namespace engine::util::simd
@@ -0,0 +1,22 @@
+#include <glad/glad.h>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/Skybox.hpp>
+
+namespace engine::resources {
+
+void Skybox::destroy() {
+    // The cube vertex array is cached by OpenGL::init_skybox_cube and shared by all the skyboxes.
+    glDeleteTextures(1, &m_texture_id);
+    m_texture_id = 0;
+}
+
+void Skybox::evict_gpu_objects() {
+    destroy();
+}
+
+void Skybox::restore_gpu_objects() {
+    m_texture_id = graphics::OpenGL::load_skybox_textures(m_path, m_flip_uvs);
+    m_gpu_memory_size = graphics::OpenGL::texture_memory_size(m_texture_id, GL_TEXTURE_CUBE_MAP);
+}
+
+}
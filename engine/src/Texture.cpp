@@ -1,4 +1,5 @@
 #include <glad/glad.h>
+#include <engine/graphics/OpenGL.hpp>
 #include <engine/resources/Texture.hpp>
 #include <engine/util/Errors.hpp>
 
@@ -15,6 +16,16 @@ std::string_view texture_type_to_string(TextureType type) {
 
 void Texture::destroy() {
     glDeleteTextures(1, &m_id);
+    m_id = 0;
+}
+
+void Texture::evict_gpu_objects() {
+    destroy();
+}
+
+void Texture::restore_gpu_objects() {
+    m_id = graphics::OpenGL::generate_texture(m_path, m_flip_uvs);
+    m_gpu_memory_size = graphics::OpenGL::texture_memory_size(m_id, GL_TEXTURE_2D);
 }
 
 void Texture::bind(int32_t sampler) {
@@ -1,6 +1,7 @@
 
 #include <engine/util/Utils.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/util/MappedFile.hpp>
 #include <spdlog/spdlog.h>
 #include <fstream>
 #include <engine/util/Configuration.hpp>
@@ -18,9 +19,11 @@ void tracing_off() {
 }
 
 void trace(std::source_location location) {
+#ifdef RG_ENGINE_TRACE
     if (g_tracing) {
         spdlog::info("{}, in {}:{}", location.function_name(), location.file_name(), location.line());
     }
+#endif
 }
 
 void Configuration::initialize() {
@@ -90,6 +93,7 @@ std::string ArgParser::get_arg_value(std::string_view arg_name) {
     for (int i = 0; i < m_argc; ++i) {
         std::string_view token(m_argv[i]);
         if (token == arg_name) {
+            RG_GUARANTEE(i + 1 < m_argc, "No value for argument: \"{}\" provided.", arg_name);
             std::string arg_value(m_argv[i + 1]);
             RG_GUARANTEE(!arg_value.starts_with("--"), "No get_arg_value for argument: \"{}\" provided.", arg_name);
             return arg_value;
@@ -98,11 +102,17 @@ std::string ArgParser::get_arg_value(std::string_view arg_name) {
     return "";
 }
 
+bool ArgParser::has_flag(std::string_view name) const {
+    for (int i = 0; i < m_argc; ++i) {
+        if (std::string_view(m_argv[i]) == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::string read_text_file(const std::filesystem::path &path) {
     RG_GUARANTEE(std::filesystem::exists(path), "File {} doesn't exist.", path.string());
-    std::ifstream file(path);
-    std::stringstream ss;
-    ss << file.rdbuf();
-    return ss.str();
+    return std::string(MappedFile(path).text());
 }
 } // namespace engine
@@ -0,0 +1,103 @@
+#include <engine/resources/VirtualFileSystem.hpp>
+#include <engine/util/Errors.hpp>
+#include <algorithm>
+
+namespace engine::resources {
+
+VirtualFileSystem *VirtualFileSystem::instance() {
+    static VirtualFileSystem file_system;
+    return &file_system;
+}
+
+void VirtualFileSystem::mount(const std::filesystem::path &pack_path) {
+    m_packs.push_back(std::make_unique<PackArchive>(pack_path));
+}
+
+void VirtualFileSystem::unmount_all() {
+    m_packs.clear();
+}
+
+bool VirtualFileSystem::exists(const std::filesystem::path &path) const {
+    if (!m_packs.empty()) {
+        std::string normalized = PackArchive::normalize(path);
+        for (const auto &pack: m_packs) {
+            if (pack->find(normalized) || pack->contains_directory(normalized)) {
+                return true;
+            }
+        }
+    }
+    return std::filesystem::exists(path);
+}
+
+bool VirtualFileSystem::is_directory(const std::filesystem::path &path) const {
+    if (!m_packs.empty()) {
+        std::string normalized = PackArchive::normalize(path);
+        for (const auto &pack: m_packs) {
+            if (pack->contains_directory(normalized)) {
+                return true;
+            }
+        }
+    }
+    return std::filesystem::is_directory(path);
+}
+
+FileContents VirtualFileSystem::read(const std::filesystem::path &path) const {
+    FileContents result;
+    if (!m_packs.empty()) {
+        std::string normalized = PackArchive::normalize(path);
+        for (auto pack = m_packs.rbegin(); pack != m_packs.rend(); ++pack) {
+            const PackEntry *entry = (*pack)->find(normalized);
+            if (!entry) {
+                continue;
+            }
+            if (entry->compressed()) {
+                result.m_buffer = (*pack)->read(*entry);
+                result.m_bytes = result.m_buffer;
+            } else {
+                result.m_bytes = (*pack)->payload(*entry);
+            }
+            return result;
+        }
+    }
+    if (!std::filesystem::is_regular_file(path)) {
+        throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                std::format("File {} doesn't exist.", path.string()));
+    }
+    result.m_file.emplace(path);
+    result.m_bytes = result.m_file->bytes();
+    return result;
+}
+
+std::vector<std::filesystem::path> VirtualFileSystem::list(const std::filesystem::path &directory) const {
+    std::vector<std::filesystem::path> result;
+    std::string normalized = PackArchive::normalize(directory);
+    bool in_pack = false;
+    for (const auto &pack: m_packs) {
+        if (!pack->contains_directory(normalized)) {
+            continue;
+        }
+        in_pack = true;
+        const std::string prefix = normalized.empty() ? normalized : normalized + '/';
+        for (const auto &entry: pack->entries()) {
+            std::string_view path = pack->path(entry);
+            if (!path.starts_with(prefix)) {
+                continue;
+            }
+            std::string_view child = path.substr(prefix.size());
+            result.emplace_back(directory / child.substr(0, child.find('/')));
+        }
+    }
+    // A directory in a pack hides the same directory on the disk, so that the disk isn't walked when the packs are used.
+    if (!in_pack) {
+        RG_GUARANTEE(std::filesystem::is_directory(directory), "Directory {} doesn't exist.", directory.string());
+        for (const auto &entry: std::filesystem::directory_iterator(directory)) {
+            result.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(result);
+    auto duplicates = std::ranges::unique(result);
+    result.erase(duplicates.begin(), duplicates.end());
+    return result;
+}
+
+} // namespace engine::resources
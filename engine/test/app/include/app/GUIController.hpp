@@ -17,6 +17,21 @@ private:
     void poll_events() override;
 
     void draw() override;
+
+    /**
+    * @brief Draws the heap allocations of the previous frame, counted by the @ref engine::util::AllocationTracker.
+    */
+    void draw_allocations();
+
+    /**
+    * @brief Draws the input latency measured by the @ref engine::graphics::GraphicsController.
+    */
+    void draw_latency();
+
+    /**
+    * @brief Draws the frame-time percentiles, the histogram, and the last hitches.
+    */
+    void draw_frame_stats();
 };
 }
 #endif //GUICONTROLLER_HPP
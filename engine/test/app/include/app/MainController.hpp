@@ -40,6 +40,11 @@ private:
     float m_backpack_scale{1.0f};
     bool m_draw_gui{false};
     bool m_cursor_enabled{true};
+
+    /**
+    * @brief The late latch from the config.json, applied while the GUI is hidden.
+    */
+    bool m_late_latch{false};
 };
 }
 #endif //MAINCONTROLLER_HPP
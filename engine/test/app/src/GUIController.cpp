@@ -2,6 +2,9 @@
 #include <engine/core/Engine.hpp>
 #include <app/GUIController.hpp>
 #include <engine/graphics/GraphicsController.hpp>
+#include <algorithm>
+#include <array>
+#include <cfloat>
 
 namespace engine::test::app {
 void GUIController::initialize() {
@@ -41,6 +44,73 @@ void GUIController::draw() {
                                                     .y, c.Front
                                                          .z);
     ImGui::End();
+
+    draw_allocations();
+    draw_latency();
+    draw_frame_stats();
     graphics->end_gui();
 }
+
+void GUIController::draw_allocations() {
+    ImGui::Begin("Allocations");
+    if (!util::AllocationTracker::is_available()) {
+        ImGui::Text("Configure the engine with -DRG_TRACK_ALLOCATIONS=ON to count the heap allocations.");
+        ImGui::End();
+        return;
+    }
+    const auto &frame = util::AllocationTracker::last_frame();
+    ImGui::Text("Last frame: %llu allocations, %llu bytes, %llu frees", static_cast<unsigned long long>(frame.count),
+                static_cast<unsigned long long>(frame.bytes), static_cast<unsigned long long>(frame.frees));
+    for (const auto &site: frame.sites()) {
+        std::string_view name = site.name.empty() ? "(no scope)" : site.name;
+        ImGui::Text("%6llu %10llu B  %.*s %.*s", static_cast<unsigned long long>(site.count),
+                    static_cast<unsigned long long>(site.bytes), static_cast<int>(name.size()), name.data(),
+                    static_cast<int>(site.detail.size()), site.detail.data());
+    }
+    ImGui::End();
+}
+
+void GUIController::draw_latency() {
+    const auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
+    const auto &latency = graphics->latency_stats();
+    ImGui::Begin("Latency");
+    ImGui::Text("Late latch: %s", graphics->is_late_latch_enabled() ? "on" : "off");
+    ImGui::Text("Input to GPU: %.2f ms (average %.2f ms, max %.2f ms)", latency.last_ms, latency.average_ms,
+                latency.max_ms);
+    ImGui::Text("Frames in flight: %u, waited %.2f ms", latency.frames_in_flight, latency.wait_ms);
+    ImGui::End();
+}
+
+void GUIController::draw_frame_stats() {
+    const auto platform = engine::core::Controller::get<platform::PlatformController>();
+    const auto &stats = platform->frame_stats();
+    ImGui::Begin("Frame times");
+    if (stats.frame_count() == 0) {
+        ImGui::End();
+        return;
+    }
+    const auto summary = stats.summary();
+    ImGui::Text("p50 %.2f ms, p95 %.2f ms, p99 %.2f ms", summary.p50_ms, summary.p95_ms, summary.p99_ms);
+    ImGui::Text("Average %.2f ms, max %.2f ms, jitter %.2f ms", summary.average_ms, summary.max_ms,
+                summary.jitter_ms);
+
+    std::array<float, platform::FrameStats::HISTOGRAM_BUCKETS> histogram;
+    std::ranges::transform(stats.histogram(), histogram.begin(), [](uint64_t count) {
+        return static_cast<float>(count);
+    });
+    ImGui::PlotHistogram("##histogram", histogram.data(), static_cast<int>(histogram.size()), 0, "0.5 ms buckets",
+                         0.0f, FLT_MAX, ImVec2(0, 80));
+    if (ImGui::Button("Reset histogram")) {
+        platform->reset_frame_histogram();
+    }
+
+    ImGui::Text("%llu hitches in %llu frames", static_cast<unsigned long long>(stats.hitch_count()),
+                static_cast<unsigned long long>(stats.frame_count()));
+    for (const auto &hitch: stats.hitches()) {
+        ImGui::Text("Frame %llu at %.2f s: %.2f ms, median %.2f ms", static_cast<unsigned long long>(hitch.frame),
+                    static_cast<double>(hitch.time_ns) / 1e9, static_cast<double>(hitch.duration_ns) / 1e6,
+                    static_cast<double>(hitch.median_ns) / 1e6);
+    }
+    ImGui::End();
+}
 }
@@ -6,12 +6,14 @@
 #include <app/GUIController.hpp>
 
 namespace engine::test::app {
+using namespace engine::resources::literals;
+
 void MainPlatformEventObserver::on_key(engine::platform::Key key) {
-    spdlog::info("Keyboard event: key={}, state={}", key.name(), key.state_str());
+    RG_LOG_DEBUG("Keyboard event: key={}, state={}", key.name(), key.state_str());
 }
 
 void MainPlatformEventObserver::on_mouse_move(engine::platform::MousePosition position) {
-    spdlog::info("MousePosition: {} {}", position.x, position.y);
+    RG_LOG_TRACE("MousePosition: {} {}", position.x, position.y);
 }
 
 void MainController::initialize() {
@@ -21,6 +23,7 @@ void MainController::initialize() {
     auto observer = std::make_unique<MainPlatformEventObserver>();
     engine::core::Controller::get<engine::platform::PlatformController>()->register_platform_event_observer(
             std::move(observer));
+    m_late_latch = engine::core::Controller::get<engine::graphics::GraphicsController>()->is_late_latch_enabled();
 }
 
 bool MainController::loop() {
@@ -46,7 +49,9 @@ void MainController::update() {
 }
 
 void MainController::begin_draw() {
-    engine::graphics::OpenGL::clear_buffers();
+    engine::core::Controller::get<engine::graphics::GraphicsController>()->submit([] {
+        engine::graphics::OpenGL::clear_buffers();
+    });
 }
 
 void MainController::draw() {
@@ -60,29 +65,39 @@ void MainController::end_draw() {
 
 void MainController::draw_backpack() {
     auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
-    auto shader = engine::core::Controller::get<engine::resources::ResourcesController>()->shader("basic");
-    auto backpack = engine::core::Controller::get<engine::resources::ResourcesController>()->model("backpack");
-    shader->use();
-    shader->set_mat4("projection", graphics->projection_matrix());
-    shader->set_mat4("view", graphics->camera()
-                                     ->view_matrix());
-    shader->set_mat4("model", scale(glm::mat4(1.0f), glm::vec3(m_backpack_scale)));
-    backpack->draw(shader);
+    auto resources = engine::core::Controller::get<engine::resources::ResourcesController>();
+    // The ids are hashed at compile time, the lookups don't hash the names every frame.
+    auto shader = resources->shader("basic"_rid);
+    auto backpack = resources->model("backpack"_rid);
+    // The matrices are copied into the command list, the render thread may draw the frame later.
+    // The list records into the frame arena, which keeps it until the frame is drawn, so the draw doesn't allocate.
+    auto *list = engine::util::FrameArena::instance()->create<engine::graphics::CommandList>();
+    list->bind_program(shader);
+    const auto &camera = graphics->camera_snapshot();
+    list->set_uniform("projection", camera.projection);
+    list->set_uniform("view", camera.view);
+    list->set_uniform("model", scale(glm::mat4(1.0f), glm::vec3(m_backpack_scale)));
+    backpack->record_draw(*list, shader);
+    graphics->submit(std::span<const engine::graphics::CommandList>(list, 1));
 }
 
 void MainController::draw_skybox() {
-    auto shader = engine::core::Controller::get<engine::resources::ResourcesController>()->shader("skybox");
-    auto skybox_cube = engine::core::Controller::get<engine::resources::ResourcesController>()->skybox("skybox");
+    auto resources = engine::core::Controller::get<engine::resources::ResourcesController>();
+    auto shader = resources->shader("skybox"_rid);
+    auto skybox_cube = resources->skybox("skybox"_rid);
     engine::core::Controller::get<engine::graphics::GraphicsController>()->draw_skybox(shader, skybox_cube);
 }
 
 void MainController::update_camera() {
     auto gui = engine::core::Controller::get<GUIController>();
+    auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
+    // The mouse rotates the camera only while the GUI is hidden, and so does the late latch.
+    graphics->set_late_latch(m_late_latch && !gui->is_enabled());
     if (gui->is_enabled()) {
         return;
     }
     auto platform = engine::core::Controller::get<engine::platform::PlatformController>();
-    auto camera = engine::core::Controller::get<engine::graphics::GraphicsController>()->camera();
+    auto camera = graphics->camera();
     float dt = platform->dt();
     if (platform->key(engine::platform::KEY_W)
                 .state() == engine::platform::Key::State::Pressed) {
@@ -0,0 +1,52 @@
+#include <engine/resources/PackArchive.hpp>
+#include <engine/util/Errors.hpp>
+#include <spdlog/spdlog.h>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+* @brief Builds a resource pack from directories and files, see engine/resources/PackArchive.hpp.
+*
+* Usage: rg-pack [--no-compress] [--alignment <bytes>] <output.pack> <directory or file>...
+*
+* The paths in the pack are the input paths relative to the working directory, so run the tool from the
+* directory the app runs in, for example: rg-pack resources.pack resources
+*/
+int main(int argc, char **argv) {
+    using namespace engine;
+    bool compress = true;
+    uint32_t alignment = resources::PackWriter::DEFAULT_ALIGNMENT;
+    std::vector<std::string_view> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--no-compress") {
+            compress = false;
+        } else if (arg == "--alignment" && i + 1 < argc) {
+            alignment = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() < 2) {
+        spdlog::error("Usage: rg-pack [--no-compress] [--alignment <bytes>] <output.pack> <directory or file>...");
+        return 1;
+    }
+    try {
+        resources::PackWriter writer(compress, alignment);
+        for (auto input: std::span(positional).subspan(1)) {
+            if (std::filesystem::is_directory(input)) {
+                writer.add_directory(input);
+            } else {
+                writer.add_file(input);
+            }
+        }
+        writer.write(positional.front());
+    } catch (const util::Error &e) {
+        spdlog::error("{}", e.report());
+        return 1;
+    }
+    return 0;
+}